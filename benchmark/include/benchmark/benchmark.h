@@ -0,0 +1,63 @@
+/**
+ * @brief On-target benchmarks.
+ * 
+ *        The benchmarks are run on startup if the symbol BENCHMARK is defined. The results are 
+ *        printed in the serial terminal.
+ */
+#pragma once
+
+#include <stdint.h>
+
+namespace driver
+{
+/** ADC interface. */
+class AdcInterface;
+
+/** Serial transmission interface. */
+class SerialInterface;
+} // namespace driver
+
+namespace benchmark
+{
+/**
+ * @brief Measure the number of CPU cycles needed to format a status message with the
+ *        type-safe format engine compared to avr-libc snprintf.
+ * 
+ * @param[in] serial Serial device used to print the results.
+ */
+void runFormat(driver::SerialInterface& serial) noexcept;
+
+/**
+ * @brief Measure the sample rate and noise of each ADC profile with blocking reads, awake and
+ *        with noise reduction sleep, and the number of CPU cycles needed to convert a digital 
+ *        value to millivolts in floating point compared to fixed point.
+ * 
+ *        The ADC settings are restored afterwards.
+ * 
+ * @param[in] serial Serial device used to print the results.
+ * @param[in] adc The ADC to measure.
+ * @param[in] testPin The pin to read, preferably a stable signal such as the bandgap reference.
+ */
+void runAdc(driver::SerialInterface& serial, driver::AdcInterface& adc,
+            const uint8_t testPin) noexcept;
+
+/**
+ * @brief Measure the share of CPU time spent in timer interrupts while two timers run with
+ *        the debounce and log periods of the system.
+ * 
+ *        Timer 1 is reserved while measuring, hence no timer may exist when this is run.
+ * 
+ * @param[in] serial Serial device used to print the results.
+ */
+void runTimer(driver::SerialInterface& serial) noexcept;
+
+/**
+ * @brief Measure the number of CPU cycles an interrupt spends posting deferred work, in the 
+ *        best and worst case, and the overhead of dispatching it in the main loop.
+ * 
+ *        The work queue is empty and its statistics are reset afterwards.
+ * 
+ * @param[in] serial Serial device used to print the results.
+ */
+void runWorkQueue(driver::SerialInterface& serial) noexcept;
+} // namespace benchmark
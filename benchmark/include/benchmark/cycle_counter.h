@@ -0,0 +1,37 @@
+/**
+ * @brief Cycle counter for on-target benchmarks.
+ */
+#pragma once
+
+#include <stdint.h>
+
+namespace benchmark
+{
+/**
+ * @brief Cycle counter based on hardware timer Timer 1 running at the CPU frequency.
+ * 
+ *        Timer 1 is reconfigured while measuring, hence benchmarks must be run before any 
+ *        timer is created.
+ */
+class CycleCounter final
+{
+public:
+    /**
+     * @brief Reset and start the cycle counter.
+     */
+    static void start() noexcept;
+
+    /**
+     * @brief Stop the cycle counter.
+     * 
+     * @return The number of CPU cycles elapsed since the counter was started.
+     */
+    static uint32_t stop() noexcept;
+
+    CycleCounter()                               = delete; // No default constructor.
+    CycleCounter(const CycleCounter&)            = delete; // No copy constructor.
+    CycleCounter(CycleCounter&&)                 = delete; // No move constructor.
+    CycleCounter& operator=(const CycleCounter&) = delete; // No copy assignment.
+    CycleCounter& operator=(CycleCounter&&)      = delete; // No move assignment.
+};
+} // namespace benchmark
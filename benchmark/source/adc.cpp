@@ -0,0 +1,158 @@
+/**
+ * @brief Benchmark of the ADC speed/accuracy profiles, with and without noise reduction sleep,
+ *        and of the conversion to millivolts.
+ *
+ * @note Use a stable test signal, such as the internal bandgap reference, since any variation
+ *       of the input is counted as noise.
+ */
+#ifndef F_CPU
+#define F_CPU 16000000UL // Default CPU frequency measured in Hz.
+#endif
+
+#include <math.h>
+
+#include "benchmark/benchmark.h"
+#include "benchmark/cycle_counter.h"
+#include "driver/adc/interface.h"
+#include "driver/serial/interface.h"
+#include "utils/format.h"
+
+using namespace utils::format::literals;
+
+namespace benchmark
+{
+namespace
+{
+/**
+ * @brief Structure holding ADC benchmark parameters.
+ */
+struct AdcParam
+{
+    /** The number of samples per profile. */
+    static constexpr uint16_t SampleCount{256U};
+
+    /** The number of iterations per conversion measurement. */
+    static constexpr uint8_t IterationCount{16U};
+
+    /** CPU frequency in Hz. */
+    static constexpr uint32_t CpuFrequency_Hz{F_CPU};
+};
+
+/**
+ * @brief Structure holding the results of a profile.
+ */
+struct Result
+{
+    /** The number of samples per second. */
+    uint32_t samplesPerSecond;
+
+    /** The smallest sample. */
+    uint16_t min;
+
+    /** The largest sample. */
+    uint16_t max;
+
+    /** Mean of the samples. */
+    double mean;
+
+    /** Standard deviation of the samples in LSB (RMS noise). */
+    double noise;
+};
+
+// -----------------------------------------------------------------------------
+Result measure(driver::AdcInterface& adc, const uint8_t testPin) noexcept
+{
+    Result result{0U, UINT16_MAX, 0U, 0.0, 0.0};
+    uint32_t sum{};
+    uint32_t squareSum{};
+
+    // Convert once to let the input settle before measuring.
+    (void) adc.read(testPin);
+    CycleCounter::start();
+
+    for (uint16_t i{}; i < AdcParam::SampleCount; ++i)
+    {
+        const uint16_t sample{adc.read(testPin)};
+        sum       += sample;
+        squareSum += static_cast<uint32_t>(sample) * sample;
+        if (result.min > sample) { result.min = sample; }
+        if (result.max < sample) { result.max = sample; }
+    }
+
+    // The statistics are computed after the measurement to only count the conversions.
+    const uint32_t cycles{CycleCounter::stop()};
+    result.samplesPerSecond = static_cast<uint32_t>(
+        static_cast<uint64_t>(AdcParam::CpuFrequency_Hz) * AdcParam::SampleCount / cycles);
+    result.mean = static_cast<double>(sum) / AdcParam::SampleCount;
+    const double variance{static_cast<double>(squareSum) / AdcParam::SampleCount
+        - result.mean * result.mean};
+    result.noise = 0.0 < variance ? sqrt(variance) : 0.0;
+    return result;
+}
+
+// -----------------------------------------------------------------------------
+template <typename Function>
+uint32_t measureConversion(const Function& function) noexcept
+{
+    CycleCounter::start();
+    for (uint8_t i{}; i < AdcParam::IterationCount; ++i) { function(); }
+    return CycleCounter::stop() / AdcParam::IterationCount;
+}
+} // namespace
+
+// -----------------------------------------------------------------------------
+void runAdc(driver::SerialInterface& serial, driver::AdcInterface& adc,
+            const uint8_t testPin) noexcept
+{
+    using Profile = driver::AdcInterface::Profile;
+    static constexpr const char* names[]{"precise ", "balanced", "fast    "};
+    const bool enabled{adc.isEnabled()};
+    const bool noiseReduction{adc.isNoiseReductionEnabled()};
+    const Profile profile{adc.profile()};
+    const uint8_t oversampling{adc.oversampling()};
+
+    // Measure blocking reads without oversampling, the result of each profile in its resolution.
+    // Each profile is measured with the CPU awake and asleep during conversions.
+    adc.setEnabled(true);
+    adc.setOversampling(0U);
+    serial.printf_P("ADC benchmark (%u samples of pin %u per profile):\n"_fmt_P,
+                    AdcParam::SampleCount, testPin);
+
+    for (uint8_t i{}; i < static_cast<uint8_t>(Profile::Count); ++i)
+    {
+        if (!adc.setProfile(static_cast<Profile>(i))) { continue; }
+
+        for (uint8_t asleep{}; asleep < 2U; ++asleep)
+        {
+            adc.setNoiseReduction(0U != asleep);
+            const Result result{measure(adc, testPin)};
+            serial.printf_P("    %s %s  %u bits, %lu SPS, mean %.1f, min %u, max %u, noise %.2f LSB\n"_fmt_P,
+                            names[i], 0U != asleep ? "asleep" : "awake ", adc.resolution(), 
+                            result.samplesPerSecond, result.mean, result.min, result.max, 
+                            result.noise);
+        }
+    }
+    adc.setProfile(profile);
+    adc.setOversampling(oversampling);
+    adc.setNoiseReduction(noiseReduction);
+    adc.setEnabled(enabled);
+
+    // Use volatile variables to prevent the compiler from converting at compile time.
+    volatile uint16_t code{static_cast<uint16_t>(adc.maxValue() / 3U)};
+    volatile double voltage{};
+    volatile uint16_t mV{};
+
+    // The floating point conversion formerly used by the system, with a division per call.
+    const auto doubleCycles{measureConversion([&]() 
+    { 
+        voltage = code * adc.supplyVoltage() / adc.maxValue() * 1000.0; 
+    })};
+    const auto integerCycles{measureConversion([&]() { mV = adc.toMillivolts(testPin, code); })};
+
+    serial.printf_P("ADC code to millivolts (cycles per conversion):\n"_fmt_P);
+    serial.printf_P("    double:    %lu (%.1f mV)\n"_fmt_P, doubleCycles, 
+                    static_cast<double>(voltage));
+    serial.printf_P("    integer:   %lu (%u mV)\n"_fmt_P, integerCycles, 
+                    static_cast<uint16_t>(mV));
+}
+} // namespace benchmark
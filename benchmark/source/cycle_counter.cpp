@@ -0,0 +1,46 @@
+/**
+ * @brief Implementation details of the cycle counter for on-target benchmarks.
+ */
+#include <avr/interrupt.h>
+
+#include "benchmark/cycle_counter.h"
+#include "utils/utils.h"
+
+namespace benchmark
+{
+namespace
+{
+/** The number of Timer 1 overflows since the counter was started. */
+volatile uint16_t overflowCount{};
+} // namespace
+
+// -----------------------------------------------------------------------------
+void CycleCounter::start() noexcept
+{
+    // Run Timer 1 in normal mode without prescaler, count overflows in the interrupt.
+    TCCR1B        = 0U;
+    TCCR1A        = 0U;
+    TCNT1         = 0U;
+    overflowCount = 0U;
+    TIFR1         = (1U << TOV1);
+    utils::set(TIMSK1, TOIE1);
+    utils::globalInterruptEnable();
+    TCCR1B        = (1U << CS10);
+}
+
+// -----------------------------------------------------------------------------
+uint32_t CycleCounter::stop() noexcept
+{
+    TCCR1B = 0U;
+    utils::clear(TIMSK1, TOIE1);
+
+    // Include an overflow that occurred after the interrupt was disabled.
+    uint32_t overflows{overflowCount};
+    if (utils::read(TIFR1, TOV1)) { ++overflows; }
+    return (overflows << 16U) | TCNT1;
+}
+
+// -----------------------------------------------------------------------------
+ISR (TIMER1_OVF_vect) { overflowCount = overflowCount + 1U; }
+
+} // namespace benchmark
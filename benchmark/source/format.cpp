@@ -0,0 +1,95 @@
+/**
+ * @brief Benchmark of the type-safe format engine compared to avr-libc snprintf.
+ * 
+ * @note Flash usage is compared by building with and without BENCHMARK defined, since
+ *       the benchmark itself pulls in vfprintf.
+ */
+#include <stdio.h>
+
+#include "benchmark/benchmark.h"
+#include "benchmark/cycle_counter.h"
+#include "driver/serial/interface.h"
+#include "utils/format.h"
+
+using namespace utils::format::literals;
+
+namespace benchmark
+{
+namespace
+{
+/**
+ * @brief Structure holding format benchmark parameters.
+ */
+struct FormatParam
+{
+    /** The number of iterations per measurement. */
+    static constexpr uint8_t IterationCount{16U};
+
+    /** Size of the buffer used by snprintf (same as the former SerialInterface::printf). */
+    static constexpr size_t BufferSize{101U};
+};
+
+/**
+ * @brief Format output writing to a character buffer.
+ */
+class BufferOutput final : public utils::format::Output
+{
+public:
+    explicit BufferOutput(char* buffer) noexcept 
+        : myBuffer{buffer}
+        , myLength{0U} 
+    {}
+
+    void put(const char character) const noexcept override 
+    { 
+        if (FormatParam::BufferSize - 1U > myLength) { myBuffer[myLength++] = character; }
+    }
+
+private:
+    char* myBuffer;
+    mutable size_t myLength;
+};
+
+// -----------------------------------------------------------------------------
+template <typename Function>
+uint32_t measure(const Function& function) noexcept
+{
+    CycleCounter::start();
+    for (uint8_t i{}; i < FormatParam::IterationCount; ++i) { function(); }
+    return CycleCounter::stop() / FormatParam::IterationCount;
+}
+} // namespace
+
+// -----------------------------------------------------------------------------
+void runFormat(driver::SerialInterface& serial) noexcept
+{
+    char buffer[FormatParam::BufferSize]{};
+
+    // Use volatile inputs to prevent the compiler from formatting at compile time.
+    volatile int mV{1234};
+    volatile int temp{-27};
+    volatile double tempPrecise{-26.54};
+
+    const auto snprintfCycles{measure([&]() 
+    { 
+        (void) snprintf(buffer, sizeof(buffer), "Input: %d mV, predicted output: %d!\n", mV, temp);
+    })};
+
+    const auto formatCycles{measure([&]() 
+    { 
+        utils::format::print(BufferOutput{buffer}, "Input: %d mV, predicted output: %d!\n", 
+            static_cast<int>(mV), static_cast<int>(temp));
+    })};
+
+    const auto fixedCycles{measure([&]() 
+    { 
+        utils::format::print(BufferOutput{buffer}, "Input: %d mV, predicted output: %.1f!\n", 
+            static_cast<int>(mV), static_cast<double>(tempPrecise));
+    })};
+
+    serial.printf_P("Format benchmark (cycles per message):\n"_fmt_P);
+    serial.printf_P("    snprintf (%%d, %%d):   %lu\n"_fmt_P, snprintfCycles);
+    serial.printf_P("    format (%%d, %%d):     %lu\n"_fmt_P, formatCycles);
+    serial.printf_P("    format (%%d, %%.1f):   %lu\n"_fmt_P, fixedCycles);
+}
+} // namespace benchmark
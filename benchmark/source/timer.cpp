@@ -0,0 +1,73 @@
+/**
+ * @brief Benchmark of the CPU time spent in timer interrupts.
+ *
+ * @note The load is measured as the slowdown of a busy loop while timers are running, hence
+ *       it includes the interrupt entry and exit as well as the callbacks.
+ */
+#include "benchmark/benchmark.h"
+#include "benchmark/cycle_counter.h"
+#include "driver/atmega328p/timer.h"
+#include "driver/serial/interface.h"
+#include "utils/format.h"
+
+using namespace utils::format::literals;
+
+namespace benchmark
+{
+namespace
+{
+/**
+ * @brief Structure holding timer benchmark parameters.
+ */
+struct TimerParam
+{
+    /** The number of busy loop iterations per measurement, about a second at 16 MHz. */
+    static constexpr uint32_t IterationCount{500000UL};
+
+    /** Timeouts of the measured timers in ms, the debounce and log periods of the system. */
+    static constexpr uint32_t Timeouts_ms[]{300U, 1000U};
+};
+
+/** The number of timeouts during the measurement. */
+volatile uint16_t timeoutCount{};
+
+// -----------------------------------------------------------------------------
+void countTimeout() noexcept { timeoutCount = timeoutCount + 1U; }
+
+// -----------------------------------------------------------------------------
+uint32_t measureLoop() noexcept
+{
+    // Use a volatile counter to prevent the compiler from removing the loop.
+    volatile uint32_t counter{};
+    CycleCounter::start();
+    while (TimerParam::IterationCount > counter) { counter = counter + 1U; }
+    return CycleCounter::stop();
+}
+} // namespace
+
+// -----------------------------------------------------------------------------
+void runTimer(driver::SerialInterface& serial) noexcept
+{
+    using driver::atmega328p::Timer;
+
+    // Timer 1 is used by the cycle counter, hence the measured timers use Timer 0 and Timer 2.
+    if (!Timer::reserveCircuit(Timer::Circuit::Timer1)) { return; }
+    const uint32_t idleCycles{measureLoop()};
+    uint32_t busyCycles{};
+    {
+        Timer first{TimerParam::Timeouts_ms[0U], countTimeout, true};
+        Timer second{TimerParam::Timeouts_ms[1U], countTimeout, true};
+        timeoutCount = 0U;
+        busyCycles   = measureLoop();
+    }
+    Timer::releaseCircuit(Timer::Circuit::Timer1);
+
+    // The extra cycles of the busy loop were spent in timer interrupts.
+    const uint32_t isrCycles{busyCycles > idleCycles ? busyCycles - idleCycles : 0U};
+    serial.printf_P("Timer benchmark (%lu ms and %lu ms timers):\n"_fmt_P,
+                    TimerParam::Timeouts_ms[0U], TimerParam::Timeouts_ms[1U]);
+    serial.printf_P("    %lu of %lu cycles in timer interrupts (%.3f %% load), %u timeouts\n"_fmt_P,
+                    isrCycles, busyCycles, 100.0 * isrCycles / busyCycles,
+                    static_cast<uint16_t>(timeoutCount));
+}
+} // namespace benchmark
@@ -0,0 +1,89 @@
+/**
+ * @brief Benchmark of the deferred work queue.
+ *
+ * @note In an interrupt, the cycles spent posting add to the latency of all other interrupts. 
+ *       The benchmark runs before the timebase is started, hence no clock is set; reading the 
+ *       clock adds to each post in the running system.
+ */
+#include "benchmark/benchmark.h"
+#include "benchmark/cycle_counter.h"
+#include "driver/serial/interface.h"
+#include "utils/format.h"
+#include "utils/work_queue.h"
+
+using namespace utils::format::literals;
+
+namespace benchmark
+{
+namespace
+{
+/**
+ * @brief Structure holding work queue benchmark parameters.
+ */
+struct WorkQueueParam
+{
+    /** The number of distinct work items, enough to fill the queue. */
+    static constexpr uint8_t WorkCount{utils::WorkQueue::Capacity + 1U};
+};
+
+/** The number of work items run. */
+volatile uint8_t runCount{};
+
+// -----------------------------------------------------------------------------
+template <uint8_t Index>
+void work() noexcept { runCount = runCount + 1U; }
+
+/** Distinct work items, since pending work is coalesced. */
+void (* const works[WorkQueueParam::WorkCount])()
+{
+    work<0U>, work<1U>, work<2U>, work<3U>, work<4U>, work<5U>, work<6U>, work<7U>, work<8U>,
+};
+
+static_assert(sizeof(works) / sizeof(works[0U]) == WorkQueueParam::WorkCount, 
+              "A work item is needed per queue entry!");
+
+// -----------------------------------------------------------------------------
+uint32_t measurePost(const uint8_t index) noexcept
+{
+    CycleCounter::start();
+    (void) utils::WorkQueue::post(works[index]);
+    return CycleCounter::stop();
+}
+
+// -----------------------------------------------------------------------------
+void fill(const uint8_t count) noexcept
+{
+    for (uint8_t i{}; i < count; ++i) { (void) utils::WorkQueue::post(works[i]); }
+}
+} // namespace
+
+// -----------------------------------------------------------------------------
+void runWorkQueue(driver::SerialInterface& serial) noexcept
+{
+    constexpr uint8_t last{utils::WorkQueue::Capacity - 1U};
+    (void) utils::WorkQueue::dispatch();
+
+    // Posting scans the pending work for duplicates, the worst case is a nearly full queue.
+    const uint32_t emptyCycles{measurePost(0U)};
+    (void) utils::WorkQueue::dispatch();
+    fill(last);
+    const uint32_t fullCycles{measurePost(last)};
+    const uint32_t duplicateCycles{measurePost(last)};
+    const uint32_t droppedCycles{measurePost(utils::WorkQueue::Capacity)};
+
+    // Measure the dispatch overhead with trivial work.
+    runCount = 0U;
+    CycleCounter::start();
+    const uint8_t count{utils::WorkQueue::dispatch()};
+    const uint32_t dispatchCycles{CycleCounter::stop()};
+    utils::WorkQueue::resetStatistics();
+
+    serial.printf_P("Work queue (cycles per post):\n"_fmt_P);
+    serial.printf_P("    empty queue:   %lu\n"_fmt_P, emptyCycles);
+    serial.printf_P("    last entry:    %lu\n"_fmt_P, fullCycles);
+    serial.printf_P("    duplicate:     %lu\n"_fmt_P, duplicateCycles);
+    serial.printf_P("    full queue:    %lu\n"_fmt_P, droppedCycles);
+    serial.printf_P("Work queue (cycles per dispatch): %lu (%u items)\n"_fmt_P, 
+                    count ? dispatchCycles / count : 0U, count);
+}
+} // namespace benchmark
@@ -156,7 +156,7 @@ typename Array<T, Size>::Iterator Array<T, Size>::rend() noexcept
 
 // -----------------------------------------------------------------------------
 template <typename T, size_t Size>
-typename Array<T, Size>::ConstIterator Array<T, Size>::rend() const 
+typename Array<T, Size>::ConstIterator Array<T, Size>::rend() const noexcept
 { 
     return ConstIterator{myData - 1U};
 }
@@ -0,0 +1,92 @@
+/**
+ * @brief Implementation details of container::RingBuffer class.
+ *
+ * @note Don't include this header, use <ring_buffer.h> instead!
+ */
+#pragma once
+
+namespace container
+{
+namespace ring_buffer
+{
+/**
+ * @brief Prevent the compiler from moving memory accesses across this point.
+ *
+ *        Used to make sure an element is fully written (or read) before the index that
+ *        publishes it to the other side is updated.
+ */
+inline void memoryBarrier() noexcept { asm volatile("" ::: "memory"); }
+} // namespace ring_buffer
+
+// -----------------------------------------------------------------------------
+template <typename T, size_t Size>
+RingBuffer<T, Size>::RingBuffer() noexcept
+    : myData{}
+    , myHead{0U}
+    , myTail{0U} {}
+
+// -----------------------------------------------------------------------------
+template <typename T, size_t Size>
+constexpr size_t RingBuffer<T, Size>::capacity() const noexcept { return Size; }
+
+// -----------------------------------------------------------------------------
+template <typename T, size_t Size>
+size_t RingBuffer<T, Size>::size() const noexcept
+{
+    // The indexes are free-running, hence the difference is valid even after wrap-around.
+    return static_cast<uint8_t>(myHead - myTail);
+}
+
+// -----------------------------------------------------------------------------
+template <typename T, size_t Size>
+bool RingBuffer<T, Size>::isEmpty() const noexcept { return myHead == myTail; }
+
+// -----------------------------------------------------------------------------
+template <typename T, size_t Size>
+bool RingBuffer<T, Size>::isFull() const noexcept { return Size <= size(); }
+
+// -----------------------------------------------------------------------------
+template <typename T, size_t Size>
+bool RingBuffer<T, Size>::push(const T& value) noexcept
+{
+    if (isFull()) { return false; }
+    const uint8_t head{myHead};
+    myData[head & IndexMask] = value;
+
+    // Publish the new element only once it has been written.
+    ring_buffer::memoryBarrier();
+    myHead = static_cast<uint8_t>(head + 1U);
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+template <typename T, size_t Size>
+bool RingBuffer<T, Size>::pop(T& value) noexcept
+{
+    if (isEmpty()) { return false; }
+    const uint8_t tail{myTail};
+    value = myData[tail & IndexMask];
+
+    // Release the slot only once the element has been read.
+    ring_buffer::memoryBarrier();
+    myTail = static_cast<uint8_t>(tail + 1U);
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+template <typename T, size_t Size>
+bool RingBuffer<T, Size>::peek(T& value) const noexcept
+{
+    if (isEmpty()) { return false; }
+    value = myData[myTail & IndexMask];
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+template <typename T, size_t Size>
+void RingBuffer<T, Size>::clear() noexcept
+{
+    myHead = 0U;
+    myTail = 0U;
+}
+} // namespace container
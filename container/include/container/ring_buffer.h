@@ -0,0 +1,127 @@
+/**
+ * @brief Implementation of interrupt-safe ring buffers of any data type.
+ */
+#pragma once
+
+#include "utils/utils.h"
+
+namespace container
+{
+/**
+ * @brief Class for implementation of fixed-size ring buffers (FIFO queues).
+ *
+ *        The buffer is safe to share between one producer and one consumer running in
+ *        different contexts (e.g. the main loop and an interrupt service routine) without
+ *        disabling interrupts, since the read and write indexes are eight bits wide and hence
+ *        updated atomically. Any other combination of callers must provide its own locking.
+ *
+ *        This class is non-copyable and non-movable.
+ *
+ * @tparam T    The buffer type.
+ * @tparam Size The buffer size. Must be a power of two in the range [2, 128].
+ */
+template <typename T, size_t Size>
+class RingBuffer
+{
+    // Generate a compiler error if the buffer size isn't a power of two.
+    static_assert((Size >= 2U) && (0U == (Size & (Size - 1U))),
+        "Ring buffer size must be a power of two!");
+
+    // Generate a compiler error if the buffer size can't be tracked with eight-bit indexes.
+    static_assert(Size <= 128U, "Ring buffer size must not exceed 128!");
+
+public:
+    /**
+     * @brief Create empty ring buffer.
+     */
+    RingBuffer() noexcept;
+
+    /**
+     * @brief Delete ring buffer.
+     */
+    ~RingBuffer() noexcept = default;
+
+    /**
+     * @brief Get the capacity of the ring buffer.
+     *
+     * @return The number of elements the ring buffer can hold.
+     */
+    constexpr size_t capacity() const noexcept;
+
+    /**
+     * @brief Get the number of elements currently stored in the ring buffer.
+     *
+     * @return The number of stored elements.
+     */
+    size_t size() const noexcept;
+
+    /**
+     * @brief Check whether the ring buffer is empty.
+     *
+     * @return True if the ring buffer is empty, false otherwise.
+     */
+    bool isEmpty() const noexcept;
+
+    /**
+     * @brief Check whether the ring buffer is full.
+     *
+     * @return True if the ring buffer is full, false otherwise.
+     */
+    bool isFull() const noexcept;
+
+    /**
+     * @brief Push value to the back of the ring buffer (producer side).
+     *
+     * @param[in] value The value to push.
+     *
+     * @return True if the value was pushed, false if the ring buffer is full.
+     */
+    bool push(const T& value) noexcept;
+
+    /**
+     * @brief Pop value from the front of the ring buffer (consumer side).
+     *
+     * @param[out] value Reference to variable for storing the popped value.
+     *
+     * @return True if a value was popped, false if the ring buffer is empty.
+     */
+    bool pop(T& value) noexcept;
+
+    /**
+     * @brief Read the value at the front of the ring buffer without removing it (consumer side).
+     *
+     * @param[out] value Reference to variable for storing the value.
+     *
+     * @return True if a value was read, false if the ring buffer is empty.
+     */
+    bool peek(T& value) const noexcept;
+
+    /**
+     * @brief Clear ring buffer content.
+     *
+     * @note This operation touches both indexes; the caller must ensure that neither the
+     *       producer nor the consumer is running concurrently.
+     */
+    void clear() noexcept;
+
+    RingBuffer(const RingBuffer&)            = delete; // No copy constructor.
+    RingBuffer(RingBuffer&&)                 = delete; // No move constructor.
+    RingBuffer& operator=(const RingBuffer&) = delete; // No copy assignment.
+    RingBuffer& operator=(RingBuffer&&)      = delete; // No move assignment.
+
+private:
+    /** Mask used to map the free-running indexes to buffer positions. */
+    static constexpr uint8_t IndexMask{static_cast<uint8_t>(Size - 1U)};
+
+    /** Static field holding data. */
+    T myData[Size];
+
+    /** Free-running write index, only modified by the producer. */
+    volatile uint8_t myHead;
+
+    /** Free-running read index, only modified by the consumer. */
+    volatile uint8_t myTail;
+};
+} // namespace container
+
+#include "impl/ring_buffer_impl.h"
@@ -16,6 +16,25 @@ namespace atmega328p
  * 
  *        Use the singleton design pattern to ensure only one ADC instance exists,
  *        reflecting the hardware limitation of a single ADC on the MCU.
+ * 
+ *        Asynchronous conversions are completed in the conversion complete interrupt, which 
+ *        buffers the result in a ring buffer drained by readSample. Blocking reads wait for 
+ *        any asynchronous conversion in progress to complete first.
+ * 
+ *        Periodic conversions are auto-triggered by the compare match B of Timer 1, which is 
+ *        reserved while sampling or scanning, see Timer::reserveCircuit. Sampling and scanning 
+ *        therefore fail if all timer circuits are used by timers.
+ * 
+ *        The scan sequencer converts one channel per millisecond. The first conversion after 
+ *        each mux switch is discarded, since the input needs time to settle. Hence a channel 
+ *        is scanned at most at 500 Hz, and the total scan rate of all channels should stay 
+ *        below that; channels that become due while waiting are converted once.
+ * 
+ *        The internal temperature sensor is measured against the internal 1.1 V reference, 
+ *        the other channels against AVcc.
+ * 
+ *        Oversampling accumulates up to 64 conversions per sample (13 bits) in the conversion
+ *        complete interrupt. It only gains resolution if the input carries about 1 LSB of noise.
  */
 class Adc final : public AdcInterface
 {
@@ -33,33 +52,85 @@ public:
     /**
      * @brief Get the resolution of the ADC.
      * 
-     * @return The resolution of the ADC in bits.
+     * @return The effective resolution of the ADC in bits, including extra bits gained by 
+     *         oversampling.
      */
     uint8_t resolution() const noexcept override;
 
     /**
      * @brief Get the maximal input value of the ADC.
      * 
-     * @return The maximum digital value of the ADC.
+     * @return The maximum digital value of the ADC at the effective resolution.
      */
     uint16_t maxValue() const noexcept override;
 
     /**
      * @brief Get the supply voltage of the ADC.
      * 
-     * @return The supply voltage of the ADC in Volts.
+     * @return The calibrated supply voltage of the ADC in Volts.
      */
     double supplyVoltage() const noexcept override;
 
+    /**
+     * @brief Get the supply voltage of the ADC.
+     * 
+     * @return The calibrated supply voltage of the ADC in millivolts (nominally 5000 mV).
+     */
+    uint16_t supplyMillivolts() const noexcept override;
+
+    /**
+     * @brief Set the supply voltage (AVcc) of the ADC.
+     * 
+     * @param[in] supplyVoltage The supply voltage in millivolts (1800 - 5500 mV).
+     * 
+     * @return True if the supply voltage was set, false if it's out of range.
+     */
+    bool setSupplyMillivolts(const uint16_t supplyVoltage) noexcept override;
+
+    /**
+     * @brief Calibrate the supply voltage (AVcc) by measuring the 1.1 V bandgap reference 
+     *        against it.
+     * 
+     *        If the bandgap reference is scanned, see Pin::Bandgap, the latest sample is used 
+     *        without blocking. Otherwise a few blocking conversions are averaged, which isn't 
+     *        possible while sampling or scanning.
+     * 
+     * @return True if the supply voltage was calibrated, false otherwise.
+     */
+    bool calibrate() noexcept override;
+
     /**
      * @brief Read input from given analog pin.
      * 
+     *        The latest sample is returned without blocking if the pin is scanned, see startScan.
+     *        Otherwise the first conversion after a mux switch is discarded.
+     * 
      * @param[in] analogPin The analog pin from which to read.
      * 
      * @return The digital value corresponding to the input of the specified analog pin.
      */
     uint16_t read(const uint8_t analogPin) const noexcept override;
 
+    /**
+     * @brief Read input from the given analog pins.
+     * 
+     *        The ADC is claimed once and the pins are converted back to back in the given 
+     *        order. The first conversion after a switch is only discarded if the reference
+     *        changes or an internal channel is selected, hence pins sharing a reference should
+     *        be adjacent. Scanned pins are read from the cache without blocking.
+     * 
+     * @param[in] analogPins The analog pins from which to read.
+     * @param[out] values Buffer to store the digital value of each pin.
+     * @param[in] count The number of pins to read.
+     * 
+     * @return True if all pins were read, false if a pin is invalid, the ADC is disabled or a 
+     *         pin couldn't be converted while sampling or scanning.
+     */
+    bool read(const uint8_t* analogPins, uint16_t* values, const size_t count) const noexcept override;
+
+    // Make the container overloads of read visible.
+    using AdcInterface::read;
+
     /**
      * @brief Calculate duty cycle out of input from given analog pin.
      * 
@@ -78,6 +149,248 @@ public:
      */
     double inputVoltage(const uint8_t analogPin) const noexcept override;
 
+    /**
+     * @brief Calculate fixed-point duty cycle out of input from given analog pin.
+     * 
+     * @param[in] analogPin The analog pin from which to read.
+     * 
+     * @return The duty cycle in Q1.15 format, i.e. between 0 - DutyCycleScale.
+     */
+    uint16_t dutyCycleQ15(const uint8_t analogPin) const noexcept override;
+
+    /**
+     * @brief Read input voltage from given analog pin.
+     * 
+     * @param[in] analogPin The analog pin from which to read.
+     * 
+     * @return The input voltage in millivolts.
+     */
+    uint16_t inputMillivolts(const uint8_t analogPin) const noexcept override;
+
+    /**
+     * @brief Convert a digital value of the given analog pin to millivolts.
+     * 
+     *        The value is scaled via multiply and shift with a precomputed factor of the 
+     *        current resolution, hence no division is needed.
+     * 
+     * @param[in] analogPin The analog pin the value was read from.
+     * @param[in] code The digital value at the current resolution.
+     * 
+     * @return The corresponding input voltage in millivolts.
+     */
+    uint16_t toMillivolts(const uint8_t analogPin, const uint16_t code) const noexcept override;
+
+    /**
+     * @brief Start an asynchronous conversion of the input of the given analog pin.
+     * 
+     *        The function returns immediately; the result is buffered as a sample when the
+     *        conversion is complete, see readSample.
+     * 
+     * @param[in] analogPin The analog pin from which to read.
+     * 
+     * @return True if the conversion was started, false if the pin is invalid, the ADC is 
+     *         disabled or another conversion is in progress.
+     */
+    bool startConversion(const uint8_t analogPin) noexcept override;
+
+    /**
+     * @brief Check whether a conversion is in progress.
+     * 
+     * @return True if a conversion is in progress, false otherwise.
+     */
+    bool isBusy() const noexcept override;
+
+    /**
+     * @brief Read the oldest buffered sample, if any.
+     * 
+     *        Samples are buffered in the background, hence this function never blocks.
+     * 
+     * @param[out] sample Reference to variable to store the sample.
+     * 
+     * @return True if a sample was read, false if no sample is available.
+     */
+    bool readSample(Sample& sample) noexcept override;
+
+    /**
+     * @brief Get the number of samples lost due to a full sample buffer.
+     * 
+     * @return The number of lost samples since startup.
+     */
+    uint32_t lostSampleCount() const noexcept override;
+
+    /**
+     * @brief Set the clock used to timestamp samples.
+     * 
+     * @param[in] clock The clock, or nullptr to timestamp all samples with 0.
+     */
+    void setClock(const Clock clock) noexcept override;
+
+    /**
+     * @brief Start periodic conversions of the input of the given analog pin.
+     * 
+     *        The conversions are triggered by hardware at the given sample rate; the samples 
+     *        are buffered, see readSample. Any periodic conversions in progress are stopped first.
+     *        Blocking reads and asynchronous conversions aren't possible while sampling.
+     * 
+     * @param[in] analogPin The analog pin from which to read.
+     * @param[in] sampleRate_hz The sample rate in Hz, limited by the conversion time to about 
+     *                          8.9 kHz in the precise profile and 65 kHz in the fast profile 
+     *                          at 16 MHz.
+     * 
+     * @return True if sampling was started, false if the pin or sample rate is invalid, the ADC 
+     *         is disabled, a conversion is in progress or Timer 1 is in use.
+     */
+    bool startSampling(const uint8_t analogPin, const uint16_t sampleRate_hz) noexcept override;
+
+    /**
+     * @brief Stop periodic conversions started via startSampling.
+     */
+    void stopSampling() noexcept override;
+
+    /**
+     * @brief Get the sample rate of periodic conversions.
+     * 
+     * @return The sample rate in Hz, or 0 if no periodic conversions are in progress.
+     */
+    uint16_t sampleRate_hz() const noexcept override;
+
+    /**
+     * @brief Set the scan rate of the given analog pin.
+     * 
+     *        The scan rate can be changed while scanning.
+     * 
+     * @param[in] analogPin The analog pin to scan.
+     * @param[in] scanRate_hz The scan rate in Hz (max 500 Hz), or 0 to remove the pin from 
+     *                        the scan.
+     * 
+     * @return True if the scan rate was set, false if the pin or scan rate is invalid.
+     */
+    bool setScanRate(const uint8_t analogPin, const uint16_t scanRate_hz) noexcept override;
+
+    /**
+     * @brief Start scanning the analog pins with a non-zero scan rate in the background.
+     * 
+     *        Blocking reads of pins that aren't scanned, asynchronous and periodic conversions 
+     *        aren't possible while scanning.
+     * 
+     * @return True if scanning was started, false if the ADC is disabled, a conversion is in 
+     *         progress or Timer 1 is in use.
+     */
+    bool startScan() noexcept override;
+
+    /**
+     * @brief Stop scanning started via startScan; the cached samples are discarded.
+     */
+    void stopScan() noexcept override;
+
+    /**
+     * @brief Check whether scanning is in progress.
+     * 
+     * @return True if scanning is in progress, false otherwise.
+     */
+    bool isScanning() const noexcept override;
+
+    /**
+     * @brief Read the latest sample of the given scanned analog pin.
+     * 
+     * @param[in] analogPin The analog pin from which to read.
+     * @param[out] sample Reference to variable to store the sample.
+     * 
+     * @return True if a sample was read, false if the pin isn't scanned or hasn't been 
+     *         converted yet.
+     */
+    bool readLatest(const uint8_t analogPin, Sample& sample) const noexcept override;
+
+    /**
+     * @brief Set the analog watchdog of the given analog pin.
+     * 
+     *        The window is compared against samples at the effective resolution, see 
+     *        resolution(); the watchdog must be set again after changing the resolution.
+     * 
+     * @param[in] analogPin The analog pin to watch.
+     * @param[in] low The lowest digital value inside the window.
+     * @param[in] high The highest digital value inside the window.
+     * @param[in] hysteresis Hysteresis in digital values, at most half the window size.
+     * 
+     * @return True if the watchdog was set, false if the pin or the window is invalid.
+     */
+    bool setWatchdog(const uint8_t analogPin, const uint16_t low, const uint16_t high,
+                     const uint16_t hysteresis) noexcept override;
+
+    /**
+     * @brief Remove the analog watchdog of the given analog pin.
+     * 
+     * @param[in] analogPin The analog pin to stop watching.
+     */
+    void clearWatchdog(const uint8_t analogPin) noexcept override;
+
+    /**
+     * @brief Set the callback invoked upon analog watchdog crossings.
+     * 
+     * @param[in] callback The callback, or nullptr to disable the callback.
+     */
+    void setWatchdogCallback(const WatchdogCallback callback) noexcept override;
+
+    /**
+     * @brief Set the number of extra bits of resolution gained by oversampling.
+     * 
+     *        4^n conversions are accumulated and decimated to one sample with n extra bits, 
+     *        which reduces the conversion rate by 4^n. The accumulation is done in the 
+     *        background for asynchronous, periodic and scanned conversions.
+     * 
+     * @param[in] extraBitCount The number of extra bits (0 - 3), 0 to disable oversampling.
+     * 
+     * @return True if oversampling was set, false if the number of extra bits isn't supported
+     *         or conversions are in progress.
+     */
+    bool setOversampling(const uint8_t extraBitCount) noexcept override;
+
+    /**
+     * @brief Get the number of extra bits of resolution gained by oversampling.
+     * 
+     * @return The number of extra bits (0 - 3), 0 if oversampling is disabled.
+     */
+    uint8_t oversampling() const noexcept override;
+
+    /**
+     * @brief Set the speed/accuracy profile.
+     * 
+     *        The precise profile converts at a 125 kHz ADC clock (/128), the balanced profile 
+     *        at 500 kHz (/32) and the fast profile at 1 MHz (/16) with 8-bit results.
+     * 
+     * @param[in] profile The new profile.
+     * 
+     * @return True if the profile was set, false if the profile is invalid or conversions 
+     *         are in progress.
+     */
+    bool setProfile(const Profile profile) noexcept override;
+
+    /**
+     * @brief Get the speed/accuracy profile.
+     * 
+     * @return The current profile.
+     */
+    Profile profile() const noexcept override;
+
+    /**
+     * @brief Set whether blocking conversions are made with the CPU asleep.
+     * 
+     *        ADC noise reduction sleep mode is used if no timer or the USART depends on the I/O
+     *        clock, else idle sleep mode, which keeps the timers and the USART running. The
+     *        conversion complete interrupt wakes up the CPU. Conversions are made awake if 
+     *        interrupts are disabled.
+     * 
+     * @param[in] enable Indicate whether to convert asleep.
+     */
+    void setNoiseReduction(const bool enable) noexcept override;
+
+    /**
+     * @brief Check whether blocking conversions are made with the CPU asleep.
+     * 
+     * @return True if blocking conversions are made asleep, false otherwise.
+     */
+    bool isNoiseReductionEnabled() const noexcept override;
+
     /**
      * @brief Check whether the ADC is initialized.
      * 
@@ -110,6 +423,9 @@ private:
 
     /** Indicate whether the ADC is enabled. */
     bool myEnabled;
+
+    /** The sample rate of periodic conversions in Hz (0 if not sampling). */
+    uint16_t mySampleRate_hz;
 };
 
 /**
@@ -123,6 +439,9 @@ struct Adc::Pin
     static constexpr uint8_t A3{3U}; // Pin A3 = 3.
     static constexpr uint8_t A4{4U}; // Pin A4 = 4.
     static constexpr uint8_t A5{5U}; // Pin A5 = 5.
+
+    static constexpr uint8_t Temperature{6U}; // Internal temperature sensor.
+    static constexpr uint8_t Bandgap{7U};     // Internal 1.1 V bandgap reference.
 };
 
 /**
@@ -6,6 +6,7 @@
 #include <stdint.h>
 
 #include "driver/gpio/interface.h"
+#include "utils/work_queue.h"
 
 namespace driver 
 {
@@ -34,9 +35,12 @@ public:
      * @param[in] pin The pin number of the GPIO.
      * @param[in] direction The GPIO direction.
      * @param[in] callback Callback associated with the GPIO (default = none).
+     * @param[in] callbackMode Invoke the callback in the pin change interrupt or defer it to 
+     *                         the work queue (default = immediate).
      */
     explicit Gpio(const uint8_t pin, const Direction direction, 
-        void (*callback)() = nullptr) noexcept;
+        void (*callback)() = nullptr, 
+        const utils::CallbackMode callbackMode = utils::CallbackMode::Immediate) noexcept;
 
     /**
      * @brief Delete the GPIO.
@@ -132,7 +136,7 @@ private:
     static Hardware* initHardware(const uint8_t pin) noexcept;
 
     void setDirection(const Direction direction) noexcept;
-    void setCallback(void (*callback)()) const noexcept;
+    void setCallback(void (*callback)(), const utils::CallbackMode callbackMode) const noexcept;
 
     /** Hardware structure for I/O port B. */
     static Hardware myHwPortB;
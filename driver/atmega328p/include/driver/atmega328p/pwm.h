@@ -0,0 +1,201 @@
+/**
+ * @brief PWM (Pulse Width Modulation) driver for ATmega328P.
+ */
+#pragma once
+
+#include <stdint.h>
+
+#include "driver/atmega328p/gpio.h"
+#include "driver/pwm/interface.h"
+
+namespace driver
+{
+namespace atmega328p
+{
+/**
+ * @brief PWM driver for ATmega328P, generating the waveform on the output compare pins.
+ *
+ *        The two channels of a timer circuit share its mode and frequency, hence setting the
+ *        frequency of a channel affects the other channel of the circuit as well. The circuit
+ *        is reserved along with the first channel, see Timer::reserveCircuit, and released
+ *        along with the last one; channels can't be created while the circuit is used by
+ *        another driver, such as Timebase (Timer 0) or VirtualTimer (Timer 2).
+ *
+ *        Timer 0 and Timer 2 count to 255, hence the frequency is selected by the prescaler
+ *        only. Timer 1 counts to ICR1, hence the frequency can be selected freely at the cost
+ *        of resolution.
+ *
+ *        Duty cycles are written to the output compare registers, which the hardware double
+ *        buffers in PWM mode, hence a new duty cycle takes effect at the end of the current
+ *        period without glitches. A frequency change restarts the period.
+ *
+ *        This class is non-copyable and non-movable.
+ */
+class Pwm final : public PwmInterface
+{
+public:
+    /** Enumeration of PWM channels. */
+    enum class Channel : uint8_t;
+
+    /** Enumeration of PWM modes. */
+    enum class Mode : uint8_t;
+
+    /**
+     * @brief Create a new PWM channel.
+     *
+     *        The output is enabled with a duty cycle of 0 %.
+     *
+     * @param[in] channel The output compare channel.
+     * @param[in] frequency_hz The PWM frequency in Hz.
+     * @param[in] mode The PWM mode, which must match the other channel of the circuit if it's
+     *                 in use.
+     */
+    explicit Pwm(const Channel channel, const uint32_t frequency_hz, const Mode mode) noexcept;
+
+    /**
+     * @brief Delete the PWM channel.
+     */
+    ~Pwm() noexcept override;
+
+    /**
+     * @brief Get the output compare channel.
+     *
+     * @return The output compare channel.
+     */
+    Channel channel() const noexcept;
+
+    /**
+     * @brief Get the PWM mode of the circuit.
+     *
+     * @return The PWM mode.
+     */
+    Mode mode() const noexcept;
+
+    /**
+     * @brief Check whether the PWM channel is initialized.
+     *
+     *        An uninitialized channel indicates that the output pin or the timer circuit was
+     *        unavailable, or that the frequency or the mode was invalid, when the channel was
+     *        created.
+     *
+     * @return True if the channel is initialized, false otherwise.
+     */
+    bool isInitialized() const noexcept override;
+
+    /**
+     * @brief Check whether the PWM output is enabled.
+     *
+     * @return True if the output is enabled, false otherwise.
+     */
+    bool isEnabled() const noexcept override;
+
+    /**
+     * @brief Enable or disable the PWM output.
+     *
+     *        The output pin is driven low while the output is disabled.
+     *
+     * @param[in] enable True to enable the output, false to disable it.
+     */
+    void setEnabled(const bool enable) noexcept override;
+
+    /**
+     * @brief Get the PWM frequency of the circuit.
+     *
+     * @return The frequency in Hz, rounded to the nearest integer.
+     */
+    uint32_t frequency_hz() const noexcept override;
+
+    /**
+     * @brief Set the PWM frequency of the circuit, which applies to both of its channels.
+     *
+     *        Timer 0 and Timer 2 select the closest frequency reachable by a prescaler,
+     *        Timer 1 the smallest prescaler reaching the frequency for the best resolution.
+     *
+     * @param[in] frequency_hz The frequency in Hz.
+     *
+     * @return True if the frequency was set, false if it's out of range.
+     */
+    bool setFrequency_hz(const uint32_t frequency_hz) noexcept override;
+
+    /**
+     * @brief Get the number of distinct duty cycles at the current frequency.
+     *
+     * @return The number of duty cycle steps from 0 % to 100 %.
+     */
+    uint16_t resolution() const noexcept override;
+
+    /**
+     * @brief Get the duty cycle.
+     *
+     * @return The duty cycle in 16-bit resolution, where 0 is 0 % and 65535 is 100 %.
+     */
+    uint16_t dutyCycle16() const noexcept override;
+
+    /**
+     * @brief Set the duty cycle in 8-bit resolution.
+     *
+     * @param[in] dutyCycle The duty cycle, where 0 is 0 % and 255 is 100 %.
+     */
+    void setDutyCycle8(const uint8_t dutyCycle) noexcept override;
+
+    /**
+     * @brief Set the duty cycle in 16-bit resolution.
+     *
+     *        The duty cycle is scaled to the resolution of the current frequency.
+     *
+     * @param[in] dutyCycle The duty cycle, where 0 is 0 % and 65535 is 100 %.
+     */
+    void setDutyCycle16(const uint16_t dutyCycle) noexcept override;
+
+    Pwm()                      = delete; // No default constructor.
+    Pwm(const Pwm&)            = delete; // No copy constructor.
+    Pwm(Pwm&&)                 = delete; // No move constructor.
+    Pwm& operator=(const Pwm&) = delete; // No copy assignment.
+    Pwm& operator=(Pwm&&)      = delete; // No move assignment.
+
+private:
+    bool reserve(const uint32_t frequency_hz, const Mode mode) noexcept;
+    void release() noexcept;
+    void writeOutput() noexcept;
+
+    /** The output compare channel. */
+    const Channel myChannel;
+
+    /** The output pin of the channel, reserved for the PWM output. */
+    Gpio myPin;
+
+    /** The duty cycle in 16-bit resolution. */
+    uint16_t myDutyCycle;
+
+    /** Indicate whether the channel owns its circuit along with the other channel, if any. */
+    bool myInitialized;
+
+    /** Indicate whether the output is enabled. */
+    bool myEnabled;
+};
+
+/**
+ * @brief Enumeration of PWM channels, each associated with an output compare pin.
+ */
+enum class Pwm::Channel : uint8_t
+{
+    Timer0A, // OC0A on pin 6 (PORTD6).
+    Timer0B, // OC0B on pin 5 (PORTD5).
+    Timer1A, // OC1A on pin 9 (PORTB1).
+    Timer1B, // OC1B on pin 10 (PORTB2).
+    Timer2A, // OC2A on pin 11 (PORTB3).
+    Timer2B, // OC2B on pin 3 (PORTD3).
+    Count,   // The number of PWM channels available.
+};
+
+/**
+ * @brief Enumeration of PWM modes.
+ */
+enum class Pwm::Mode : uint8_t
+{
+    Fast,         // Single-slope PWM, counting up to top, for the highest frequencies.
+    PhaseCorrect, // Dual-slope PWM, counting up and down, with pulses centered in the period.
+    Count,        // The number of PWM modes available.
+};
+} // namespace atmega328p
+} // namespace driver
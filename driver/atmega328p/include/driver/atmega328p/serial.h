@@ -16,6 +16,18 @@ namespace atmega328p
  * 
  *        Use the singleton design pattern to ensure only one serial device instance exists,
  *        reflecting the hardware limitation of a single serial port on the MCU.
+ * 
+ *        Printed characters are put in a transmit buffer, which is drained in the background 
+ *        by the USART data register empty interrupt. Printing therefore only blocks if the
+ *        buffer is full and the overflow policy is set to OverflowPolicy::Block (default).
+ * 
+ *        Received characters are put in a receive buffer by the USART receive complete 
+ *        interrupt and read via read(). Reception is always enabled, i.e. also when 
+ *        transmission is disabled.
+ * 
+ *        The baud rate is selected at compile time by defining SERIAL_BAUD_RATE_BPS (default 
+ *        9600 bps, max 1 Mbps). Double speed mode is used if it gives a lower baud rate error;
+ *        rates that can't be generated with an error of at most 2 % result in a compiler error.
  */
 class Serial final : public SerialInterface
 {
@@ -30,7 +42,8 @@ public:
     /** 
      * @brief Get the baud rate of the serial device. 
      * 
-     * @return The baud rate in bps (bits per second).
+     * @return The actual baud rate in bps (bits per second), which may differ slightly from
+     *         the requested baud rate due to the resolution of the baud rate generator.
      */
     uint32_t baudRate_bps() const override;
 
@@ -55,6 +68,60 @@ public:
      */
     void setEnabled(const bool enable) noexcept override;
 
+    /**
+     * @brief Get the policy used when the transmit buffer is full.
+     * 
+     * @return The overflow policy as an enumerator of enum OverflowPolicy.
+     */
+    OverflowPolicy overflowPolicy() const noexcept override;
+
+    /**
+     * @brief Set the policy to use when the transmit buffer is full.
+     * 
+     * @param[in] policy The new overflow policy.
+     */
+    void setOverflowPolicy(const OverflowPolicy policy) noexcept override;
+
+    /**
+     * @brief Get the number of bytes dropped due to a full transmit buffer.
+     * 
+     * @return The number of dropped bytes since startup or the last counter reset.
+     */
+    uint32_t droppedByteCount() const noexcept override;
+
+    /**
+     * @brief Reset the counter of dropped bytes.
+     */
+    void resetDroppedByteCount() noexcept override;
+
+    /**
+     * @brief Read the next received character, if any.
+     * 
+     *        Received characters are buffered in the background, hence this function never blocks.
+     * 
+     * @param[out] character Reference to variable to store the received character.
+     * 
+     * @return True if a character was read, false if no character has been received.
+     */
+    bool read(char& character) noexcept override;
+
+    /**
+     * @brief Get the number of received bytes lost due to a full receive buffer or data overrun.
+     * 
+     * @return The number of lost bytes since startup.
+     */
+    uint32_t lostByteCount() const noexcept override;
+
+    /**
+     * @brief Write raw data, such as binary frames, without any character translation.
+     * 
+     * @param[in] data Pointer to the data to write.
+     * @param[in] size The size of the data in bytes.
+     * 
+     * @return True if the data was written, false if serial transmission is disabled.
+     */
+    bool write(const uint8_t* data, const size_t size) const noexcept override;
+
     Serial(const Serial&)                      = delete; // No copy constructor.
     Serial(Serial&& other) noexcept            = delete; // No move constructor.
     Serial& operator=(const Serial&)           = delete; // No copy assignment.
@@ -72,11 +139,21 @@ private:
     ~Serial() noexcept override = default;
 
     /**
-     * @brief Print the given string in the serial terminal.
+     * @brief Print the given character in the serial terminal.
      * 
-     * @param[in] str The string to print.
+     * @param[in] character The character to print.
      */
-    void print(const char* str) const noexcept override;
+    void put(const char character) const noexcept override;
+
+    /**
+     * @brief Put the given character in the transmit buffer.
+     * 
+     * @param[in] character The character to transmit.
+     */
+    void transmit(const char character) const noexcept;
+
+    /** Policy used when the transmit buffer is full. */
+    OverflowPolicy myOverflowPolicy;
 
     /** Indicate whether serial transmission is enabled. */
     bool myEnabled;
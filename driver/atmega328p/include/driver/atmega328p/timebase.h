@@ -0,0 +1,115 @@
+/**
+ * @brief Monotonic system timebase for ATmega328P.
+ */
+#pragma once
+
+#include <stdint.h>
+
+namespace driver
+{
+namespace atmega328p
+{
+/**
+ * @brief Monotonic system timebase based on hardware timer Timer 0.
+ *
+ *        Timer 0 counts freely with prescaler 64, i.e. 4 us per count at 16 MHz, and overflows
+ *        every 1.024 ms. The time in microseconds is composed of the number of overflows and
+ *        the counter value, the time in milliseconds is accumulated in the overflow interrupt.
+ *
+ *        The time can be read in both interrupt and main context. Both counters wrap around,
+ *        micros after about 71.6 minutes and millis after about 49.7 days, hence time spans
+ *        must be computed by the wrap-safe helpers elapsed and hasExpired.
+ *
+ *        Timer 0 is reserved while the timebase runs, see Timer::reserveCircuit.
+ */
+class Timebase final
+{
+public:
+    /**
+     * @brief Start the timebase from zero.
+     *
+     * @return True if the timebase is running, false if Timer 0 is in use.
+     */
+    static bool start() noexcept;
+
+    /**
+     * @brief Check whether the timebase is running.
+     *
+     * @return True if the timebase is running, false otherwise.
+     */
+    static bool isRunning() noexcept;
+
+    /**
+     * @brief Get the time since the timebase was started.
+     *
+     * @return The time in milliseconds, 0 if the timebase isn't running.
+     */
+    static uint32_t millis() noexcept;
+
+    /**
+     * @brief Get the time since the timebase was started.
+     *
+     * @return The time in microseconds with a resolution of one timer count, 0 if the
+     *         timebase isn't running.
+     */
+    static uint32_t micros() noexcept;
+
+    /**
+     * @brief Get the time elapsed between two timestamps of the same clock.
+     *
+     *        The result is correct across a wrap around, as long as the time span is less
+     *        than the wrap around period of the clock.
+     *
+     * @param[in] start The earlier timestamp.
+     * @param[in] now The later timestamp.
+     *
+     * @return The time elapsed from start to now.
+     */
+    static constexpr uint32_t elapsed(const uint32_t start, const uint32_t now) noexcept;
+
+    /**
+     * @brief Check whether a deadline has expired.
+     *
+     *        The result is correct across a wrap around, as long as the deadline is less than
+     *        half the wrap around period of the clock away from now.
+     *
+     * @param[in] deadline The deadline, such as millis() + timeout.
+     * @param[in] now The current time of the same clock.
+     *
+     * @return True if the deadline has expired, false otherwise.
+     */
+    static constexpr bool hasExpired(const uint32_t deadline, const uint32_t now) noexcept;
+
+    /**
+     * @brief Block the calling thread for the given time.
+     *
+     *        Unlike utils::delay_ms, the delay isn't stretched by time spent in interrupts.
+     *        Interrupts must be enabled while the timebase runs, since the time is counted 
+     *        in the overflow interrupt.
+     *
+     * @param[in] delayTime_ms The time to block the thread in milliseconds.
+     */
+    static void delay_ms(const uint32_t delayTime_ms) noexcept;
+
+    Timebase()                           = delete; // No default constructor.
+    Timebase(const Timebase&)            = delete; // No copy constructor.
+    Timebase(Timebase&&)                 = delete; // No move constructor.
+    Timebase& operator=(const Timebase&) = delete; // No copy assignment.
+    Timebase& operator=(Timebase&&)      = delete; // No move assignment.
+};
+
+// -----------------------------------------------------------------------------
+constexpr uint32_t Timebase::elapsed(const uint32_t start, const uint32_t now) noexcept
+{
+    // Unsigned subtraction is modulo 2^32, hence a wrap around between start and now cancels out.
+    return now - start;
+}
+
+// -----------------------------------------------------------------------------
+constexpr bool Timebase::hasExpired(const uint32_t deadline, const uint32_t now) noexcept
+{
+    // The deadline has expired if now is at or less than half the wrap around period past it.
+    return 0 <= static_cast<int32_t>(now - deadline);
+}
+} // namespace atmega328p
+} // namespace driver
@@ -6,6 +6,7 @@
 #include <stdint.h>
 
 #include "driver/timer/interface.h"
+#include "utils/work_queue.h"
 
 namespace driver 
 {
@@ -16,20 +17,49 @@ namespace atmega328p
  * 
  *        This class is non-copyable and non-movable.
  *
+ *        Each timer runs its circuit in CTC mode with the prescaler and compare value picked
+ *        from the timeout, hence the hardware interrupts at the deadline rather than at a fixed
+ *        tick. Timeouts exceeding the range of the counter are split into the fewest equal 
+ *        compare periods, which are counted in the interrupt. The circuit is stopped while
+ *        the timer is stopped.
+ *
  * @note Tree hardware timers Timer 0 - Timer 2 are available.
  */
 class Timer final : public TimerInterface
 {
 public:
+    struct Circuit; // Indexes of the hardware timer circuits.
+
+    /**
+     * @brief Reserve a hardware timer circuit for exclusive use by another driver.
+     * 
+     *        Timers created while the circuit is reserved use the remaining circuits.
+     * 
+     * @param[in] circuit Index of the timer circuit to reserve, see Timer::Circuit.
+     * 
+     * @return True if the circuit was reserved, false if it's invalid or already in use.
+     */
+    static bool reserveCircuit(const uint8_t circuit) noexcept;
+
+    /**
+     * @brief Release a hardware timer circuit reserved via reserveCircuit.
+     * 
+     * @param[in] circuit Index of the timer circuit to release, see Timer::Circuit.
+     */
+    static void releaseCircuit(const uint8_t circuit) noexcept;
+
     /**
      * @brief Create a new timer with the given elapse time.
      *
      * @param[in] elapseTimeMs The elapse time of timer in milliseconds.
      * @param[in] callback Callback to invoke on timeout (default = none).
      * @param[in] startTimer Start the timer immediately (default = false).
+     * @param[in] callbackMode Invoke the callback in the timer interrupt or defer it to the 
+     *                         work queue (default = immediate).
      */
     explicit Timer(const uint32_t elapseTimeMs, void (*callback)() = nullptr,
-                   const bool startTimer = false) noexcept;
+                   const bool startTimer = false, 
+                   const utils::CallbackMode callbackMode = utils::CallbackMode::Immediate) noexcept;
 
     /**
      * @brief Delete the timer.
@@ -56,12 +86,32 @@ public:
     /**
      * @brief Check whether the timer has timed out.
      * 
-     *        The timer will restart automatically on timeout.
+     *        The timer will restart automatically on timeout. The compare periods elapsed 
+     *        since the deadline count towards the next timeout, hence a late check doesn't 
+     *        drift; whole timeouts elapsed meanwhile are counted as overruns. If a callback is
+     *        added, the timeout is checked and handled in the timer interrupt.
      *
      * @return True if the timer has timed out, false otherwise.
      */
     bool hasTimedOut() noexcept override;
 
+    /**
+     * @brief Get the number of overrun timeouts.
+     * 
+     * @return The number of overrun timeouts since the timer was created.
+     */
+    uint32_t overrunCount() const noexcept override;
+
+    /**
+     * @brief Get the worst lateness of the timer.
+     * 
+     *        The lateness is measured by the counter of the circuit when the timeout is 
+     *        checked, with a resolution of one timer clock cycle.
+     * 
+     * @return The worst lateness in microseconds since the timer was created.
+     */
+    uint32_t maxLateness_us() const noexcept override;
+
     /**
      * @brief Get the timeout of the timer.
      * 
@@ -100,8 +150,11 @@ public:
      * @brief Add callback function for the timer.
      *
      * @param[in] callback Pointer to callback function.
+     * @param[in] callbackMode Invoke the callback in the timer interrupt or defer it to the 
+     *                         work queue (default = immediate).
      */
-    void addCallback(void (*callback)()) const noexcept;
+    void addCallback(void (*callback)(), 
+                     const utils::CallbackMode callbackMode = utils::CallbackMode::Immediate) const noexcept;
 
     /**
      * @brief Remove callback function for the timer.
@@ -109,7 +162,7 @@ public:
     void removeCallback() const noexcept;
 
     /**
-     * @brief Increment the timer if it's enabled.
+     * @brief Increment the number of elapsed compare periods if the timer is enabled.
      *
      * @return True if the timer was incremented, false otherwise.
      */
@@ -128,11 +181,27 @@ private:
     /** Hardware structure associated with the timer. */
     Hardware* myHardware;
 
-    /** Max value to count up to. */
+    /** The number of compare periods per timeout. */
     uint32_t myMaxCount;
 
+    /** The number of overrun timeouts. */
+    volatile uint32_t myOverrunCount;
+
+    /** The worst lateness in microseconds. */
+    volatile uint32_t myMaxLateness_us;
+
     /** Indicate whether the timer is enabled. */
     bool myEnabled;
 };
+
+/**
+ * @brief Structure of indexes for the hardware timer circuits.
+ */
+struct Timer::Circuit
+{
+    static constexpr uint8_t Timer0{0U}; // 8-bit Timer 0.
+    static constexpr uint8_t Timer1{1U}; // 16-bit Timer 1.
+    static constexpr uint8_t Timer2{2U}; // 8-bit Timer 2.
+};
 } // namespace atmega328p
 } // namespace driver
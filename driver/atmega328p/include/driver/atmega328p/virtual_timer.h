@@ -0,0 +1,196 @@
+/**
+ * @brief Virtual timer driver for ATmega328P, multiplexing timers on a single hardware timer.
+ */
+#pragma once
+
+#include <stdint.h>
+
+#include "driver/timer/interface.h"
+#include "utils/work_queue.h"
+
+namespace driver
+{
+namespace atmega328p
+{
+/**
+ * @brief Virtual timer driver for ATmega328P.
+ *
+ *        All virtual timers share hardware timer Timer 2, which ticks once per millisecond
+ *        and drives a hashed timing wheel. Each timer is hashed into a wheel slot by its
+ *        deadline, hence starting, stopping and expiring a timer are constant-time
+ *        operations, and each tick only visits the timers in one slot.
+ *
+ *        Timer nodes are allocated from a static pool of VirtualTimer::MaxCount nodes.
+ *        Timer 2 is reserved while any virtual timer exists, see Timer::reserveCircuit, and
+ *        its clock is stopped while no virtual timer is running.
+ *
+ *        Callbacks are invoked in interrupt context when the associated timer expires, unless
+ *        they are deferred to the work queue.
+ *        Timeouts have a resolution of one tick; a timer started while the wheel is running
+ *        expires up to one tick early.
+ *
+ *        This class is non-copyable and non-movable.
+ */
+class VirtualTimer final : public TimerInterface
+{
+public:
+    /** Enumeration of timer modes. */
+    enum class Mode : uint8_t;
+
+    /** The maximum number of virtual timers. */
+    static constexpr uint8_t MaxCount{8U};
+
+    /**
+     * @brief Create a new periodic virtual timer with the given elapse time.
+     *
+     *        Use setMode to make the timer one-shot.
+     *
+     * @param[in] elapseTimeMs The elapse time of timer in milliseconds.
+     * @param[in] callback Callback to invoke on timeout (default = none).
+     * @param[in] startTimer Start the timer immediately (default = false).
+     * @param[in] callbackMode Invoke the callback in the tick interrupt or defer it to the 
+     *                         work queue (default = immediate).
+     */
+    explicit VirtualTimer(const uint32_t elapseTimeMs, void (*callback)() = nullptr,
+                          const bool startTimer = false, 
+                          const utils::CallbackMode callbackMode = utils::CallbackMode::Immediate) noexcept;
+
+    /**
+     * @brief Delete the timer.
+     */
+    ~VirtualTimer() noexcept override;
+
+    /**
+     * @brief Check if the timer is initialized.
+     *
+     *        An uninitialized timer indicates that no timer node was available, or that
+     *        Timer 2 was in use, when the timer was created.
+     *
+     * @return True if the timer is initialized, false otherwise.
+     */
+    bool isInitialized() const noexcept override;
+
+    /**
+     * @brief Check whether the timer is enabled.
+     *
+     *        One-shot timers are disabled once expired.
+     *
+     * @return True if the timer is enabled, false otherwise.
+     */
+    bool isEnabled() const noexcept override;
+
+    /**
+     * @brief Check whether the timer has timed out since the last check.
+     *
+     *        Periodic timers are reinserted relative to the tick of their deadline, hence the 
+     *        time of the check doesn't affect the next timeout.
+     *
+     * @return True if the timer has timed out, false otherwise.
+     */
+    bool hasTimedOut() noexcept override;
+
+    /**
+     * @brief Get the number of overrun timeouts.
+     *
+     * @return The number of overrun timeouts since the timer was created.
+     */
+    uint32_t overrunCount() const noexcept override;
+
+    /**
+     * @brief Get the worst lateness of the timer.
+     *
+     *        The lateness is the latency of the tick interrupt, measured by the counter of 
+     *        Timer 2 with a resolution of 8 us. Only lateness under one tick is measured, since
+     *        the counter restarts every tick.
+     *
+     * @return The worst lateness in microseconds since the timer was created.
+     */
+    uint32_t maxLateness_us() const noexcept override;
+
+    /**
+     * @brief Get the timeout of the timer.
+     *
+     * @return The timeout in milliseconds.
+     */
+    uint32_t timeout_ms() const noexcept override;
+
+    /**
+     * @brief Set timeout of the timer.
+     *
+     *        The new timeout of a running timer is counted from now.
+     *
+     * @param[in] timeout_ms The new timeout in milliseconds.
+     */
+    void setTimeout_ms(const uint32_t timeout_ms) noexcept override;
+
+    /**
+     * @brief Start the timer.
+     */
+    void start() noexcept override;
+
+    /**
+     * @brief Stop the timer.
+     */
+    void stop() noexcept override;
+
+    /**
+     * @brief Toggle the timer.
+     */
+    void toggle() noexcept override;
+
+    /**
+     * @brief Restart the timer.
+     */
+    void restart() noexcept override;
+
+    /**
+     * @brief Get the timer mode.
+     *
+     * @return The timer mode.
+     */
+    Mode mode() const noexcept;
+
+    /**
+     * @brief Set the timer mode.
+     *
+     * @param[in] mode The new timer mode, which applies from the next timeout.
+     */
+    void setMode(const Mode mode) noexcept;
+
+    /**
+     * @brief Add callback function for the timer.
+     *
+     * @param[in] callback Pointer to callback function.
+     * @param[in] callbackMode Invoke the callback in the tick interrupt or defer it to the 
+     *                         work queue (default = immediate).
+     */
+    void addCallback(void (*callback)(), 
+                     const utils::CallbackMode callbackMode = utils::CallbackMode::Immediate) const noexcept;
+
+    /**
+     * @brief Remove callback function for the timer.
+     */
+    void removeCallback() const noexcept;
+
+    VirtualTimer()                               = delete; // No default constructor.
+    VirtualTimer(const VirtualTimer&)            = delete; // No copy constructor.
+    VirtualTimer(VirtualTimer&&)                 = delete; // No move constructor.
+    VirtualTimer& operator=(const VirtualTimer&) = delete; // No copy assignment.
+    VirtualTimer& operator=(VirtualTimer&&)      = delete; // No move assignment.
+
+private:
+    /** Index of the timer node in the pool, VirtualTimer::MaxCount if none. */
+    const uint8_t myNode;
+};
+
+/**
+ * @brief Enumeration of timer modes.
+ */
+enum class VirtualTimer::Mode : uint8_t
+{
+    OneShot,  // The timer stops on timeout.
+    Periodic, // The timer restarts on timeout.
+    Count,    // The number of timer modes available.
+};
+} // namespace atmega328p
+} // namespace driver
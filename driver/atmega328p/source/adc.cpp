@@ -1,9 +1,18 @@
 /**
  * @brief ADC driver implementation details for the ATmega328P ADC (A/D converter).
  */
+#ifndef F_CPU
+#define F_CPU 16000000UL // Default CPU frequency measured in Hz.
+#endif
+
+#include <avr/interrupt.h>
 #include <avr/io.h>
+#include <avr/sleep.h>
+#include <util/atomic.h>
 
+#include "container/ring_buffer.h"
 #include "driver/atmega328p/adc.h"
+#include "driver/atmega328p/timer.h"
 #include "utils/utils.h"
 
 namespace driver 
@@ -17,41 +26,681 @@ namespace
  */
 struct AdcParam
 {
-    /** Resolution in bits. */
-    static constexpr uint8_t Resolution{10U};
+    /** Maximum number of extra bits of resolution gained by oversampling. */
+    static constexpr uint8_t MaxExtraBits{3U};
+
+    /** Nominal supply voltage in millivolts, used until calibrated. */
+    static constexpr uint16_t SupplyVoltage_mV{5000U};
+
+    /** Minimum valid supply voltage in millivolts. */
+    static constexpr uint16_t MinSupplyVoltage_mV{1800U};
 
-    /** Max value of the ADC (limited by the resolution). */
-    static constexpr uint16_t MaxValue{1023U};
+    /** Maximum valid supply voltage in millivolts. */
+    static constexpr uint16_t MaxSupplyVoltage_mV{5500U};
 
-    /** Supply voltage in Volts. */
-    static constexpr double SupplyVoltage{5.0};
+    /** Internal bandgap reference voltage in millivolts, used for the temperature sensor and 
+        to calibrate the supply voltage. */
+    static constexpr uint16_t InternalReference_mV{1100U};
+
+    /** The number of bandgap conversions averaged per blocking calibration. */
+    static constexpr uint8_t CalibrationSampleCount{4U};
+
+    /** Factor to convert millivolts to Volts (multiply instead of dividing by 1000). */
+    static constexpr double VoltsPerMillivolt{0.001};
 
     /** ADC port offset (pin [14:19] == port [A0:A5]). */
     static constexpr uint8_t PortOffset{14U};
+
+    /** The number of channels (A0 - A5, the temperature sensor and the bandgap reference). */
+    static constexpr uint8_t ChannelCount{8U};
+
+    /** The number of buffered samples of asynchronous conversions. */
+    static constexpr size_t SampleBufferSize{8U};
+
+    /** CPU frequency in Hz. */
+    static constexpr uint32_t CpuFrequency_Hz{F_CPU};
+
+    /** ADC clock cycles per auto-triggered conversion (13.5 rounded up). */
+    static constexpr uint32_t TriggeredConversionCycles{14U};
+
+    /** Conversion rate of the scan sequencer in Hz, i.e. the scan tick rate. */
+    static constexpr uint16_t ScanTickRate_hz{1000U};
+
+    /** Maximum scan rate of a channel in Hz (every other conversion is discarded on mux switch). */
+    static constexpr uint16_t MaxScanRate_hz{ScanTickRate_hz / 2U};
+};
+
+/**
+ * @brief Structure of speed/accuracy profile parameters, indexed by AdcInterface::Profile.
+ */
+struct ProfileParam
+{
+    /** ADC clock prescaler of each profile. */
+    static constexpr uint8_t Prescalers[]{128U, 32U, 16U};
+
+    /** Prescaler select bits (ADPS2 - ADPS0) of each profile. */
+    static constexpr uint8_t PrescalerBits[]
+    {
+        (1U << ADPS2) | (1U << ADPS1) | (1U << ADPS0),
+        (1U << ADPS2) | (1U << ADPS0),
+        (1U << ADPS2),
+    };
+
+    /** Mask of the prescaler select bits. */
+    static constexpr uint8_t PrescalerMask{(1U << ADPS2) | (1U << ADPS1) | (1U << ADPS0)};
+
+    /** Resolution in bits of each profile; 8-bit results are read from ADCH only. */
+    static constexpr uint8_t Resolutions[]{10U, 10U, 8U};
+};
+
+static_assert(static_cast<uint8_t>(AdcInterface::Profile::Count) == sizeof(ProfileParam::Prescalers),
+              "Missing profile parameters!");
+
+/**
+ * @brief Structure of fixed-point scaling parameters.
+ * 
+ *        A digital value is scaled to a full-scale value, e.g. the reference voltage in
+ *        millivolts, as (code * factor + 2^15) >> 16, where factor = fullScale * 2^16 / maxValue
+ *        is precomputed for each effective resolution. Hence no division is needed at runtime.
+ */
+struct ScaleParam
+{
+    /** The lowest effective resolution in bits (the fast profile without oversampling). */
+    static constexpr uint8_t MinResolution{8U};
+
+    /** The number of effective resolutions (8 - 13 bits). */
+    static constexpr uint8_t ResolutionCount{10U + AdcParam::MaxExtraBits - MinResolution + 1U};
+
+    /** Fractional bits of the scale factors. */
+    static constexpr uint8_t Shift{16U};
+};
+
+/**
+ * @brief Table of scale factors of each effective resolution for a given full-scale value.
+ */
+struct ScaleTable
+{
+    /**
+     * @brief Compute the scale factors, at compile time for constant full-scale values.
+     * 
+     * @param[in] fullScale The value corresponding to the max digital value (max 2^15).
+     */
+    constexpr explicit ScaleTable(const uint32_t fullScale) noexcept
+        : factors{}
+    {
+        for (uint8_t i{}; i < ScaleParam::ResolutionCount; ++i)
+        {
+            // The product code * factor is at most fullScale * 2^16 + maxValue, i.e. fits 32 bits.
+            const uint32_t maxValue{static_cast<uint32_t>((1UL << (ScaleParam::MinResolution + i)) 
+                                                          - 1U)};
+            factors[i] = ((fullScale << ScaleParam::Shift) + maxValue / 2U) / maxValue;
+        }
+    }
+
+    /** The scale factor of each effective resolution. */
+    uint32_t factors[ScaleParam::ResolutionCount];
 };
 
+/**
+ * @brief Structure of the constant scale tables used for fixed-point conversions.
+ */
+struct ScaleTables
+{
+    /** Scale to millivolts for channels using the internal reference. */
+    static constexpr ScaleTable InternalReference{AdcParam::InternalReference_mV};
+
+    /** Scale to Q1.15 duty cycles. */
+    static constexpr ScaleTable DutyCycle{AdcInterface::DutyCycleScale};
+};
+
+/**
+ * @brief Structure of parameters for conversions with the CPU asleep (noise reduction).
+ */
+struct SleepParam
+{
+    /** Clock select bits of Timer 0 in TCCR0B, the timer runs if any bit is set. */
+    static constexpr uint8_t Timer0Clock{(1U << CS02) | (1U << CS01) | (1U << CS00)};
+
+    /** Clock select bits of Timer 1 in TCCR1B. */
+    static constexpr uint8_t Timer1Clock{(1U << CS12) | (1U << CS11) | (1U << CS10)};
+
+    /** Clock select bits of Timer 2 in TCCR2B. */
+    static constexpr uint8_t Timer2Clock{(1U << CS22) | (1U << CS21) | (1U << CS20)};
+
+    /** USART receiver and transmitter enable bits in UCSR0B. */
+    static constexpr uint8_t Usart{(1U << RXEN0) | (1U << TXEN0)};
+};
+
+/**
+ * @brief Structure of Timer 1 parameters, used as trigger source for periodic conversions.
+ */
+struct TriggerParam
+{
+    /** The available clock prescalers, where clock select bits CS10 - CS12 = index + 1. */
+    static constexpr uint16_t Prescalers[]{1U, 8U, 64U, 256U, 1024U};
+
+    /** The number of available clock prescalers. */
+    static constexpr uint8_t PrescalerCount{sizeof(Prescalers) / sizeof(Prescalers[0U])};
+
+    /** Max count of the 16-bit counter. */
+    static constexpr uint32_t MaxCount{65536UL};
+
+    /** Trigger source select bits for Timer 1 compare match B in ADCSRB. */
+    static constexpr uint8_t Source{(1U << ADTS2) | (1U << ADTS0)};
+};
+
+/**
+ * @brief Structure of ADC channel parameters.
+ */
+struct ChannelParam
+{
+    /** AVcc reference selection. */
+    static constexpr uint8_t SupplyReference{(1U << REFS0)};
+
+    /** Internal 1.1 V reference selection. */
+    static constexpr uint8_t InternalReference{(1U << REFS1) | (1U << REFS0)};
+
+    /** Mask of the reference selection bits. */
+    static constexpr uint8_t ReferenceMask{(1U << REFS1) | (1U << REFS0)};
+
+    /** ADMUX value of each channel; the temperature sensor requires the internal reference. */
+    static constexpr uint8_t Mux[AdcParam::ChannelCount]
+    {
+        SupplyReference | 0U, SupplyReference | 1U, SupplyReference | 2U,
+        SupplyReference | 3U, SupplyReference | 4U, SupplyReference | 5U,
+        InternalReference | (1U << MUX3),
+        SupplyReference | (1U << MUX3) | (1U << MUX2) | (1U << MUX1),
+    };
+};
+
+/**
+ * @brief Structure holding the analog watchdog window of a channel.
+ */
+struct Window
+{
+    /** The lowest digital value inside the window. */
+    uint16_t low;
+
+    /** The highest digital value inside the window. */
+    uint16_t high;
+
+    /** Hysteresis in digital values to leave the zone below or above the window. */
+    uint16_t hysteresis;
+
+    /** The zone of the latest sample. */
+    AdcInterface::Zone zone;
+};
+
+/**
+ * @brief Enumeration of ADC operating modes.
+ */
+enum class Mode : uint8_t
+{
+    Idle,     // No conversions in progress.
+    Blocking, // Blocking conversion in progress, see Adc::read.
+    Single,   // Asynchronous conversion in progress, see Adc::startConversion.
+    Sampling, // Periodic conversions of a single channel, see Adc::startSampling.
+    Scanning, // Periodic conversions of the scanned channels, see Adc::startScan.
+    Count,    // The number of modes available.
+};
+
+/** Sample buffer, filled by the conversion complete interrupt and drained by readSample. */
+container::RingBuffer<AdcInterface::Sample, AdcParam::SampleBufferSize> sampleBuffer{};
+
+/** The number of samples lost due to a full sample buffer. */
+volatile uint32_t lostSamples{};
+
+/** The current operating mode. */
+volatile Mode mode{Mode::Idle};
+
+/** The channel selected by the multiplexer. */
+volatile uint8_t currentChannel{};
+
+/** Indicate whether the next conversion is the first one after a mux switch. */
+volatile bool settling{false};
+
+/** Clock used to timestamp samples. */
+AdcInterface::Clock sampleClock{nullptr};
+
+/** Latest sample of each scanned channel. */
+AdcInterface::Sample latestSamples[AdcParam::ChannelCount]{};
+
+/** Channels holding a valid latest sample, one bit per channel. */
+volatile uint8_t validChannels{};
+
+/** Scan period of each channel in scan ticks (0 if the channel isn't scanned). */
+uint16_t scanPeriods[AdcParam::ChannelCount]{};
+
+/** Remaining scan ticks until each channel is due. */
+uint16_t scanCountdowns[AdcParam::ChannelCount]{};
+
+/** Channels due for conversion, one bit per channel. */
+uint8_t dueChannels{};
+
+/** Extra bits of resolution, i.e. 4^extraBits conversions are accumulated per sample. */
+volatile uint8_t extraBits{};
+
+/** Sum of the conversions accumulated for the current sample. */
+uint16_t accumulator{};
+
+/** The number of conversions accumulated for the current sample. */
+uint8_t accumulatedCount{};
+
+/** The speed/accuracy profile. */
+volatile AdcInterface::Profile activeProfile{AdcInterface::Profile::Precise};
+
+/** Analog watchdog window of each channel. */
+Window windows[AdcParam::ChannelCount]{};
+
+/** Channels with an analog watchdog, one bit per channel. */
+volatile uint8_t watchedChannels{};
+
+/** Callback invoked upon analog watchdog crossings. */
+AdcInterface::WatchdogCallback watchdogCallback{nullptr};
+
+/** Indicate whether blocking conversions are made with the CPU asleep. */
+bool noiseReduction{false};
+
+/** Indicate whether a blocking conversion made asleep is complete. */
+volatile bool blockingComplete{false};
+
+/** The calibrated supply voltage in millivolts. */
+volatile uint16_t supplyVoltage_mV{AdcParam::SupplyVoltage_mV};
+
+/** Scale to millivolts for channels using the supply voltage as reference, updated upon 
+    calibration so that conversions don't pay for it. */
+ScaleTable supplyScale{AdcParam::SupplyVoltage_mV};
+
 // -----------------------------------------------------------------------------
 constexpr bool isPinNumberValid(const uint8_t pin) noexcept
 {
-    return utils::inRange(pin, Adc::Pin::A0, Adc::Pin::A5) 
+    return utils::inRange(pin, Adc::Pin::A0, Adc::Pin::Bandgap)
         || utils::inRange(pin, Adc::Port::C0, Adc::Port::C5);
 }
 
 // -----------------------------------------------------------------------------
 constexpr uint8_t isPinAdjustedForOffset(const uint8_t pin) noexcept
 {
-    return Adc::Pin::A5 >= pin ? pin : pin - AdcParam::PortOffset;
+    return Adc::Pin::Bandgap >= pin ? pin : pin - AdcParam::PortOffset;
 }
 
 // -----------------------------------------------------------------------------
-inline uint16_t adcValue(const uint8_t pin) noexcept
+constexpr uint8_t channelBit(const uint8_t channel) noexcept
+{
+    return static_cast<uint8_t>(1U << channel);
+}
+
+// -----------------------------------------------------------------------------
+inline const ScaleTable& millivoltScale(const uint8_t channel) noexcept
+{
+    return Adc::Pin::Temperature == channel ? ScaleTables::InternalReference : supplyScale;
+}
+
+// -----------------------------------------------------------------------------
+inline uint8_t profileIndex() noexcept { return static_cast<uint8_t>(activeProfile); }
+
+// -----------------------------------------------------------------------------
+inline bool isFast() noexcept { return AdcInterface::Profile::Fast == activeProfile; }
+
+// -----------------------------------------------------------------------------
+inline uint16_t result() noexcept
+{
+    // Only read the high byte of the left-adjusted result in the fast profile.
+    return isFast() ? ADCH : ADC;
+}
+
+// -----------------------------------------------------------------------------
+inline uint16_t scale(const ScaleTable& table, const uint16_t code) noexcept
+{
+    const uint8_t resolution{static_cast<uint8_t>(ProfileParam::Resolutions[profileIndex()] 
+                                                  + extraBits)};
+    const uint32_t factor{table.factors[resolution - ScaleParam::MinResolution]};
+    return static_cast<uint16_t>((code * factor + (1UL << (ScaleParam::Shift - 1U))) 
+                                 >> ScaleParam::Shift);
+}
+
+// -----------------------------------------------------------------------------
+inline uint32_t maxSampleRate_hz() noexcept
+{
+    return AdcParam::CpuFrequency_Hz / ProfileParam::Prescalers[profileIndex()]
+        / AdcParam::TriggeredConversionCycles;
+}
+
+// -----------------------------------------------------------------------------
+inline bool interruptsEnabled() noexcept{ return utils::read(SREG, SREG_I); }
+
+// -----------------------------------------------------------------------------
+inline uint32_t timestamp() noexcept { return sampleClock ? sampleClock() : 0U; }
+
+// -----------------------------------------------------------------------------
+inline void resetAccumulator() noexcept
+{
+    accumulator      = 0U;
+    accumulatedCount = 0U;
+}
+
+// -----------------------------------------------------------------------------
+inline bool accumulate(uint16_t& code) noexcept
+{
+    // Accumulate 4^n conversions and decimate the sum by 2^n, which gives n extra bits.
+    accumulator += code;
+    if (++accumulatedCount < (1U << (2U * extraBits))) { return false; }
+    code = accumulator >> extraBits;
+    resetAccumulator();
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+inline void selectChannel(const uint8_t channel) noexcept
+{
+    // Discard the first conversion after a mux switch, since the input needs time to settle.
+    // The result is left-adjusted in the fast profile.
+    const uint8_t mux{static_cast<uint8_t>(ChannelParam::Mux[channel] | (isFast() ? (1U << ADLAR) : 0U))};
+
+    if (ADMUX != mux)
+    {
+        ADMUX    = mux;
+        settling = true;
+    }
+    currentChannel = channel;
+    resetAccumulator();
+}
+
+// -----------------------------------------------------------------------------
+inline void watch(const uint16_t code) noexcept
+{
+    using Zone = AdcInterface::Zone;
+    if (!(watchedChannels & channelBit(currentChannel)) || !watchdogCallback) { return; }
+    Window& window{windows[currentChannel]};
+    const Zone previous{window.zone};
+
+    // A sample must be inside the window by the hysteresis to leave the zone below or above, 
+    // hence noise around a threshold doesn't cause repeated crossings.
+    const uint16_t low{static_cast<uint16_t>(Zone::Below == previous ? 
+        window.low + window.hysteresis : window.low)};
+    const uint16_t high{static_cast<uint16_t>(Zone::Above == previous ? 
+        window.high - window.hysteresis : window.high)};
+    const Zone zone{code < low ? Zone::Below : (high < code ? Zone::Above : Zone::Inside)};
+
+    if (previous != zone)
+    {
+        window.zone = zone;
+        watchdogCallback(currentChannel, code, zone);
+    }
+}
+
+// -----------------------------------------------------------------------------
+inline void pushSample(const uint16_t code) noexcept
 {
-    if (!isPinNumberValid(pin)) { return 0U; }
-    ADMUX = (1U << REFS0) | isPinAdjustedForOffset(pin);
-    utils::set(ADCSRA, ADEN, ADSC, ADPS0, ADPS1, ADPS2);
+    // Only buffer the result here, samples are processed outside interrupt context.
+    const AdcInterface::Sample sample{currentChannel, code, timestamp()};
+    if (!sampleBuffer.push(sample)) { lostSamples = lostSamples + 1U; }
+    watch(code);
+}
+
+// -----------------------------------------------------------------------------
+void scanTick(uint16_t code) noexcept
+{
+    const uint8_t bit{channelBit(currentChannel)};
+
+    // Store the result if the channel is due and enough conversions have been accumulated,
+    // unless it's the first conversion after a mux switch.
+    if (!settling && (dueChannels & bit) && accumulate(code))
+    {
+        latestSamples[currentChannel] = AdcInterface::Sample{currentChannel, code, timestamp()};
+        validChannels = validChannels | bit;
+        dueChannels &= static_cast<uint8_t>(~bit);
+        watch(code);
+    }
+    settling = false;
+
+    // Mark the channels whose scan period has elapsed as due.
+    for (uint8_t i{}; i < AdcParam::ChannelCount; ++i)
+    {
+        if ((0U < scanPeriods[i]) && (0U == --scanCountdowns[i]))
+        {
+            scanCountdowns[i] = scanPeriods[i];
+            dueChannels |= channelBit(i);
+        }
+    }
+
+    // Stay on the current channel while it's due, otherwise switch to the next due channel.
+    // The new channel is converted on the next tick.
+    if (dueChannels & channelBit(currentChannel)) { return; }
+
+    for (uint8_t i{1U}; i < AdcParam::ChannelCount; ++i)
+    {
+        const uint8_t channel{static_cast<uint8_t>((currentChannel + i) % AdcParam::ChannelCount)};
+
+        if (dueChannels & channelBit(channel))
+        {
+            selectChannel(channel);
+            return;
+        }
+    }
+}
+
+// -----------------------------------------------------------------------------
+void handleConversion() noexcept
+{
+    uint16_t code{result()};
+
+    switch (mode)
+    {
+        case Mode::Blocking:
+            // Only reached when converting asleep, see sleepConvert.
+            blockingComplete = true;
+            break;
+        case Mode::Single:
+            // Convert again if the result must be discarded or more conversions are accumulated.
+            if (settling)
+            {
+                settling = false;
+                utils::set(ADCSRA, ADSC);
+            }
+            else if (!accumulate(code)) { utils::set(ADCSRA, ADSC); }
+            else
+            {
+                pushSample(code);
+                mode = Mode::Idle;
+            }
+            break;
+        case Mode::Sampling:
+            // Clear the compare match flag, since the next conversion is triggered by its
+            // rising edge.
+            TIFR1 = (1U << OCF1B);
+            if (settling) { settling = false; }
+            else if (accumulate(code)) { pushSample(code); }
+            break;
+        case Mode::Scanning:
+            TIFR1 = (1U << OCF1B);
+            scanTick(code);
+            break;
+        default:
+            break;
+    }
+}
+
+// -----------------------------------------------------------------------------
+void pollConversion() noexcept
+{
+    // Complete the conversion manually when the conversion complete interrupt can't run,
+    // i.e. when reading with interrupts disabled.
+    if (!interruptsEnabled() && utils::read(ADCSRA, ADIF))
+    {
+        utils::set(ADCSRA, ADIF);
+        handleConversion();
+    }
+}
+
+// -----------------------------------------------------------------------------
+uint16_t convert() noexcept
+{
+    utils::set(ADCSRA, ADEN, ADSC);
     while (!utils::read(ADCSRA, ADIF));
     utils::set(ADCSRA, ADIF);
-    return ADC;
+    return result();
+}
+
+// -----------------------------------------------------------------------------
+inline uint8_t sleepMode() noexcept
+{
+    // ADC noise reduction mode halts the I/O clock, which would stop the timers (unless Timer 2
+    // runs asynchronously) and corrupt USART transfers. Idle mode only halts the CPU, which
+    // is the main source of switching noise, hence it's used whenever the I/O clock is needed.
+    const bool ioClockNeeded{(0U != (TCCR0B & SleepParam::Timer0Clock))
+        || (0U != (TCCR1B & SleepParam::Timer1Clock))
+        || ((0U != (TCCR2B & SleepParam::Timer2Clock)) && !utils::read(ASSR, AS2))
+        || (0U != (UCSR0B & SleepParam::Usart))};
+    return ioClockNeeded ? SLEEP_MODE_IDLE : SLEEP_MODE_ADC;
+}
+
+// -----------------------------------------------------------------------------
+uint16_t sleepConvert() noexcept
+{
+    blockingComplete = false;
+    set_sleep_mode(sleepMode());
+    utils::set(ADCSRA, ADIE);
+    utils::set(ADCSRA, ADEN, ADSC);
+
+    // Sleep until the conversion complete interrupt has run; other interrupts may wake the CPU
+    // earlier. Interrupts are disabled while checking, and sei is used directly since the 
+    // instruction following it (sleep) is executed before any pending interrupt.
+    cli();
+
+    while (!blockingComplete)
+    {
+        sleep_enable();
+        sei();
+        sleep_cpu();
+        sleep_disable();
+        cli();
+    }
+    sei();
+    utils::clear(ADCSRA, ADIE);
+    return result();
+}
+
+// -----------------------------------------------------------------------------
+inline uint16_t blockingConvert() noexcept
+{
+    // The CPU can't be woken up by the interrupt if interrupts are disabled.
+    return noiseReduction && interruptsEnabled() ? sleepConvert() : convert();
+}
+
+// -----------------------------------------------------------------------------
+bool claimBlocking() noexcept
+{
+    bool claimed{false};
+
+    // Wait for any asynchronous conversion to complete, then claim the ADC so that no
+    // asynchronous conversion is started meanwhile. Periodic conversions are never waited for.
+    while (!claimed)
+    {
+        ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+        {
+            if ((Mode::Sampling == mode) || (Mode::Scanning == mode)) { return false; }
+            claimed = Mode::Idle == mode;
+            if (claimed) { mode = Mode::Blocking; }
+        }
+        if (!claimed) { pollConversion(); }
+    }
+
+    // Convert with the conversion complete interrupt disabled, since it would clear the flag
+    // polled here.
+    utils::clear(ADCSRA, ADIE);
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+uint16_t blockingChannelValue(const uint8_t channel, const bool settleOnReferenceOnly) noexcept
+{
+    const uint8_t previousMux{ADMUX};
+    selectChannel(channel);
+
+    // Convert twice after a mux switch, the first result is discarded. If requested, only 
+    // discard after a reference switch or when selecting an internal channel, since the 
+    // external channels share the sample and hold circuit and settle within a conversion.
+    const bool mustSettle{!settleOnReferenceOnly 
+        || (0U != ((previousMux ^ ADMUX) & ChannelParam::ReferenceMask))
+        || (Adc::Pin::Temperature <= channel)};
+
+    if (settling && mustSettle) { blockingConvert(); }
+    settling = false;
+    uint16_t value{};
+    do { value = blockingConvert(); } while (!accumulate(value));
+    return value;
+}
+
+// -----------------------------------------------------------------------------
+inline uint16_t adcValue(const uint8_t pin) noexcept
+{
+    if (!isPinNumberValid(pin) || !claimBlocking()) { return 0U; }
+    const uint16_t value{blockingChannelValue(isPinAdjustedForOffset(pin), false)};
+    mode = Mode::Idle;
+    return value;
+}
+
+// -----------------------------------------------------------------------------
+constexpr uint32_t triggerCount(const uint8_t prescalerIndex, const uint16_t sampleRate_hz) noexcept
+{
+    // Round the number of timer clock cycles per sample to the nearest value.
+    return (AdcParam::CpuFrequency_Hz / TriggerParam::Prescalers[prescalerIndex] 
+        + sampleRate_hz / 2U) / sampleRate_hz;
+}
+
+// -----------------------------------------------------------------------------
+void startTrigger(const uint16_t sampleRate_hz) noexcept
+{
+    // Enable auto triggering, conversions are started by hardware once the timer runs.
+    ADCSRB = TriggerParam::Source;
+    utils::set(ADCSRA, ADEN, ADATE, ADIF, ADIE);
+
+    // Use the smallest prescaler fitting the period in the 16-bit counter for best accuracy.
+    uint8_t index{};
+    while ((TriggerParam::PrescalerCount > index + 1U) 
+        && (TriggerParam::MaxCount < triggerCount(index, sampleRate_hz))) { ++index; }
+    const uint32_t count{triggerCount(index, sampleRate_hz)};
+
+    // Run Timer 1 in CTC mode with OCR1A as top, compare match B triggers once per period.
+    TCCR1A = 0U;
+    TCCR1B = 0U;
+    TCNT1  = 0U;
+    OCR1A  = static_cast<uint16_t>(count - 1U);
+    OCR1B  = OCR1A;
+    TIFR1  = (1U << OCF1B);
+    TCCR1B = static_cast<uint8_t>((1U << WGM12) | (index + 1U));
+}
+
+// -----------------------------------------------------------------------------
+void stopTrigger() noexcept
+{
+    // A conversion in progress is discarded, since the interrupt is disabled.
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        TCCR1B = 0U;
+        OCR1A  = 0U;
+        OCR1B  = 0U;
+        TIFR1  = (1U << OCF1B);
+        utils::clear(ADCSRA, ADATE, ADIE);
+        ADCSRB = 0U;
+        mode   = Mode::Idle;
+    }
+    Timer::releaseCircuit(Timer::Circuit::Timer1);
+}
+
+// -----------------------------------------------------------------------------
+bool claimTrigger(const Mode newMode) noexcept
+{
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        if ((Mode::Idle != mode) || !Timer::reserveCircuit(Timer::Circuit::Timer1))
+        {
+            return false;
+        }
+        mode = newMode;
+    }
+    return true;
 }
 } // namespace 
 
@@ -66,32 +715,360 @@ AdcInterface& Adc::getInstance() noexcept
 }
 
 // -----------------------------------------------------------------------------
-uint8_t Adc::resolution() const noexcept { return AdcParam::Resolution; }
+uint8_t Adc::resolution() const noexcept
+{
+    return ProfileParam::Resolutions[profileIndex()] + extraBits;
+}
+
+// -----------------------------------------------------------------------------
+uint16_t Adc::maxValue() const noexcept
+{
+    return static_cast<uint16_t>((1UL << resolution()) - 1U);
+}
+
+// -----------------------------------------------------------------------------
+double Adc::supplyVoltage() const noexcept 
+{ 
+    return supplyMillivolts() * AdcParam::VoltsPerMillivolt; 
+}
+
+// -----------------------------------------------------------------------------
+uint16_t Adc::supplyMillivolts() const noexcept 
+{ 
+    uint16_t supplyVoltage{};
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) { supplyVoltage = supplyVoltage_mV; }
+    return supplyVoltage;
+}
 
 // -----------------------------------------------------------------------------
-uint16_t Adc::maxValue() const noexcept { return AdcParam::MaxValue; }
+bool Adc::setSupplyMillivolts(const uint16_t supplyVoltage) noexcept
+{
+    if (!utils::inRange(supplyVoltage, AdcParam::MinSupplyVoltage_mV, 
+                        AdcParam::MaxSupplyVoltage_mV)) { return false; }
+
+    // Compute the scale factors before updating, the divisions are only made here.
+    const ScaleTable scale{supplyVoltage};
+
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        supplyScale      = scale;
+        supplyVoltage_mV = supplyVoltage;
+    }
+    return true;
+}
 
 // -----------------------------------------------------------------------------
-double Adc::supplyVoltage() const noexcept { return AdcParam::SupplyVoltage; }
+bool Adc::calibrate() noexcept
+{
+    if (!myEnabled) { return false; }
+    Sample sample{};
+    uint32_t sum{};
+    uint8_t count{};
+
+    // Use the latest sample if the bandgap reference is scanned, since blocking conversions 
+    // aren't possible meanwhile. Otherwise the conversions are averaged to reduce noise.
+    if (readLatest(Pin::Bandgap, sample)) 
+    { 
+        sum   = sample.code; 
+        count = 1U;
+    }
+    else
+    {
+        for (; AdcParam::CalibrationSampleCount > count; ++count)
+        {
+            // No conversions are made while sampling or scanning, in which case 0 is returned.
+            const uint16_t code{adcValue(Pin::Bandgap)};
+            if (0U == code) { return false; }
+            sum += code;
+        }
+    }
+    if (0U == sum) { return false; }
+
+    // The bandgap is measured against the supply voltage, i.e. code = V_bg * maxValue / V_cc.
+    const uint32_t supplyVoltage{(static_cast<uint32_t>(AdcParam::InternalReference_mV) 
+        * maxValue() * count + sum / 2U) / sum};
+    return (UINT16_MAX >= supplyVoltage) 
+        && setSupplyMillivolts(static_cast<uint16_t>(supplyVoltage));
+}
 
 // -----------------------------------------------------------------------------
 uint16_t Adc::read(const uint8_t analogPin) const noexcept
 { 
-    return myEnabled ? adcValue(analogPin) : 0U;
+    if (!myEnabled) { return 0U; }
+    Sample sample{};
+
+    // Scanned channels are read from the cache, other channels are converted.
+    return readLatest(analogPin, sample) ? sample.code : adcValue(analogPin);
+}
+
+// -----------------------------------------------------------------------------
+bool Adc::read(const uint8_t* analogPins, uint16_t* values, const size_t count) const noexcept
+{
+    if (!myEnabled || (nullptr == analogPins) || (nullptr == values)) { return false; }
+
+    for (size_t i{}; i < count; ++i)
+    {
+        if (!isPinNumberValid(analogPins[i])) { return false; }
+    }
+    bool claimed{false};
+    bool complete{true};
+
+    // Claim the ADC once and convert back to back, scanned pins are read from the cache.
+    for (size_t i{}; i < count; ++i)
+    {
+        Sample sample{};
+
+        if (readLatest(analogPins[i], sample)) { values[i] = sample.code; }
+        else if (claimed || (claimed = claimBlocking()))
+        {
+            values[i] = blockingChannelValue(isPinAdjustedForOffset(analogPins[i]), true);
+        }
+        else
+        {
+            values[i] = 0U;
+            complete  = false;
+        }
+    }
+    if (claimed) { mode = Mode::Idle; }
+    return complete;
 }
 
 // -----------------------------------------------------------------------------
 double Adc::dutyCycle(const uint8_t analogPin) const noexcept
 {
-    return read(analogPin) / static_cast<double>(AdcParam::MaxValue);
+    // Multiply by a power of two instead of dividing by the max value.
+    return dutyCycleQ15(analogPin) * (1.0 / DutyCycleScale);
 }
 
 // -----------------------------------------------------------------------------
 double Adc::inputVoltage(const uint8_t analogPin) const noexcept
 {
-    return dutyCycle(analogPin) * AdcParam::SupplyVoltage;
+    return inputMillivolts(analogPin) * AdcParam::VoltsPerMillivolt;
 }
 
+// -----------------------------------------------------------------------------
+uint16_t Adc::dutyCycleQ15(const uint8_t analogPin) const noexcept
+{
+    return scale(ScaleTables::DutyCycle, read(analogPin));
+}
+
+// -----------------------------------------------------------------------------
+uint16_t Adc::inputMillivolts(const uint8_t analogPin) const noexcept
+{
+    return toMillivolts(analogPin, read(analogPin));
+}
+
+// -----------------------------------------------------------------------------
+uint16_t Adc::toMillivolts(const uint8_t analogPin, const uint16_t code) const noexcept
+{
+    return scale(millivoltScale(isPinAdjustedForOffset(analogPin)), code);
+}
+
+// -----------------------------------------------------------------------------
+bool Adc::startConversion(const uint8_t analogPin) noexcept
+{
+    if (!myEnabled || !isPinNumberValid(analogPin)) { return false; }
+
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        if (Mode::Idle != mode) { return false; }
+        mode = Mode::Single;
+    }
+    // Start the conversion and return, the result is buffered by the interrupt.
+    selectChannel(isPinAdjustedForOffset(analogPin));
+    utils::set(ADCSRA, ADEN, ADSC, ADIE);
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+bool Adc::isBusy() const noexcept { return Mode::Idle != mode; }
+
+// -----------------------------------------------------------------------------
+bool Adc::readSample(Sample& sample) noexcept { return sampleBuffer.pop(sample); }
+
+// -----------------------------------------------------------------------------
+uint32_t Adc::lostSampleCount() const noexcept
+{
+    uint32_t count{};
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) { count = lostSamples; }
+    return count;
+}
+
+// -----------------------------------------------------------------------------
+void Adc::setClock(const Clock clock) noexcept
+{
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) { sampleClock = clock; }
+}
+
+// -----------------------------------------------------------------------------
+bool Adc::startSampling(const uint8_t analogPin, const uint16_t sampleRate_hz) noexcept
+{
+    // Convert 4^n times per sample period when oversampling.
+    const uint32_t conversionRate_hz{static_cast<uint32_t>(sampleRate_hz) << (2U * extraBits)};
+    stopSampling();
+
+    if (!myEnabled || !isPinNumberValid(analogPin) || (0U == sampleRate_hz)
+        || (maxSampleRate_hz() < conversionRate_hz) || (UINT16_MAX < conversionRate_hz) 
+        || !claimTrigger(Mode::Sampling))
+    {
+        return false;
+    }
+    selectChannel(isPinAdjustedForOffset(analogPin));
+    startTrigger(static_cast<uint16_t>(conversionRate_hz));
+    mySampleRate_hz = sampleRate_hz;
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+void Adc::stopSampling() noexcept
+{
+    if (Mode::Sampling != mode) { return; }
+    stopTrigger();
+    mySampleRate_hz = 0U;
+}
+
+// -----------------------------------------------------------------------------
+uint16_t Adc::sampleRate_hz() const noexcept { return mySampleRate_hz; }
+
+// -----------------------------------------------------------------------------
+bool Adc::setScanRate(const uint8_t analogPin, const uint16_t scanRate_hz) noexcept
+{
+    if (!isPinNumberValid(analogPin) || (AdcParam::MaxScanRate_hz < scanRate_hz)) { return false; }
+    const uint8_t channel{isPinAdjustedForOffset(analogPin)};
+    const uint8_t bit{channelBit(channel)};
+    const uint16_t period{static_cast<uint16_t>(0U < scanRate_hz ?
+        (AdcParam::ScanTickRate_hz + scanRate_hz / 2U) / scanRate_hz : 0U)};
+
+    // The channel is due on the next tick, removed channels are no longer cached.
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        scanPeriods[channel]    = period;
+        scanCountdowns[channel] = 1U;
+
+        if (0U == period)
+        {
+            validChannels = validChannels & static_cast<uint8_t>(~bit);
+            dueChannels  &= static_cast<uint8_t>(~bit);
+        }
+    }
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+bool Adc::startScan() noexcept
+{
+    if (Mode::Scanning == mode) { return true; }
+    if (!myEnabled || !claimTrigger(Mode::Scanning)) { return false; }
+
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        dueChannels = 0U;
+        for (auto& countdown : scanCountdowns) { countdown = 1U; }
+        resetAccumulator();
+    }
+    startTrigger(AdcParam::ScanTickRate_hz);
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+void Adc::stopScan() noexcept
+{
+    if (Mode::Scanning != mode) { return; }
+    stopTrigger();
+    validChannels = 0U;
+}
+
+// -----------------------------------------------------------------------------
+bool Adc::isScanning() const noexcept { return Mode::Scanning == mode; }
+
+// -----------------------------------------------------------------------------
+bool Adc::readLatest(const uint8_t analogPin, Sample& sample) const noexcept
+{
+    if (!isPinNumberValid(analogPin)) { return false; }
+    const uint8_t channel{isPinAdjustedForOffset(analogPin)};
+
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        if (!(validChannels & channelBit(channel))) { return false; }
+        sample = latestSamples[channel];
+    }
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+bool Adc::setWatchdog(const uint8_t analogPin, const uint16_t low, const uint16_t high,
+                      const uint16_t hysteresis) noexcept
+{
+    if (!isPinNumberValid(analogPin) || (high < low) || ((high - low) / 2U < hysteresis)) 
+    { 
+        return false; 
+    }
+    const uint8_t channel{isPinAdjustedForOffset(analogPin)};
+
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        windows[channel] = Window{low, high, hysteresis, Zone::Inside};
+        watchedChannels  = watchedChannels | channelBit(channel);
+    }
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+void Adc::clearWatchdog(const uint8_t analogPin) noexcept
+{
+    if (!isPinNumberValid(analogPin)) { return; }
+    const uint8_t channel{isPinAdjustedForOffset(analogPin)};
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) { watchedChannels &= static_cast<uint8_t>(~channelBit(channel)); }
+}
+
+// -----------------------------------------------------------------------------
+void Adc::setWatchdogCallback(const WatchdogCallback callback) noexcept
+{
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) { watchdogCallback = callback; }
+}
+
+// -----------------------------------------------------------------------------
+bool Adc::setOversampling(const uint8_t extraBitCount) noexcept
+{
+    if (AdcParam::MaxExtraBits < extraBitCount) { return false; }
+
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        if (Mode::Idle != mode) { return false; }
+        extraBits = extraBitCount;
+    }
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+uint8_t Adc::oversampling() const noexcept { return extraBits; }
+
+// -----------------------------------------------------------------------------
+bool Adc::setProfile(const Profile newProfile) noexcept
+{
+    if (Profile::Count <= newProfile) { return false; }
+
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        if (Mode::Idle != mode) { return false; }
+        activeProfile = newProfile;
+
+        // Set the prescaler here, conversions are started without touching the prescaler bits.
+        ADCSRA = static_cast<uint8_t>((ADCSRA & ~ProfileParam::PrescalerMask) 
+            | ProfileParam::PrescalerBits[profileIndex()]);
+    }
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+AdcInterface::Profile Adc::profile() const noexcept { return activeProfile; }
+
+// -----------------------------------------------------------------------------
+void Adc::setNoiseReduction(const bool enable) noexcept { noiseReduction = enable; }
+
+// -----------------------------------------------------------------------------
+bool Adc::isNoiseReductionEnabled() const noexcept { return noiseReduction; }
+
 // -----------------------------------------------------------------------------
 bool Adc::isInitialized() const noexcept { return true; }
 
@@ -99,13 +1076,27 @@ bool Adc::isInitialized() const noexcept { return true; }
 bool Adc::isEnabled() const noexcept { return myEnabled; }
 
 // -----------------------------------------------------------------------------
-void Adc::setEnabled(const bool enable) noexcept { myEnabled = enable; }
+void Adc::setEnabled(const bool enable) noexcept 
+{ 
+    if (!enable)
+    {
+        stopSampling();
+        stopScan();
+    }
+    myEnabled = enable; 
+}
 
 // -----------------------------------------------------------------------------
 Adc::Adc() noexcept
     : myEnabled{false}
+    , mySampleRate_hz{0U}
 {
+    setProfile(Profile::Precise);
     read(Pin::A0);
 }
+
+// -----------------------------------------------------------------------------
+ISR (ADC_vect) { handleConversion(); }
+
 } // namespace atmega328p
 } // namespace driver
@@ -6,6 +6,7 @@
 #include "driver/atmega328p/gpio.h"
 #include "utils/callback_array.h"
 #include "utils/utils.h"
+#include "utils/work_queue.h"
 
 namespace driver 
 {
@@ -48,6 +49,9 @@ struct GpioParam
     /** Pointers to callbacks. */
     static container::CallbackArray<IoPortCount> callbacks;
 
+    /** Indicate which callbacks are deferred to the work queue. */
+    static bool deferred[IoPortCount];
+
     /** Pin registry (1 = reserved, 0 = free). */
     static uint32_t pinRegistry;
 };
@@ -55,6 +59,9 @@ struct GpioParam
 /** Pointers to callbacks. */
 container::CallbackArray<GpioParam::IoPortCount> GpioParam::callbacks{};
 
+/** Indicate which callbacks are deferred to the work queue. */
+bool GpioParam::deferred[GpioParam::IoPortCount]{};
+
 /** Pin registry (1 = reserved, 0 = free). */
 uint32_t GpioParam::pinRegistry{};
 
@@ -82,7 +89,7 @@ constexpr bool isPinConnectedToPortC(const uint8_t pin) noexcept
 // -----------------------------------------------------------------------------
 constexpr bool isPinConnectedToPortD(const uint8_t pin) noexcept
 {
-    return utils::inRange(pin, Gpio::Port::D0, Gpio::Port::D5);
+    return utils::inRange(pin, Gpio::Port::D0, Gpio::Port::D7);
 }
 
 // -----------------------------------------------------------------------------
@@ -94,6 +101,14 @@ constexpr uint8_t getPhysicalPin(const uint8_t pin) noexcept
     else                                 { return static_cast<uint8_t>(-1); }  
 }
 
+// -----------------------------------------------------------------------------
+constexpr uint8_t getPinNumber(const uint8_t physicalPin, const Gpio::IoPort port) noexcept
+{
+    if (Gpio::IoPort::B == port)      { return physicalPin + PinOffset::PortB; }
+    else if (Gpio::IoPort::C == port) { return physicalPin + PinOffset::PortC; }
+    else                              { return physicalPin + PinOffset::PortD; }
+}
+
 // -----------------------------------------------------------------------------
 constexpr bool isDirectionValid(const Gpio::Direction direction) noexcept
 {
@@ -103,7 +118,8 @@ constexpr bool isDirectionValid(const Gpio::Direction direction) noexcept
 // -----------------------------------------------------------------------------
 inline void invokeCallback(const uint8_t port) noexcept
 {
-    GpioParam::callbacks.invoke(port);
+    if (GpioParam::deferred[port]) { (void) utils::WorkQueue::post(GpioParam::callbacks[port]); }
+    else { GpioParam::callbacks.invoke(port); }
 }
 } // namespace
 
@@ -165,7 +181,8 @@ struct Gpio::Hardware Gpio::myHwPortD
 };
 
 // -----------------------------------------------------------------------------
-Gpio::Gpio(const uint8_t pin, const Direction direction, void (*callback)()) noexcept
+Gpio::Gpio(const uint8_t pin, const Direction direction, void (*callback)(), 
+           const utils::CallbackMode callbackMode) noexcept
     : myHardware{reserve(pin, direction)}
     , myPin{getPhysicalPin(pin)}
 { 
@@ -173,17 +190,18 @@ Gpio::Gpio(const uint8_t pin, const Direction direction, void (*callback)()) noe
     if (myHardware)
     {
         setDirection(direction);
-        if (callback) { setCallback(callback); }
+        if (callback) { setCallback(callback, callbackMode); }
     }
 }
 
 // -----------------------------------------------------------------------------
 Gpio::~Gpio() noexcept 
 { 
-    // Free resources used for the GPIO before deletion.
+    // Free resources used for the GPIO before deletion, if any.
+    if (!myHardware) { return; }
     utils::clear(myHardware->dirReg, myPin);
     utils::clear(myHardware->portReg, myPin);
-    utils::clear(GpioParam::pinRegistry, myPin);
+    utils::clear(GpioParam::pinRegistry, getPinNumber(myPin, myHardware->port));
 
     enableInterrupt(false);
     myHardware = nullptr; 
@@ -279,21 +297,17 @@ void Gpio::setDirection(const Direction direction) noexcept
 }
 
 // -----------------------------------------------------------------------------
-void Gpio::setCallback(void (*callback)()) const noexcept
+void Gpio::setCallback(void (*callback)(), const utils::CallbackMode callbackMode) const noexcept
 {
     // Register the given callback for the associated I/O port.
-    if (myHardware->portReg == PORTB)      
-    { 
-        GpioParam::callbacks.add(callback, CallbackIndex::PortB); 
-    }
-    else if (myHardware->portReg == PORTC) 
-    { 
-        GpioParam::callbacks.add(callback, CallbackIndex::PortC); 
-    } 
-    else if (myHardware->portReg == PORTD) 
-    { 
-        GpioParam::callbacks.add(callback, CallbackIndex::PortD); 
-    }
+    uint8_t port{};
+    if (myHardware->portReg == PORTB)      { port = CallbackIndex::PortB; }
+    else if (myHardware->portReg == PORTC) { port = CallbackIndex::PortC; } 
+    else if (myHardware->portReg == PORTD) { port = CallbackIndex::PortD; }
+    else { return; }
+
+    GpioParam::callbacks.add(callback, port);
+    GpioParam::deferred[port] = utils::CallbackMode::Deferred == callbackMode;
 }
 
 // -----------------------------------------------------------------------------
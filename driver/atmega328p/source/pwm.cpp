@@ -0,0 +1,534 @@
+/**
+ * @brief Implementation details of the PWM driver.
+ *
+ *        The circuits are reconfigured in normal mode with the clock stopped, since the output
+ *        compare registers are only double buffered in PWM mode, i.e. new compare values would
+ *        otherwise wait for the end of a period that never comes.
+ */
+#ifndef F_CPU
+#define F_CPU 16000000UL // Default CPU frequency measured in Hz.
+#endif
+
+#include <avr/io.h>
+#include <util/atomic.h>
+
+#include "driver/atmega328p/pwm.h"
+#include "driver/atmega328p/timer.h"
+#include "utils/utils.h"
+
+namespace driver
+{
+namespace atmega328p
+{
+namespace
+{
+/**
+ * @brief Structure of PWM parameters.
+ */
+struct PwmParam
+{
+    /** CPU frequency in Hz. */
+    static constexpr uint32_t CpuFrequency_Hz{F_CPU};
+
+    /** The number of timer circuits. */
+    static constexpr uint8_t CircuitCount{3U};
+
+    /** The number of channels per timer circuit. */
+    static constexpr uint8_t ChannelsPerCircuit{2U};
+
+    /** Top value of the 8-bit timers Timer 0 and Timer 2. */
+    static constexpr uint16_t Top8{255U};
+
+    /** Minimum top value of Timer 1, i.e. at least four duty cycle steps. */
+    static constexpr uint16_t MinTop16{3U};
+
+    /** Maximum top value of Timer 1, keeping the number of fast PWM steps within 16 bits. */
+    static constexpr uint32_t MaxTop16{65534UL};
+
+    /** Prescalers of Timer 0 and Timer 1, where clock select bits CSn2 - CSn0 = index + 1. */
+    static constexpr uint16_t Prescalers[]{1U, 8U, 64U, 256U, 1024U};
+
+    /** Prescalers of Timer 2, where clock select bits CS22 - CS20 = index + 1. */
+    static constexpr uint16_t Timer2Prescalers[]{1U, 8U, 32U, 64U, 128U, 256U, 1024U};
+
+    /** Output pins of the channels, see Pwm::Channel. */
+    static constexpr uint8_t Pins[]{Gpio::Port::D6, Gpio::Port::D5, Gpio::Port::B1,
+                                    Gpio::Port::B2, Gpio::Port::B3, Gpio::Port::D3};
+
+    /** Pin number used for invalid channels, which no GPIO can be created for. */
+    static constexpr uint8_t InvalidPin{0xFFU};
+};
+
+static_assert(static_cast<uint8_t>(Pwm::Channel::Count) == sizeof(PwmParam::Pins),
+              "Invalid number of PWM output pins!");
+
+/**
+ * @brief Structure holding waveform generation mode bits of the timer circuits.
+ */
+struct ModeBits
+{
+    /** Fast PWM with top 0xFF (mode 3) of Timer 0 and Timer 2 in TCCR0A/TCCR2A. */
+    static constexpr uint8_t Fast8{(1U << WGM01) | (1U << WGM00)};
+
+    /** Phase correct PWM with top 0xFF (mode 1) of Timer 0 and Timer 2 in TCCR0A/TCCR2A. */
+    static constexpr uint8_t PhaseCorrect8{(1U << WGM00)};
+
+    /** Fast PWM with top ICR1 (mode 14) of Timer 1 in TCCR1A. */
+    static constexpr uint8_t Fast16A{(1U << WGM11)};
+
+    /** Fast PWM with top ICR1 (mode 14) of Timer 1 in TCCR1B. */
+    static constexpr uint8_t Fast16B{(1U << WGM13) | (1U << WGM12)};
+
+    /** Phase correct PWM with top ICR1 (mode 10) of Timer 1 in TCCR1A. */
+    static constexpr uint8_t PhaseCorrect16A{(1U << WGM11)};
+
+    /** Phase correct PWM with top ICR1 (mode 10) of Timer 1 in TCCR1B. */
+    static constexpr uint8_t PhaseCorrect16B{(1U << WGM13)};
+};
+
+/**
+ * @brief Structure of a timer circuit setting.
+ */
+struct Setting
+{
+    /** Top value of the counter. */
+    uint16_t top;
+
+    /** Clock select bits, 0 if the setting is invalid. */
+    uint8_t clockSelect;
+};
+
+/**
+ * @brief Structure of the state of a timer circuit.
+ */
+struct CircuitState
+{
+    /** Channels using the circuit. */
+    Pwm* channels[PwmParam::ChannelsPerCircuit];
+
+    /** The current setting. */
+    Setting setting;
+
+    /** The PWM mode shared by the channels. */
+    Pwm::Mode mode;
+};
+
+/** State of each timer circuit. */
+CircuitState circuits[PwmParam::CircuitCount]{};
+
+// -----------------------------------------------------------------------------
+constexpr bool isChannelValid(const Pwm::Channel channel) noexcept
+{
+    return Pwm::Channel::Count > channel;
+}
+
+// -----------------------------------------------------------------------------
+constexpr uint8_t circuitIndex(const Pwm::Channel channel) noexcept
+{
+    return static_cast<uint8_t>(channel) / PwmParam::ChannelsPerCircuit;
+}
+
+// -----------------------------------------------------------------------------
+constexpr uint8_t channelIndex(const Pwm::Channel channel) noexcept
+{
+    return static_cast<uint8_t>(channel) % PwmParam::ChannelsPerCircuit;
+}
+
+// -----------------------------------------------------------------------------
+constexpr uint8_t outputPin(const Pwm::Channel channel) noexcept
+{
+    return isChannelValid(channel) ? PwmParam::Pins[static_cast<uint8_t>(channel)]
+                                   : PwmParam::InvalidPin;
+}
+
+// -----------------------------------------------------------------------------
+constexpr const uint16_t* prescalers(const uint8_t circuit) noexcept
+{
+    return Timer::Circuit::Timer2 == circuit ? PwmParam::Timer2Prescalers : PwmParam::Prescalers;
+}
+
+// -----------------------------------------------------------------------------
+constexpr uint8_t prescalerCount(const uint8_t circuit) noexcept
+{
+    return Timer::Circuit::Timer2 == circuit
+        ? sizeof(PwmParam::Timer2Prescalers) / sizeof(PwmParam::Timer2Prescalers[0U])
+        : sizeof(PwmParam::Prescalers) / sizeof(PwmParam::Prescalers[0U]);
+}
+
+// -----------------------------------------------------------------------------
+constexpr uint32_t periodCycles(const uint16_t top, const Pwm::Mode mode) noexcept
+{
+    // Fast PWM counts from 0 to top, phase correct PWM from 0 to top and back to 0.
+    return Pwm::Mode::Fast == mode ? top + 1UL : 2UL * top;
+}
+
+// -----------------------------------------------------------------------------
+constexpr uint32_t divide(const uint32_t dividend, const uint32_t divisor) noexcept
+{
+    // Round to the nearest integer.
+    return (dividend + divisor / 2U) / divisor;
+}
+
+// -----------------------------------------------------------------------------
+constexpr uint32_t absDiff(const uint32_t x, const uint32_t y) noexcept
+{
+    return x < y ? y - x : x - y;
+}
+
+// -----------------------------------------------------------------------------
+Setting select8(const uint8_t circuit, const uint32_t frequency_hz, const Pwm::Mode mode) noexcept
+{
+    // The top is fixed, pick the prescaler reaching the closest frequency.
+    const auto prescaler{prescalers(circuit)};
+    const uint8_t count{prescalerCount(circuit)};
+    const uint32_t cycles{periodCycles(PwmParam::Top8, mode)};
+    const uint32_t maxFrequency_hz{divide(PwmParam::CpuFrequency_Hz, cycles * prescaler[0U])};
+    const uint32_t minFrequency_hz{
+        divide(PwmParam::CpuFrequency_Hz, cycles * prescaler[count - 1U])};
+
+    if ((minFrequency_hz > frequency_hz) || (maxFrequency_hz < frequency_hz))
+    {
+        return Setting{0U, 0U};
+    }
+    uint8_t best{};
+
+    for (uint8_t i{1U}; i < count; ++i)
+    {
+        const uint32_t candidate_hz{divide(PwmParam::CpuFrequency_Hz, cycles * prescaler[i])};
+        const uint32_t best_hz{divide(PwmParam::CpuFrequency_Hz, cycles * prescaler[best])};
+        if (absDiff(candidate_hz, frequency_hz) < absDiff(best_hz, frequency_hz)) { best = i; }
+    }
+    return Setting{PwmParam::Top8, static_cast<uint8_t>(best + 1U)};
+}
+
+// -----------------------------------------------------------------------------
+Setting select16(const uint32_t frequency_hz, const Pwm::Mode mode) noexcept
+{
+    // Pick the smallest prescaler whose top fits in the counter, i.e. the best resolution.
+    const uint8_t count{prescalerCount(Timer::Circuit::Timer1)};
+
+    for (uint8_t i{}; i < count; ++i)
+    {
+        const uint32_t cycles{
+            divide(PwmParam::CpuFrequency_Hz, frequency_hz * PwmParam::Prescalers[i])};
+        const uint32_t top{Pwm::Mode::Fast == mode ? cycles - 1U : cycles / 2U};
+
+        if ((0U == cycles) || (PwmParam::MinTop16 > top)) { break; }
+        if (PwmParam::MaxTop16 >= top)
+        {
+            return Setting{static_cast<uint16_t>(top), static_cast<uint8_t>(i + 1U)};
+        }
+    }
+    return Setting{0U, 0U};
+}
+
+// -----------------------------------------------------------------------------
+Setting select(const uint8_t circuit, const uint32_t frequency_hz, const Pwm::Mode mode) noexcept
+{
+    // Frequencies above the CPU frequency would overflow the computations.
+    if ((0U == frequency_hz) || (PwmParam::CpuFrequency_Hz < frequency_hz))
+    {
+        return Setting{0U, 0U};
+    }
+    return Timer::Circuit::Timer1 == circuit ? select16(frequency_hz, mode)
+                                             : select8(circuit, frequency_hz, mode);
+}
+
+// -----------------------------------------------------------------------------
+uint16_t compareValue(const uint16_t dutyCycle, const uint16_t top, const Pwm::Mode mode) noexcept
+{
+    // Fast PWM is high for compare + 1 of top + 1 cycles, phase correct PWM for compare of
+    // top cycles, hence 0 means off in both cases.
+    const uint32_t steps{Pwm::Mode::Fast == mode ? static_cast<uint32_t>(top) + 1U : top};
+
+    // Rounding would leave a full duty cycle one step short at high resolutions.
+    if (UINT16_MAX == dutyCycle) { return static_cast<uint16_t>(steps); }
+    return static_cast<uint16_t>((static_cast<uint32_t>(dutyCycle) * steps + 0x8000UL) >> 16U);
+}
+
+// -----------------------------------------------------------------------------
+void writeCompare(const Pwm::Channel channel, const uint16_t compare) noexcept
+{
+    switch (channel)
+    {
+        case Pwm::Channel::Timer0A:
+            OCR0A = static_cast<uint8_t>(compare);
+            break;
+        case Pwm::Channel::Timer0B:
+            OCR0B = static_cast<uint8_t>(compare);
+            break;
+        case Pwm::Channel::Timer1A:
+            // The 16-bit registers share a temporary high byte register with the interrupts.
+            ATOMIC_BLOCK(ATOMIC_RESTORESTATE) { OCR1A = compare; }
+            break;
+        case Pwm::Channel::Timer1B:
+            ATOMIC_BLOCK(ATOMIC_RESTORESTATE) { OCR1B = compare; }
+            break;
+        case Pwm::Channel::Timer2A:
+            OCR2A = static_cast<uint8_t>(compare);
+            break;
+        case Pwm::Channel::Timer2B:
+            OCR2B = static_cast<uint8_t>(compare);
+            break;
+        default:
+            break;
+    }
+}
+
+// -----------------------------------------------------------------------------
+void connect(const Pwm::Channel channel, const bool connected) noexcept
+{
+    // Clear the output on compare match and set it at the bottom (non-inverting mode),
+    // a disconnected output follows the port register, i.e. stays low.
+    volatile uint8_t* controlReg{nullptr};
+    uint8_t bit{};
+
+    switch (channel)
+    {
+        case Pwm::Channel::Timer0A:
+            controlReg = &TCCR0A;
+            bit        = COM0A1;
+            break;
+        case Pwm::Channel::Timer0B:
+            controlReg = &TCCR0A;
+            bit        = COM0B1;
+            break;
+        case Pwm::Channel::Timer1A:
+            controlReg = &TCCR1A;
+            bit        = COM1A1;
+            break;
+        case Pwm::Channel::Timer1B:
+            controlReg = &TCCR1A;
+            bit        = COM1B1;
+            break;
+        case Pwm::Channel::Timer2A:
+            controlReg = &TCCR2A;
+            bit        = COM2A1;
+            break;
+        case Pwm::Channel::Timer2B:
+            controlReg = &TCCR2A;
+            bit        = COM2B1;
+            break;
+        default:
+            return;
+    }
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        if (connected) { utils::set(*controlReg, bit); }
+        else { utils::clear(*controlReg, bit); }
+    }
+}
+
+// -----------------------------------------------------------------------------
+void halt(const uint8_t circuit) noexcept
+{
+    // Stop the clock in normal mode with the outputs disconnected.
+    switch (circuit)
+    {
+        case Timer::Circuit::Timer0:
+            TCCR0B = 0U;
+            TCCR0A = 0U;
+            TCNT0  = 0U;
+            break;
+        case Timer::Circuit::Timer1:
+            TCCR1B = 0U;
+            TCCR1A = 0U;
+            ATOMIC_BLOCK(ATOMIC_RESTORESTATE) { TCNT1 = 0U; }
+            break;
+        case Timer::Circuit::Timer2:
+            TCCR2B = 0U;
+            TCCR2A = 0U;
+            TCNT2  = 0U;
+            break;
+        default:
+            break;
+    }
+}
+
+// -----------------------------------------------------------------------------
+void run(const uint8_t circuit, const Setting& setting, const Pwm::Mode mode) noexcept
+{
+    // Enter PWM mode once the compare values are written, the outputs are left connected.
+    const bool fast{Pwm::Mode::Fast == mode};
+
+    switch (circuit)
+    {
+        case Timer::Circuit::Timer0:
+            TCCR0A |= fast ? ModeBits::Fast8 : ModeBits::PhaseCorrect8;
+            TCCR0B = setting.clockSelect;
+            break;
+        case Timer::Circuit::Timer1:
+            ATOMIC_BLOCK(ATOMIC_RESTORESTATE) { ICR1 = setting.top; }
+            TCCR1A |= fast ? ModeBits::Fast16A : ModeBits::PhaseCorrect16A;
+            TCCR1B = (fast ? ModeBits::Fast16B : ModeBits::PhaseCorrect16B) | setting.clockSelect;
+            break;
+        case Timer::Circuit::Timer2:
+            TCCR2A |= fast ? ModeBits::Fast8 : ModeBits::PhaseCorrect8;
+            TCCR2B = setting.clockSelect;
+            break;
+        default:
+            break;
+    }
+}
+} // namespace
+
+// -----------------------------------------------------------------------------
+Pwm::Pwm(const Channel channel, const uint32_t frequency_hz, const Mode mode) noexcept
+    : myChannel{channel}
+    , myPin{outputPin(channel), Gpio::Direction::Output}
+    , myDutyCycle{0U}
+    , myInitialized{false}
+    , myEnabled{true}
+{
+    if (myPin.isInitialized()) { myPin.write(false); }
+    myInitialized = reserve(frequency_hz, mode);
+}
+
+// -----------------------------------------------------------------------------
+Pwm::~Pwm() noexcept
+{
+    if (myInitialized) { release(); }
+}
+
+// -----------------------------------------------------------------------------
+Pwm::Channel Pwm::channel() const noexcept { return myChannel; }
+
+// -----------------------------------------------------------------------------
+Pwm::Mode Pwm::mode() const noexcept
+{
+    return myInitialized ? circuits[circuitIndex(myChannel)].mode : Mode::Count;
+}
+
+// -----------------------------------------------------------------------------
+bool Pwm::isInitialized() const noexcept { return myInitialized; }
+
+// -----------------------------------------------------------------------------
+bool Pwm::isEnabled() const noexcept { return myInitialized && myEnabled; }
+
+// -----------------------------------------------------------------------------
+void Pwm::setEnabled(const bool enable) noexcept
+{
+    myEnabled = enable;
+    if (myInitialized) { writeOutput(); }
+}
+
+// -----------------------------------------------------------------------------
+uint32_t Pwm::frequency_hz() const noexcept
+{
+    if (!myInitialized) { return 0U; }
+    const auto& circuit{circuits[circuitIndex(myChannel)]};
+    const uint16_t prescaler{prescalers(circuitIndex(myChannel))[circuit.setting.clockSelect - 1U]};
+    return divide(PwmParam::CpuFrequency_Hz,
+                  periodCycles(circuit.setting.top, circuit.mode) * prescaler);
+}
+
+// -----------------------------------------------------------------------------
+bool Pwm::setFrequency_hz(const uint32_t frequency_hz) noexcept
+{
+    if (!myInitialized) { return false; }
+    const uint8_t index{circuitIndex(myChannel)};
+    auto& circuit{circuits[index]};
+    const Setting setting{select(index, frequency_hz, circuit.mode)};
+    if (0U == setting.clockSelect) { return false; }
+
+    // Rescale the duty cycles of both channels to the new top while the circuit is halted.
+    circuit.setting = setting;
+    halt(index);
+
+    for (auto channel : circuit.channels)
+    {
+        if (channel) { channel->writeOutput(); }
+    }
+    run(index, setting, circuit.mode);
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+uint16_t Pwm::resolution() const noexcept
+{
+    if (!myInitialized) { return 0U; }
+    const auto& circuit{circuits[circuitIndex(myChannel)]};
+    return Mode::Fast == circuit.mode ? circuit.setting.top + 1U : circuit.setting.top;
+}
+
+// -----------------------------------------------------------------------------
+uint16_t Pwm::dutyCycle16() const noexcept { return myDutyCycle; }
+
+// -----------------------------------------------------------------------------
+void Pwm::setDutyCycle8(const uint8_t dutyCycle) noexcept
+{
+    // Repeat the byte, hence 255 is scaled to 65535.
+    setDutyCycle16(static_cast<uint16_t>((static_cast<uint16_t>(dutyCycle) << 8U) | dutyCycle));
+}
+
+// -----------------------------------------------------------------------------
+void Pwm::setDutyCycle16(const uint16_t dutyCycle) noexcept
+{
+    myDutyCycle = dutyCycle;
+    if (myInitialized) { writeOutput(); }
+}
+
+// -----------------------------------------------------------------------------
+bool Pwm::reserve(const uint32_t frequency_hz, const Mode mode) noexcept
+{
+    if (!myPin.isInitialized() || !isChannelValid(myChannel) || (Mode::Count <= mode))
+    {
+        return false;
+    }
+    const uint8_t index{circuitIndex(myChannel)};
+    auto& circuit{circuits[index]};
+    const bool inUse{circuit.channels[0U] || circuit.channels[1U]};
+
+    // The other channel of the circuit, if any, determines the mode.
+    if (inUse && (circuit.mode != mode)) { return false; }
+    const Setting setting{select(index, frequency_hz, mode)};
+    if ((0U == setting.clockSelect) || (!inUse && !Timer::reserveCircuit(index))) { return false; }
+
+    circuit.channels[channelIndex(myChannel)] = this;
+    circuit.mode    = mode;
+    circuit.setting = setting;
+    halt(index);
+
+    for (auto channel : circuit.channels)
+    {
+        if (channel) { channel->writeOutput(); }
+    }
+    run(index, setting, mode);
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+void Pwm::release() noexcept
+{
+    const uint8_t index{circuitIndex(myChannel)};
+    auto& circuit{circuits[index]};
+    connect(myChannel, false);
+    circuit.channels[channelIndex(myChannel)] = nullptr;
+    myInitialized = false;
+
+    // Stop the circuit along with the last channel.
+    if (!circuit.channels[0U] && !circuit.channels[1U])
+    {
+        halt(index);
+        if (Timer::Circuit::Timer1 == index) { ATOMIC_BLOCK(ATOMIC_RESTORESTATE) { ICR1 = 0U; } }
+        circuit.setting = Setting{0U, 0U};
+        Timer::releaseCircuit(index);
+    }
+}
+
+// -----------------------------------------------------------------------------
+void Pwm::writeOutput() noexcept
+{
+    // A duty cycle of 0 % is made by disconnecting the output, since fast PWM can't reach it.
+    const auto& circuit{circuits[circuitIndex(myChannel)]};
+    const uint16_t compare{compareValue(myDutyCycle, circuit.setting.top, circuit.mode)};
+    const bool connected{myEnabled && (0U < compare)};
+
+    if (connected)
+    {
+        writeCompare(myChannel, Mode::Fast == circuit.mode ? compare - 1U : compare);
+    }
+    connect(myChannel, connected);
+}
+} // namespace atmega328p
+} // namespace driver
@@ -1,8 +1,18 @@
 /**
  * @brief Implementation details of serial driver.
  */
-#include <avr/io.h>
+#ifndef F_CPU
+#define F_CPU 16000000UL // Default CPU frequency measured in Hz.
+#endif
 
+#ifndef SERIAL_BAUD_RATE_BPS
+#define SERIAL_BAUD_RATE_BPS 9600UL // Default baud rate measured in bps.
+#endif
+
+#include <avr/interrupt.h>
+#include <util/atomic.h>
+
+#include "container/ring_buffer.h"
 #include "driver/atmega328p/serial.h"
 #include "utils/utils.h"
 
@@ -17,8 +27,26 @@ namespace
  */
 struct Param
 {
-    // Baud rate in bps.
-    static constexpr uint32_t BaudRate_bps{9600U};
+    // CPU frequency in Hz.
+    static constexpr uint32_t CpuFrequency_Hz{F_CPU};
+
+    // Requested baud rate in bps.
+    static constexpr uint32_t BaudRate_bps{SERIAL_BAUD_RATE_BPS};
+
+    // Maximum supported baud rate in bps.
+    static constexpr uint32_t MaxBaudRate_bps{1000000UL};
+
+    // Maximum baud rate error in ppm (2 %).
+    static constexpr uint32_t MaxBaudError_ppm{20000UL};
+
+    // Maximum value of the baud rate register.
+    static constexpr uint16_t MaxUbrr{4095U};
+
+    // Size of the transmit buffer in bytes.
+    static constexpr size_t TxBufferSize{64U};
+
+    // Size of the receive buffer in bytes.
+    static constexpr size_t RxBufferSize{32U};
 
     // Carriage return character.
     static constexpr char CarriageReturn{'\r'};
@@ -27,14 +55,113 @@ struct Param
     static constexpr char NewLine{'\n'};
 };
 
+/**
+ * @brief Structure holding baud rate register settings.
+ */
+struct BaudSetting
+{
+    // Value of the baud rate register UBRR0.
+    uint16_t ubrr;
+
+    // Indicate whether double speed mode (U2X0) is used.
+    bool doubleSpeed;
+};
+
+// -----------------------------------------------------------------------------
+constexpr uint32_t clockDivider(const BaudSetting& setting) noexcept
+{
+    // The baud rate generator divides the CPU clock by 16 (8 in double speed mode) * (UBRR + 1).
+    return (setting.doubleSpeed ? 8U : 16U) * (setting.ubrr + static_cast<uint32_t>(1U));
+}
+
+// -----------------------------------------------------------------------------
+constexpr BaudSetting baudSetting(const uint32_t baudRate_bps, const bool doubleSpeed) noexcept
+{
+    // Round UBRR to the nearest value, i.e. UBRR = F_CPU / (16 * baud rate) - 1 in normal mode.
+    const uint32_t divider{(doubleSpeed ? 8U : 16U) * baudRate_bps};
+    const uint32_t value{(Param::CpuFrequency_Hz + divider / 2U) / divider};
+    const uint32_t ubrr{1U >= value ? 0U : value - 1U};
+    return BaudSetting{static_cast<uint16_t>(Param::MaxUbrr < ubrr ? Param::MaxUbrr : ubrr), 
+                       doubleSpeed};
+}
+
 // -----------------------------------------------------------------------------
-void transmitChar(const char character) noexcept
+constexpr uint32_t baudRate_bps(const BaudSetting& setting) noexcept
 {
-    // Wait until the previous character has been sent.
-    while (!utils::read(UCSR0A, UDRE0));
+    return (Param::CpuFrequency_Hz + clockDivider(setting) / 2U) / clockDivider(setting);
+}
 
-    // Put the new character in the transmission register.
-    UDR0 = character;
+// -----------------------------------------------------------------------------
+constexpr uint32_t baudError_ppm(const BaudSetting& setting, const uint32_t baudRate_bps) noexcept
+{
+    // Compare F_CPU with the clock needed for the requested baud rate to avoid rounding errors.
+    const uint64_t required{static_cast<uint64_t>(baudRate_bps) * clockDivider(setting)};
+    const uint64_t frequency{Param::CpuFrequency_Hz};
+    const uint64_t difference{frequency > required ? frequency - required : required - frequency};
+    return static_cast<uint32_t>(difference * 1000000ULL / required);
+}
+
+// -----------------------------------------------------------------------------
+constexpr BaudSetting bestBaudSetting(const uint32_t baudRate_bps) noexcept
+{
+    // Use double speed mode only if it results in a lower baud rate error.
+    const BaudSetting normal{baudSetting(baudRate_bps, false)};
+    const BaudSetting doubleSpeed{baudSetting(baudRate_bps, true)};
+    return baudError_ppm(doubleSpeed, baudRate_bps) < baudError_ppm(normal, baudRate_bps) 
+        ? doubleSpeed : normal;
+}
+
+/** Baud rate register settings, computed at compile time. */
+constexpr BaudSetting baud{bestBaudSetting(Param::BaudRate_bps)};
+
+static_assert((0U < Param::BaudRate_bps) && (Param::MaxBaudRate_bps >= Param::BaudRate_bps), 
+    "Serial baud rate must be between 1 bps and 1 Mbps!");
+static_assert(Param::MaxBaudError_ppm >= baudError_ppm(baud, Param::BaudRate_bps),
+    "Serial baud rate can't be generated with an error of at most 2 % at this CPU frequency!");
+
+/** Transmit buffer, filled by put and drained by the data register empty interrupt. */
+container::RingBuffer<char, Param::TxBufferSize> txBuffer{};
+
+/** The number of bytes dropped due to a full transmit buffer. */
+volatile uint32_t droppedBytes{};
+
+/** Receive buffer, filled by the receive complete interrupt and drained by read. */
+container::RingBuffer<char, Param::RxBufferSize> rxBuffer{};
+
+/** The number of received bytes lost due to a full receive buffer or data overrun. */
+volatile uint32_t lostBytes{};
+
+// -----------------------------------------------------------------------------
+constexpr bool isOverflowPolicyValid(const SerialInterface::OverflowPolicy policy) noexcept
+{
+    return SerialInterface::OverflowPolicy::Count > policy;
+}
+
+// -----------------------------------------------------------------------------
+inline bool interruptsEnabled() noexcept { return utils::read(SREG, SREG_I); }
+
+// -----------------------------------------------------------------------------
+inline void enableTxInterrupt() noexcept { utils::set(UCSR0B, UDRIE0); }
+
+// -----------------------------------------------------------------------------
+inline void disableTxInterrupt() noexcept { utils::clear(UCSR0B, UDRIE0); }
+
+// -----------------------------------------------------------------------------
+void transmitNext() noexcept
+{
+    // Put the next buffered character in the transmission register, or stop the
+    // data register empty interrupt once the buffer has been drained.
+    char character{};
+    if (txBuffer.pop(character)) { UDR0 = character; }
+    else { disableTxInterrupt(); }
+}
+
+// -----------------------------------------------------------------------------
+void pollTransmission() noexcept
+{
+    // Drain the buffer manually when the data register empty interrupt can't run,
+    // i.e. when printing with interrupts disabled.
+    if (utils::read(UCSR0A, UDRE0)) { transmitNext(); }
 }
 } // namespace 
 
@@ -49,7 +176,7 @@ SerialInterface& Serial::getInstance() noexcept
 }
 
 // -----------------------------------------------------------------------------
-uint32_t Serial::baudRate_bps() const { return Param::BaudRate_bps; }
+uint32_t Serial::baudRate_bps() const { return atmega328p::baudRate_bps(baud); }
 
 // -----------------------------------------------------------------------------
 bool Serial::isInitialized() const noexcept { return true; }
@@ -60,43 +187,142 @@ bool Serial::isEnabled() const noexcept { return myEnabled; }
 // -----------------------------------------------------------------------------
 void Serial::setEnabled(const bool enable) noexcept { myEnabled = enable; }
 
+// -----------------------------------------------------------------------------
+SerialInterface::OverflowPolicy Serial::overflowPolicy() const noexcept
+{
+    return myOverflowPolicy;
+}
+
+// -----------------------------------------------------------------------------
+void Serial::setOverflowPolicy(const OverflowPolicy policy) noexcept
+{
+    if (isOverflowPolicyValid(policy)) { myOverflowPolicy = policy; }
+}
+
+// -----------------------------------------------------------------------------
+uint32_t Serial::droppedByteCount() const noexcept
+{
+    uint32_t count{};
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) { count = droppedBytes; }
+    return count;
+}
+
+// -----------------------------------------------------------------------------
+void Serial::resetDroppedByteCount() noexcept
+{
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) { droppedBytes = 0U; }
+}
+
+// -----------------------------------------------------------------------------
+bool Serial::read(char& character) noexcept { return rxBuffer.pop(character); }
+
+// -----------------------------------------------------------------------------
+uint32_t Serial::lostByteCount() const noexcept
+{
+    uint32_t count{};
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) { count = lostBytes; }
+    return count;
+}
+
 // -----------------------------------------------------------------------------
 Serial::Serial() noexcept 
-    : myEnabled{false}
+    : myOverflowPolicy{OverflowPolicy::Block}
+    , myEnabled{false}
 { 
-    // Baud rate value corresponding to 9600 kbps.
-    constexpr uint16_t baudRateValue{103U};
-
-    // Enable UART transmission.
-    utils::set(UCSR0B, TXEN0);
+    // Enable UART transmission and reception, including the receive complete interrupt.
+    utils::set(UCSR0B, TXEN0, RXEN0, RXCIE0);
 
     // Set the data size to eight bits per byte.
     utils::set(UCSR0C, UCSZ00, UCSZ01);
 
-    // Set the baud rate to 9600 kbps.
-    UBRR0 = baudRateValue;
+    // Set the baud rate, use double speed mode if it gives a more accurate baud rate.
+    if (baud.doubleSpeed) { utils::set(UCSR0A, U2X0); }
+    UBRR0 = baud.ubrr;
 
     // Send carriage return to align the first message left.
     UDR0 = Param::CarriageReturn;
+
+    // Enable interrupts globally so that the transmit buffer is drained in the background.
+    utils::globalInterruptEnable();
 }
 
 // -----------------------------------------------------------------------------
-void Serial::print(const char* message) const noexcept
+void Serial::put(const char character) const noexcept
 {
     // Terminate the function if serial transmission isn't enabled.
     if (!myEnabled) { return; }
+    transmit(character);
+
+    // Send new line characters instead of carriage returns.
+    if (Param::CarriageReturn == character) 
+    { 
+        transmit(Param::NewLine); 
+    }
+}
+
+// -----------------------------------------------------------------------------
+bool Serial::write(const uint8_t* data, const size_t size) const noexcept
+{
+    if (!myEnabled || (nullptr == data)) { return false; }
+    for (size_t i{}; i < size; ++i) { transmit(static_cast<char>(data[i])); }
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+void Serial::transmit(const char character) const noexcept
+{
+    // Buffer the character and make sure the data register empty interrupt is running.
+    if (txBuffer.push(character))
+    {
+        enableTxInterrupt();
+        return;
+    }
 
-    // Transmit each character of the string one by one.
-    for (const char* it{message}; *it; ++it)
+    // Handle the full buffer according to the overflow policy.
+    switch (myOverflowPolicy)
     {
-        transmitChar(*it);
-        
-        // Send new line characters instead of carriage returns.
-        if (Param::CarriageReturn == *it) 
-        { 
-            transmitChar(Param::NewLine); 
+        case OverflowPolicy::DropNewest:
+            // Characters may be transmitted from interrupt context, hence update atomically.
+            ATOMIC_BLOCK(ATOMIC_RESTORESTATE) { droppedBytes = droppedBytes + 1U; }
+            break;
+        case OverflowPolicy::DropOldest:
+        {
+            // Pop from the producer side, hence the consumer must be blocked meanwhile.
+            ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+            {
+                char oldest{};
+                (void) txBuffer.pop(oldest);
+                (void) txBuffer.push(character);
+                droppedBytes = droppedBytes + 1U;
+            }
+            break;
         }
+        default:
+            // Wait for room in the buffer, drain it manually if interrupts are disabled
+            // (for instance when printing from an interrupt service routine).
+            while (!txBuffer.push(character))
+            {
+                if (!interruptsEnabled()) { pollTransmission(); }
+            }
+            break;
     }
+    enableTxInterrupt();
+}
+
+// -----------------------------------------------------------------------------
+ISR (USART_UDRE_vect) { transmitNext(); }
+
+// -----------------------------------------------------------------------------
+ISR (USART_RX_vect)
+{
+    // Check for data overrun before reading the data register, which clears the error flags.
+    const bool overrun{utils::read(UCSR0A, DOR0)};
+    const char character{static_cast<char>(UDR0)};
+
+    // Only buffer the character here, received data is parsed outside interrupt context.
+    if (overrun) { lostBytes = lostBytes + 1U; }
+    if (!rxBuffer.push(character)) { lostBytes = lostBytes + 1U; }
 }
+
 } // namespace atmega328p
 } // namespace driver
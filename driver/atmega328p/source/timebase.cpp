@@ -0,0 +1,151 @@
+/**
+ * @brief Implementation details of the monotonic system timebase.
+ */
+#ifndef F_CPU
+#define F_CPU 16000000UL // Default CPU frequency measured in Hz.
+#endif
+
+#include <avr/interrupt.h>
+#include <util/atomic.h>
+
+#include "driver/atmega328p/timebase.h"
+#include "driver/atmega328p/timer.h"
+#include "utils/utils.h"
+
+namespace driver
+{
+namespace atmega328p
+{
+namespace
+{
+/**
+ * @brief Structure of timebase parameters.
+ */
+struct TimebaseParam
+{
+    /** CPU frequency in MHz. */
+    static constexpr uint32_t CpuFrequency_MHz{F_CPU / 1000000UL};
+
+    /** Prescaler of Timer 0. */
+    static constexpr uint32_t Prescaler{64U};
+
+    /** Clock select bits of Timer 0 for the prescaler. */
+    static constexpr uint8_t ClockSelect{(1U << CS01) | (1U << CS00)};
+
+    /** The number of microseconds per timer count. */
+    static constexpr uint32_t MicrosPerCount{Prescaler / CpuFrequency_MHz};
+
+    /** The number of microseconds per overflow of the 8-bit counter. */
+    static constexpr uint32_t MicrosPerOverflow{MicrosPerCount * 256UL};
+
+    /** The number of whole milliseconds per overflow. */
+    static constexpr uint32_t MillisPerOverflow{MicrosPerOverflow / 1000UL};
+
+    /** The remaining fraction of a millisecond per overflow in units of 8 us. */
+    static constexpr uint8_t FractionPerOverflow{(MicrosPerOverflow % 1000UL) >> 3U};
+
+    /** One millisecond in units of 8 us. */
+    static constexpr uint8_t FractionMax{1000U >> 3U};
+};
+
+static_assert((0U < TimebaseParam::CpuFrequency_MHz) 
+              && (0U == TimebaseParam::Prescaler % TimebaseParam::CpuFrequency_MHz),
+              "The timer count must be a whole number of microseconds!");
+
+/** The number of overflows since the timebase was started. */
+volatile uint32_t overflowCount{};
+
+/** The time since the timebase was started in ms. */
+volatile uint32_t millisCount{};
+
+/** Fraction of a millisecond not yet added to millisCount, in units of 8 us. */
+volatile uint8_t millisFraction{};
+
+/** Indicate whether the timebase is running. */
+bool running{};
+} // namespace
+
+// -----------------------------------------------------------------------------
+bool Timebase::start() noexcept
+{
+    if (running) { return true; }
+    if (!Timer::reserveCircuit(Timer::Circuit::Timer0)) { return false; }
+
+    // Run Timer 0 in normal mode, the time is counted in the overflow interrupt.
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        TCCR0B         = 0U;
+        TCCR0A         = 0U;
+        TCNT0          = 0U;
+        overflowCount  = 0U;
+        millisCount    = 0U;
+        millisFraction = 0U;
+        TIFR0          = (1U << TOV0);
+        TIMSK0         = (1U << TOIE0);
+        TCCR0B         = TimebaseParam::ClockSelect;
+        running        = true;
+    }
+    utils::globalInterruptEnable();
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+bool Timebase::isRunning() noexcept { return running; }
+
+// -----------------------------------------------------------------------------
+uint32_t Timebase::millis() noexcept
+{
+    uint32_t ms{};
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) { ms = millisCount; }
+    return ms;
+}
+
+// -----------------------------------------------------------------------------
+uint32_t Timebase::micros() noexcept
+{
+    uint32_t overflows{};
+    uint8_t count{};
+
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        overflows = overflowCount;
+        count     = TCNT0;
+
+        // Include an overflow that is pending since interrupts are disabled, unless the 
+        // counter was read just before it wrapped around.
+        if (utils::read(TIFR0, TOV0) && (UINT8_MAX > count)) { ++overflows; }
+    }
+    return ((overflows << 8U) + count) * TimebaseParam::MicrosPerCount;
+}
+
+// -----------------------------------------------------------------------------
+void Timebase::delay_ms(const uint32_t delayTime_ms) noexcept
+{
+    if (!running)
+    {
+        for (uint32_t i{}; i < delayTime_ms; ++i) { utils::delay_ms(1U); }
+        return;
+    }
+    const uint32_t start{millis()};
+    while (elapsed(start, millis()) < delayTime_ms);
+}
+
+// -----------------------------------------------------------------------------
+ISR (TIMER0_OVF_vect)
+{
+    // Carry the fraction of a millisecond over to the next overflow.
+    uint32_t ms{millisCount + TimebaseParam::MillisPerOverflow};
+    uint8_t fraction{static_cast<uint8_t>(millisFraction + TimebaseParam::FractionPerOverflow)};
+
+    if (TimebaseParam::FractionMax <= fraction)
+    {
+        fraction -= TimebaseParam::FractionMax;
+        ++ms;
+    }
+    millisCount    = ms;
+    millisFraction = fraction;
+    overflowCount  = overflowCount + 1U;
+}
+
+} // namespace atmega328p
+} // namespace driver
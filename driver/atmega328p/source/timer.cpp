@@ -1,12 +1,22 @@
 /**
  * @brief Implementation details of hardware timer driver.
+ * 
+ *        Each timer runs its circuit in CTC mode with the prescaler and top value picked from 
+ *        the timeout, hence the hardware only interrupts at the deadline. Timeouts exceeding 
+ *        the range of the circuit are split into equal compare periods counted in software.
  */
+#ifndef F_CPU
+#define F_CPU 16000000UL // Default CPU frequency measured in Hz.
+#endif
+
 #include <avr/interrupt.h>
+#include <util/atomic.h>
 
 #include "container/array.h"
 #include "driver/atmega328p/timer.h" 
 #include "utils/callback_array.h"
 #include "utils/utils.h"
+#include "utils/work_queue.h"
 
 namespace driver 
 {
@@ -17,7 +27,7 @@ namespace atmega328p
  */
 struct Timer::Hardware 
 {
-    /** Hardware counter. */
+    /** The number of compare periods elapsed. */
 	volatile uint32_t counter;
 
     /** Pointer to mask register. */
@@ -29,9 +39,22 @@ struct Timer::Hardware
     /** Timer index. */
 	uint8_t index;  
 
+    /** Top value of the counter, the period is top + 1 timer clock cycles. */
+	uint16_t top;
+
+    /** Clock select bits, 0 if no period is set. */
+	uint8_t clockSelect;
+
     static Hardware* reserve() noexcept;
 	static void release(Hardware* hardware) noexcept;
 
+	uint32_t setPeriod(const uint32_t elapseTimeMs) noexcept;
+	uint32_t period_ms(const uint32_t periodCount) const noexcept;
+	uint32_t micros(const uint32_t ticks) const noexcept;
+	uint16_t count() const noexcept;
+	void run() noexcept;
+	void halt() noexcept;
+
 private:
     static Hardware* init(const uint8_t timerIndex) noexcept;
 }; 
@@ -60,14 +83,14 @@ struct TimerIndex
  */
 struct ControlBits 
 {
-	/** Control bits for Timer 0. */
-	static constexpr uint8_t timer0{(1U << CS01)};
+	/** CTC mode bits for Timer 0 in TCCR0A. */
+	static constexpr uint8_t timer0{(1U << WGM01)};
 
-	/** Control bits for Timer 1. */
-	static constexpr uint8_t timer1{(1U << CS11) | (1U << WGM12)};
+	/** CTC mode bits for Timer 1 in TCCR1B. */
+	static constexpr uint8_t timer1{(1U << WGM12)};
 
-	/** Control bits for Timer 2. */
-	static constexpr uint8_t timer2{(1U << CS21)};
+	/** CTC mode bits for Timer 2 in TCCR2A. */
+	static constexpr uint8_t timer2{(1U << WGM21)};
 };
 
 /**
@@ -78,17 +101,35 @@ struct TimerParam
 	/** The number of available timer circuits. */
 	static constexpr uint8_t circuitCount{3U};
 
-	/** Max count for 16-bit timer Timer 1.  */
-	static constexpr uint16_t timer1MaxCount{256U};  
+	/** CPU frequency in Hz. */
+	static constexpr double cpuFrequencyHz{F_CPU};
+
+	/** CPU frequency in MHz. */
+	static constexpr uint32_t cpuFrequencyMHz{F_CPU / 1000000UL};
+
+	/** Max number of clock cycles per period of the 8-bit timers Timer 0 and Timer 2. */
+	static constexpr uint32_t maxTicks8{256UL};
+
+	/** Max number of clock cycles per period of the 16-bit timer Timer 1. */
+	static constexpr uint32_t maxTicks16{65536UL};
 
-	/** Time between each timer interrupt in ms. */
-	static constexpr double interruptIntervalMs{0.128};
+	/** Prescalers of Timer 0 and Timer 1, where clock select bits CSn2 - CSn0 = index + 1. */
+	static constexpr uint16_t prescalers[]{1U, 8U, 64U, 256U, 1024U};
+
+	/** Prescalers of Timer 2, where clock select bits CS22 - CS20 = index + 1. */
+	static constexpr uint16_t timer2Prescalers[]{1U, 8U, 32U, 64U, 128U, 256U, 1024U};
 
 	/** Array holding pointers to TimerParam::timers. */
 	static Timer* timers[circuitCount];
 
 	/** Array holding pointers to callbacks. */
 	static CallbackArray<circuitCount> callbacks;
+
+	/** Array indicating which circuits are reserved by other drivers. */
+	static bool reserved[circuitCount];
+
+	/** Array indicating which callbacks are deferred to the work queue. */
+	static bool deferred[circuitCount];
 };
 
 /** Array holding pointers to TimerParam::timers. */
@@ -97,11 +138,38 @@ Timer* TimerParam::TimerParam::timers[TimerParam::circuitCount]{};
 /** Array holding pointers to callbacks. */
 CallbackArray<TimerParam::circuitCount> TimerParam::callbacks{};
 
+/** Array indicating which circuits are reserved by other drivers. */
+bool TimerParam::reserved[TimerParam::circuitCount]{};
+
+/** Array indicating which callbacks are deferred to the work queue. */
+bool TimerParam::deferred[TimerParam::circuitCount]{};
+
 // -----------------------------------------------------------------------------
-constexpr uint32_t maxCount(const uint32_t elapseTimeMs) noexcept
+constexpr const uint16_t* prescalers(const uint8_t timerIndex) noexcept
 {
-	return 0U < elapseTimeMs ? 
-        utils::round<uint32_t>(elapseTimeMs / TimerParam::interruptIntervalMs) : 0U;
+	return TimerIndex::timer2 == timerIndex ? TimerParam::timer2Prescalers : TimerParam::prescalers;
+}
+
+// -----------------------------------------------------------------------------
+constexpr uint8_t prescalerCount(const uint8_t timerIndex) noexcept
+{
+	return TimerIndex::timer2 == timerIndex ? 
+		sizeof(TimerParam::timer2Prescalers) / sizeof(TimerParam::timer2Prescalers[0U]) :
+		sizeof(TimerParam::prescalers) / sizeof(TimerParam::prescalers[0U]);
+}
+
+// -----------------------------------------------------------------------------
+constexpr double ticks(const uint32_t elapseTimeMs, const uint16_t prescaler) noexcept
+{
+	return elapseTimeMs * (TimerParam::cpuFrequencyHz / 1000.0) / prescaler;
+}
+
+// -----------------------------------------------------------------------------
+constexpr uint32_t periodCount(const double clockCycles, const uint32_t maxTicks) noexcept
+{
+	// Round up, since each period must fit in the counter.
+	const uint32_t count{static_cast<uint32_t>(clockCycles / maxTicks)};
+	return static_cast<double>(count) * maxTicks < clockCycles ? count + 1U : count;
 }
 
 // -----------------------------------------------------------------------------
@@ -114,23 +182,46 @@ void invokeCallback(const uint8_t timerIndex) noexcept
     {
         timer->increment();
 
-        if (timer->hasTimedOut()) 
+        // Without a callback, the timeout is left for the owner to check via hasTimedOut.
+        if (!TimerParam::callbacks[timerIndex] || !timer->hasTimedOut()) { return; }
+
+		if (TimerParam::deferred[timerIndex]) 
 		{ 
-			TimerParam::callbacks.invoke(timerIndex); 
+			(void) utils::WorkQueue::post(TimerParam::callbacks[timerIndex]); 
 		}
+		else { TimerParam::callbacks.invoke(timerIndex); }
     }
 }
 } // namespace
 
 // -----------------------------------------------------------------------------
-Timer::Timer(const uint32_t elapseTimeMs, void (*callback)(), const bool startTimer) noexcept
+bool Timer::reserveCircuit(const uint8_t circuit) noexcept
+{
+	if ((circuit >= TimerParam::circuitCount) || TimerParam::timers[circuit] 
+		|| TimerParam::reserved[circuit]) { return false; }
+	TimerParam::reserved[circuit] = true;
+	return true;
+}
+
+// -----------------------------------------------------------------------------
+void Timer::releaseCircuit(const uint8_t circuit) noexcept
+{
+	if (circuit < TimerParam::circuitCount) { TimerParam::reserved[circuit] = false; }
+}
+
+// -----------------------------------------------------------------------------
+Timer::Timer(const uint32_t elapseTimeMs, void (*callback)(), const bool startTimer,
+             const utils::CallbackMode callbackMode) noexcept
     : myHardware{Hardware::reserve()}
-	, myMaxCount{maxCount(elapseTimeMs)}
+	, myMaxCount{0U}
+	, myOverrunCount{0U}
+	, myMaxLateness_us{0U}
 	, myEnabled{false}
 {
     if (!myHardware) { return; }
+	myMaxCount = myHardware->setPeriod(elapseTimeMs);
 	TimerParam::timers[myHardware->index] = this;
-	addCallback(callback);
+	addCallback(callback, callbackMode);
 	if (startTimer) { start(); }
 }
 
@@ -151,31 +242,76 @@ bool Timer::isEnabled() const noexcept { return myEnabled; }
 // -----------------------------------------------------------------------------
 bool Timer::hasTimedOut() noexcept
 {
-    if (!myEnabled || (myHardware->counter < myMaxCount)) { return false; } 
-	else 
+    if (!myEnabled) { return false; }
+	uint32_t latePeriods{};
+	uint16_t lateTicks{};
+
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
 	{
-	    myHardware->counter = 0U;
-		return true;
+		if (myHardware->counter < myMaxCount) { return false; }
+
+		// Keep the periods elapsed since the deadline, hence the next timeout is counted from 
+		// the deadline rather than from now. Whole timeouts elapsed meanwhile are skipped.
+		latePeriods = myHardware->counter - myMaxCount;
+		lateTicks   = myHardware->count();
+
+		if (latePeriods < myMaxCount) { myHardware->counter = latePeriods; }
+		else
+		{
+			myOverrunCount      = myOverrunCount + latePeriods / myMaxCount;
+			myHardware->counter = latePeriods % myMaxCount;
+		}
+
+		// A deferred callback still pending from the previous timeout is overrun as well.
+		const uint8_t index{myHardware->index};
+		if (TimerParam::deferred[index] && utils::WorkQueue::isPending(TimerParam::callbacks[index]))
+		{
+			myOverrunCount = myOverrunCount + 1U;
+		}
 	}
+
+	const uint32_t lateness_us{myHardware->micros(latePeriods * (myHardware->top + 1UL) + lateTicks)};
+	if (myMaxLateness_us < lateness_us) { myMaxLateness_us = lateness_us; }
+	return true;
+}
+
+// -----------------------------------------------------------------------------
+uint32_t Timer::overrunCount() const noexcept
+{
+	uint32_t overrunCount{};
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE) { overrunCount = myOverrunCount; }
+	return overrunCount;
+}
+
+// -----------------------------------------------------------------------------
+uint32_t Timer::maxLateness_us() const noexcept
+{
+	uint32_t maxLateness_us{};
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE) { maxLateness_us = myMaxLateness_us; }
+	return maxLateness_us;
 }
 
 // -----------------------------------------------------------------------------
 uint32_t Timer::timeout_ms() const noexcept
 {
-	return utils::round<uint32_t>(myMaxCount * TimerParam::interruptIntervalMs);
+	return myHardware->period_ms(myMaxCount);
 }
 
 // -----------------------------------------------------------------------------
 void Timer::setTimeout_ms(const uint32_t timeout_ms) noexcept
 {
     if (0U == timeout_ms) { stop(); }
-    myMaxCount = maxCount(timeout_ms);
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE) { myMaxCount = myHardware->setPeriod(timeout_ms); }
+
+	// Reprogram a running timer, the new timeout is counted from now.
+	if (myEnabled) { myHardware->run(); }
 }
 
 // -----------------------------------------------------------------------------
 void Timer::start() noexcept
 { 
-	if (0U == myMaxCount) { return; }
+	if ((0U == myMaxCount) || myEnabled) { return; }
+	myHardware->run();
     utils::globalInterruptEnable();
 	utils::set(*(myHardware->maskReg), myHardware->maskBit);
 	myEnabled = true;
@@ -184,8 +320,8 @@ void Timer::start() noexcept
 // -----------------------------------------------------------------------------
 void Timer::stop() noexcept
 { 
-    *(myHardware->maskReg) = 0U;
-	myEnabled              = false; 
+    myHardware->halt();
+	myEnabled = false; 
 }
 
 // -----------------------------------------------------------------------------
@@ -198,14 +334,15 @@ void Timer::toggle() noexcept
 // -----------------------------------------------------------------------------
 void Timer::restart() noexcept
 {
-    myHardware->counter = 0U;
-    start();
+    if (myEnabled) { myHardware->run(); }
+    else { start(); }
 }
 
 // -----------------------------------------------------------------------------
-void Timer::addCallback(void (*callback)()) const noexcept
+void Timer::addCallback(void (*callback)(), const utils::CallbackMode callbackMode) const noexcept
 { 
     TimerParam::callbacks.add(callback, myHardware->index);
+	TimerParam::deferred[myHardware->index] = utils::CallbackMode::Deferred == callbackMode;
 }
 
 // -----------------------------------------------------------------------------
@@ -228,7 +365,7 @@ Timer::Hardware* Timer::Hardware::reserve() noexcept
 	// Reserve a timer circuit if any is available, otherwise return a nullptr.
     for (uint8_t i{}; i < TimerParam::circuitCount; ++i)
 	{
-        if (nullptr == TimerParam::timers[i]) { return init(i); }
+        if ((nullptr == TimerParam::timers[i]) && !TimerParam::reserved[i]) { return init(i); }
 	}
 	return nullptr;
 }
@@ -244,13 +381,17 @@ void Timer::Hardware::release(Timer::Hardware* hardware) noexcept
 	{
 		case TimerIndex::timer0:
 		    TCCR0B = 0U;
+		    TCCR0A = 0U;
+		    OCR0A  = 0U;
 			break;
 		case TimerIndex::timer1:
 		    TCCR1B = 0U;
-		    OCR1A = 0U;
+		    OCR1A  = 0U;
 			break;
 		case TimerIndex::timer2:
 		    TCCR2B = 0U;
+		    TCCR2A = 0U;
+		    OCR2A  = 0U;
 			break;
 		default:
 		    break;
@@ -266,43 +407,170 @@ Timer::Hardware* Timer::Hardware::init(const uint8_t timerIndex) noexcept
     auto hardware{utils::newMemory<Hardware>()};
 	if (!hardware) { return nullptr; }
 
-	// Set the structure to refer to the corresponding timer circuit.
+	// Set the structure to refer to the corresponding timer circuit, the clock is stopped
+	// until the timer is started.
 	switch (timerIndex)
 	{
 		case TimerIndex::timer0:
             hardware->maskReg = &TIMSK0;
-            hardware->maskBit = TOIE0;
-			TCCR0B            = ControlBits::timer0;
+            hardware->maskBit = OCIE0A;
+			TCCR0B            = 0U;
+			TCCR0A            = ControlBits::timer0;
 			break;
 		case TimerIndex::timer1:
             hardware->maskReg = &TIMSK1;
             hardware->maskBit = OCIE1A;
+			TCCR1A            = 0U;
 			TCCR1B            = ControlBits::timer1;
-		    OCR1A             = TimerParam::timer1MaxCount;
 			break;
 		case TimerIndex::timer2:
 		    hardware->maskReg = &TIMSK2;
-            hardware->maskBit = TOIE2;
-			TCCR2B            = ControlBits::timer2;
+            hardware->maskBit = OCIE2A;
+			TCCR2B            = 0U;
+			TCCR2A            = ControlBits::timer2;
 			break;
 		default:
 		    utils::deleteMemory(hardware);
 			return nullptr;
 	}
 	// Return the initialized circuit.
-    hardware->counter = 0U;
-	hardware->index   = timerIndex;
+    hardware->counter     = 0U;
+	hardware->index       = timerIndex;
+	hardware->top         = 0U;
+	hardware->clockSelect = 0U;
 	return hardware;
 }
 
 // -----------------------------------------------------------------------------
-ISR (TIMER0_OVF_vect) { invokeCallback(TimerIndex::timer0); }
+uint32_t Timer::Hardware::setPeriod(const uint32_t elapseTimeMs) noexcept
+{
+	// Return 0 periods if no timeout is set, since the timer can't run.
+	top         = 0U;
+	clockSelect = 0U;
+	if (0U == elapseTimeMs) { return 0U; }
+
+	const auto prescaler{prescalers(index)};
+	const uint8_t lastIndex{static_cast<uint8_t>(prescalerCount(index) - 1U)};
+	const uint32_t maxTicks{TimerIndex::timer1 == index ? 
+		TimerParam::maxTicks16 : TimerParam::maxTicks8};
+
+	// The largest prescaler needs the fewest interrupts, use the smallest prescaler reaching 
+	// the same number of interrupts for best accuracy.
+	const uint32_t count{periodCount(ticks(elapseTimeMs, prescaler[lastIndex]), maxTicks)};
+	uint8_t i{};
+	while ((lastIndex > i) && (count < periodCount(ticks(elapseTimeMs, prescaler[i]), maxTicks))) 
+	{ 
+		++i; 
+	}
+
+	// Split the timeout into equal periods, rounded to the nearest clock cycle.
+	const uint32_t periodTicks{utils::round<uint32_t>(ticks(elapseTimeMs, prescaler[i]) / count)};
+	top         = static_cast<uint16_t>(0U < periodTicks ? periodTicks - 1U : 0U);
+	clockSelect = static_cast<uint8_t>(i + 1U);
+	return count;
+}
+
+// -----------------------------------------------------------------------------
+uint32_t Timer::Hardware::period_ms(const uint32_t periodCount) const noexcept
+{
+	if (0U == clockSelect) { return 0U; }
+	const uint16_t prescaler{prescalers(index)[clockSelect - 1U]};
+	return utils::round<uint32_t>(periodCount * (top + 1.0) * prescaler 
+		/ (TimerParam::cpuFrequencyHz / 1000.0));
+}
+
+// -----------------------------------------------------------------------------
+uint32_t Timer::Hardware::micros(const uint32_t ticks) const noexcept
+{
+	if (0U == clockSelect) { return 0U; }
+	const uint16_t prescaler{prescalers(index)[clockSelect - 1U]};
+
+	// Divide by a constant, which is cheap in interrupt context (a shift at 16 MHz).
+	return ticks * prescaler / TimerParam::cpuFrequencyMHz;
+}
+
+// -----------------------------------------------------------------------------
+uint16_t Timer::Hardware::count() const noexcept
+{
+	switch (index)
+	{
+		case TimerIndex::timer0:
+			return TCNT0;
+		case TimerIndex::timer1:
+			return TCNT1;
+		case TimerIndex::timer2:
+			return TCNT2;
+		default:
+			return 0U;
+	}
+}
+
+// -----------------------------------------------------------------------------
+void Timer::Hardware::run() noexcept
+{
+	// Restart the counter from zero with the current period, a pending match is discarded.
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		switch (index)
+		{
+			case TimerIndex::timer0:
+				TCCR0B = 0U;
+				TCNT0  = 0U;
+				OCR0A  = static_cast<uint8_t>(top);
+				TIFR0  = (1U << OCF0A);
+				TCCR0B = clockSelect;
+				break;
+			case TimerIndex::timer1:
+				TCCR1B = ControlBits::timer1;
+				TCNT1  = 0U;
+				OCR1A  = top;
+				TIFR1  = (1U << OCF1A);
+				TCCR1B = ControlBits::timer1 | clockSelect;
+				break;
+			case TimerIndex::timer2:
+				TCCR2B = 0U;
+				TCNT2  = 0U;
+				OCR2A  = static_cast<uint8_t>(top);
+				TIFR2  = (1U << OCF2A);
+				TCCR2B = clockSelect;
+				break;
+			default:
+				break;
+		}
+		counter = 0U;
+	}
+}
+
+// -----------------------------------------------------------------------------
+void Timer::Hardware::halt() noexcept
+{
+	// Stop the clock along with the interrupt, the circuit is idle while the timer is stopped.
+	*maskReg = 0U;
+
+	switch (index)
+	{
+		case TimerIndex::timer0:
+		    TCCR0B = 0U;
+			break;
+		case TimerIndex::timer1:
+		    TCCR1B = ControlBits::timer1;
+			break;
+		case TimerIndex::timer2:
+		    TCCR2B = 0U;
+			break;
+		default:
+		    break;
+	}
+}
+
+// -----------------------------------------------------------------------------
+ISR (TIMER0_COMPA_vect) { invokeCallback(TimerIndex::timer0); }
 
 // -----------------------------------------------------------------------------
 ISR (TIMER1_COMPA_vect) { invokeCallback(TimerIndex::timer1); }
 
 // -----------------------------------------------------------------------------
-ISR (TIMER2_OVF_vect) { invokeCallback(TimerIndex::timer2); }
+ISR (TIMER2_COMPA_vect) { invokeCallback(TimerIndex::timer2); }
 
 } // namespace atmega328p
 } // namespace driver
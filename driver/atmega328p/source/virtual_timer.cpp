@@ -0,0 +1,443 @@
+/**
+ * @brief Implementation details of the virtual timer driver.
+ *
+ *        The timing wheel has WheelParam::SlotCount slots, each holding a doubly linked list
+ *        of the timer nodes due in that slot. A timer due in n ticks is inserted in the slot
+ *        n ticks ahead of the current slot, along with the number of wheel revolutions to
+ *        wait before it expires. Each tick advances the current slot and only visits its list.
+ */
+#ifndef F_CPU
+#define F_CPU 16000000UL // Default CPU frequency measured in Hz.
+#endif
+
+#include <avr/interrupt.h>
+#include <util/atomic.h>
+
+#include "driver/atmega328p/timer.h"
+#include "driver/atmega328p/virtual_timer.h"
+#include "utils/utils.h"
+#include "utils/work_queue.h"
+
+namespace driver
+{
+namespace atmega328p
+{
+namespace
+{
+/**
+ * @brief Structure of timing wheel parameters.
+ */
+struct WheelParam
+{
+    /** CPU frequency in Hz. */
+    static constexpr uint32_t CpuFrequency_Hz{F_CPU};
+
+    /** Time between each tick in ms. */
+    static constexpr uint32_t Tick_ms{1U};
+
+    /** Time between each tick in us. */
+    static constexpr uint32_t Tick_us{Tick_ms * 1000UL};
+
+    /** Prescaler of Timer 2. */
+    static constexpr uint32_t Prescaler{128U};
+
+    /** Clock select bits of Timer 2 for the prescaler. */
+    static constexpr uint8_t ClockSelect{(1U << CS22) | (1U << CS20)};
+
+    /** The number of Timer 2 clock cycles per tick. */
+    static constexpr uint32_t TickCount{CpuFrequency_Hz / Prescaler / 1000UL * Tick_ms};
+
+    /** Time per Timer 2 clock cycle in us. */
+    static constexpr uint32_t MicrosPerCount{Prescaler / (CpuFrequency_Hz / 1000000UL)};
+
+    /** The number of wheel slots, must be a power of two. */
+    static constexpr uint8_t SlotCount{16U};
+
+    /** Mask for wrapping slot indexes around the wheel. */
+    static constexpr uint8_t SlotMask{SlotCount - 1U};
+
+    /** Node index used as end of list marker. */
+    static constexpr uint8_t None{VirtualTimer::MaxCount};
+};
+
+static_assert((0U < WheelParam::TickCount) && (256U >= WheelParam::TickCount),
+              "The tick must fit in the 8-bit counter of Timer 2!");
+static_assert(0U == (WheelParam::SlotCount & WheelParam::SlotMask),
+              "The number of wheel slots must be a power of two!");
+static_assert(16U >= VirtualTimer::MaxCount, "Expired nodes are collected in a 16-bit mask!");
+
+/**
+ * @brief Structure of a timer node in the timing wheel.
+ */
+struct Node
+{
+    /** Callback to invoke on timeout. */
+    void (*callback)();
+
+    /** The number of ticks per timeout, 0 if no timeout is set. */
+    uint32_t period;
+
+    /** The number of wheel revolutions left before the timer expires. */
+    uint32_t rounds;
+
+    /** The number of overrun timeouts. */
+    uint32_t overruns;
+
+    /** The worst lateness in us. */
+    uint32_t maxLateness_us;
+
+    /** Index of the next node in the slot. */
+    uint8_t next;
+
+    /** Index of the previous node in the slot. */
+    uint8_t prev;
+
+    /** Index of the slot holding the node. */
+    uint8_t slot;
+
+    /** The timer mode. */
+    VirtualTimer::Mode mode;
+
+    /** Indicate whether the node is allocated by a timer. */
+    bool used;
+
+    /** Indicate whether the node is in the wheel, i.e. the timer is running. */
+    bool linked;
+
+    /** Indicate whether the callback is deferred to the work queue. */
+    bool deferred;
+
+    /** Indicate whether the timer has timed out since the last check. */
+    volatile bool timedOut;
+};
+
+/** Pool of timer nodes. */
+Node nodes[VirtualTimer::MaxCount]{};
+
+/** Index of the first node of each slot. */
+uint8_t slots[WheelParam::SlotCount]{};
+
+/** Index of the slot of the latest tick. */
+uint8_t currentSlot{};
+
+/** The number of allocated nodes. */
+uint8_t usedCount{};
+
+/** The number of nodes in the wheel. */
+uint8_t runningCount{};
+
+// -----------------------------------------------------------------------------
+bool reserveWheel() noexcept
+{
+    if (!Timer::reserveCircuit(Timer::Circuit::Timer2)) { return false; }
+
+    for (auto& slot : slots) { slot = WheelParam::None; }
+    currentSlot = 0U;
+
+    // Run Timer 2 in CTC mode with OCR2A as top, compare match B ticks once per period.
+    // Compare match A is left to the timer driver. The clock is started by the first timer.
+    TCCR2B = 0U;
+    TCCR2A = (1U << WGM21);
+    OCR2A  = static_cast<uint8_t>(WheelParam::TickCount - 1U);
+    OCR2B  = OCR2A;
+    TIMSK2 = (1U << OCIE2B);
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+void releaseWheel() noexcept
+{
+    TIMSK2 = 0U;
+    TCCR2B = 0U;
+    TCCR2A = 0U;
+    OCR2A  = 0U;
+    OCR2B  = 0U;
+    Timer::releaseCircuit(Timer::Circuit::Timer2);
+}
+
+// -----------------------------------------------------------------------------
+uint8_t allocate(const uint32_t elapseTimeMs, void (*callback)(), const bool deferred) noexcept
+{
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        for (uint8_t i{}; i < VirtualTimer::MaxCount; ++i)
+        {
+            auto& node{nodes[i]};
+            if (node.used) { continue; }
+            if ((0U == usedCount) && !reserveWheel()) { return WheelParam::None; }
+
+            node.callback       = callback;
+            node.period         = elapseTimeMs / WheelParam::Tick_ms;
+            node.rounds         = 0U;
+            node.overruns       = 0U;
+            node.maxLateness_us = 0U;
+            node.mode           = VirtualTimer::Mode::Periodic;
+            node.used           = true;
+            node.linked         = false;
+            node.deferred       = deferred;
+            node.timedOut       = false;
+            ++usedCount;
+            return i;
+        }
+    }
+    return WheelParam::None;
+}
+
+// -----------------------------------------------------------------------------
+void insert(const uint8_t index) noexcept
+{
+    // Hash the node into the slot of its deadline, the revolutions cover the rest.
+    auto& node{nodes[index]};
+    node.slot   = static_cast<uint8_t>((currentSlot + node.period) & WheelParam::SlotMask);
+    node.rounds = (node.period - 1U) / WheelParam::SlotCount;
+    node.prev   = WheelParam::None;
+    node.next   = slots[node.slot];
+
+    if (WheelParam::None != node.next) { nodes[node.next].prev = index; }
+    slots[node.slot] = index;
+}
+
+// -----------------------------------------------------------------------------
+void remove(const uint8_t index) noexcept
+{
+    const auto& node{nodes[index]};
+    if (WheelParam::None != node.prev) { nodes[node.prev].next = node.next; }
+    else { slots[node.slot] = node.next; }
+    if (WheelParam::None != node.next) { nodes[node.next].prev = node.prev; }
+}
+
+// -----------------------------------------------------------------------------
+void link(const uint8_t index) noexcept
+{
+    auto& node{nodes[index]};
+    if (node.linked || (0U == node.period)) { return; }
+    insert(index);
+    node.linked = true;
+
+    // Start the clock from zero with the first running timer, hence its first timeout is exact.
+    if (0U == runningCount++)
+    {
+        TCNT2  = 0U;
+        TIFR2  = (1U << OCF2B);
+        TCCR2B = WheelParam::ClockSelect;
+    }
+}
+
+// -----------------------------------------------------------------------------
+void unlink(const uint8_t index) noexcept
+{
+    auto& node{nodes[index]};
+    if (!node.linked) { return; }
+    remove(index);
+    node.linked = false;
+
+    // Stop the clock while no timer is running.
+    if (0U == --runningCount) { TCCR2B = 0U; }
+}
+
+// -----------------------------------------------------------------------------
+bool isOverrun(const Node& node) noexcept
+{
+    // The previous timeout is unhandled if it wasn't checked, or its callback wasn't dispatched.
+    if (!node.callback) { return node.timedOut; }
+    return node.deferred && utils::WorkQueue::isPending(node.callback);
+}
+
+// -----------------------------------------------------------------------------
+void tick(const uint32_t lateness_us) noexcept
+{
+    currentSlot = static_cast<uint8_t>((currentSlot + 1U) & WheelParam::SlotMask);
+    uint16_t expired{};
+
+    // Collect the expired nodes first, since callbacks may start or stop any timer.
+    // A periodic node due a whole number of revolutions ahead is reinserted at the head of
+    // the current slot, hence it's not visited again in this tick.
+    for (uint8_t i{slots[currentSlot]}; WheelParam::None != i;)
+    {
+        auto& node{nodes[i]};
+        const uint8_t next{node.next};
+
+        if (0U < node.rounds) { --node.rounds; }
+        else
+        {
+            expired |= static_cast<uint16_t>(1U << i);
+            if (isOverrun(node)) { ++node.overruns; }
+            if (node.maxLateness_us < lateness_us) { node.maxLateness_us = lateness_us; }
+            node.timedOut = true;
+
+            if (VirtualTimer::Mode::Periodic == node.mode)
+            {
+                remove(i);
+                insert(i);
+            }
+            else { unlink(i); }
+        }
+        i = next;
+    }
+
+    for (uint8_t i{}; 0U != expired; ++i, expired >>= 1U)
+    {
+        if ((0U == (expired & 1U)) || !nodes[i].callback) { continue; }
+        if (nodes[i].deferred) { (void) utils::WorkQueue::post(nodes[i].callback); }
+        else { nodes[i].callback(); }
+    }
+}
+} // namespace
+
+// -----------------------------------------------------------------------------
+VirtualTimer::VirtualTimer(const uint32_t elapseTimeMs, void (*callback)(),
+                           const bool startTimer, const utils::CallbackMode callbackMode) noexcept
+    : myNode{allocate(elapseTimeMs, callback, utils::CallbackMode::Deferred == callbackMode)}
+{
+    if (startTimer) { start(); }
+}
+
+// -----------------------------------------------------------------------------
+VirtualTimer::~VirtualTimer() noexcept
+{
+    if (!isInitialized()) { return; }
+
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        unlink(myNode);
+        nodes[myNode].used     = false;
+        nodes[myNode].callback = nullptr;
+        if (0U == --usedCount) { releaseWheel(); }
+    }
+}
+
+// -----------------------------------------------------------------------------
+bool VirtualTimer::isInitialized() const noexcept { return MaxCount > myNode; }
+
+// -----------------------------------------------------------------------------
+bool VirtualTimer::isEnabled() const noexcept
+{
+    return isInitialized() && nodes[myNode].linked;
+}
+
+// -----------------------------------------------------------------------------
+bool VirtualTimer::hasTimedOut() noexcept
+{
+    if (!isInitialized()) { return false; }
+    bool timedOut{};
+
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        timedOut               = nodes[myNode].timedOut;
+        nodes[myNode].timedOut = false;
+    }
+    return timedOut;
+}
+
+// -----------------------------------------------------------------------------
+uint32_t VirtualTimer::timeout_ms() const noexcept
+{
+    return isInitialized() ? nodes[myNode].period * WheelParam::Tick_ms : 0U;
+}
+
+// -----------------------------------------------------------------------------
+void VirtualTimer::setTimeout_ms(const uint32_t timeout_ms) noexcept
+{
+    if (!isInitialized()) { return; }
+
+    // Reinsert a running timer, the new timeout is counted from now.
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        const bool running{nodes[myNode].linked};
+        unlink(myNode);
+        nodes[myNode].period = timeout_ms / WheelParam::Tick_ms;
+        if (running) { link(myNode); }
+    }
+}
+
+// -----------------------------------------------------------------------------
+void VirtualTimer::start() noexcept
+{
+    if (!isInitialized()) { return; }
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) { link(myNode); }
+    utils::globalInterruptEnable();
+}
+
+// -----------------------------------------------------------------------------
+void VirtualTimer::stop() noexcept
+{
+    if (!isInitialized()) { return; }
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) { unlink(myNode); }
+}
+
+// -----------------------------------------------------------------------------
+void VirtualTimer::toggle() noexcept
+{
+    if (isEnabled()) { stop(); }
+    else { start(); }
+}
+
+// -----------------------------------------------------------------------------
+void VirtualTimer::restart() noexcept
+{
+    if (!isInitialized()) { return; }
+
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        unlink(myNode);
+        link(myNode);
+    }
+}
+
+// -----------------------------------------------------------------------------
+VirtualTimer::Mode VirtualTimer::mode() const noexcept
+{
+    return isInitialized() ? nodes[myNode].mode : Mode::Periodic;
+}
+
+// -----------------------------------------------------------------------------
+void VirtualTimer::setMode(const Mode mode) noexcept
+{
+    if (isInitialized() && (Mode::Count > mode)) { nodes[myNode].mode = mode; }
+}
+
+// -----------------------------------------------------------------------------
+void VirtualTimer::addCallback(void (*callback)(), 
+                               const utils::CallbackMode callbackMode) const noexcept
+{
+    if (!isInitialized()) { return; }
+
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) 
+    { 
+        nodes[myNode].callback = callback; 
+        nodes[myNode].deferred = utils::CallbackMode::Deferred == callbackMode;
+    }
+}
+
+// -----------------------------------------------------------------------------
+void VirtualTimer::removeCallback() const noexcept { addCallback(nullptr); }
+
+// -----------------------------------------------------------------------------
+uint32_t VirtualTimer::overrunCount() const noexcept
+{
+    if (!isInitialized()) { return 0U; }
+    uint32_t overrunCount{};
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) { overrunCount = nodes[myNode].overruns; }
+    return overrunCount;
+}
+
+// -----------------------------------------------------------------------------
+uint32_t VirtualTimer::maxLateness_us() const noexcept
+{
+    if (!isInitialized()) { return 0U; }
+    uint32_t maxLateness_us{};
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) { maxLateness_us = nodes[myNode].maxLateness_us; }
+    return maxLateness_us;
+}
+
+// -----------------------------------------------------------------------------
+ISR (TIMER2_COMPB_vect) 
+{ 
+    // The latency is measured by the counter, which restarts every tick, hence only lateness
+    // under one tick is seen. Ticks missed while interrupts were disabled are lost.
+    const uint32_t latency_us{TCNT2 * WheelParam::MicrosPerCount};
+    tick(latency_us);
+}
+
+} // namespace atmega328p
+} // namespace driver
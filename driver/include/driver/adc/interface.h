@@ -6,14 +6,47 @@
 #include <stddef.h>
 #include <stdint.h>
 
+#include "container/array.h"
+
 namespace driver
 {
 /**
  * @brief ADC (A/D converter) interface.
+ * 
+ *        Conversions can either be made blocking via read, or asynchronously via 
+ *        startConversion, in which case the result is delivered as a sample, which is buffered 
+ *        by the conversion complete interrupt and fetched via readSample.
+ * 
+ *        Periodic conversions can be triggered by hardware via startSampling, in which case the 
+ *        sample timing doesn't depend on interrupt or software latency.
+ * 
+ *        Several channels can be converted in the background by a scan sequencer, see 
+ *        setScanRate and startScan, in which case the latest sample of each channel is cached.
+ * 
+ *        Asynchronous, periodic and scanned samples can be compared against a window by an 
+ *        analog watchdog, see setWatchdog, which only reports crossings of the window.
  */
 class AdcInterface
 {
 public:
+    /** Structure holding the result of an asynchronous conversion. */
+    struct Sample;
+
+    /** Enumeration of speed/accuracy profiles. */
+    enum class Profile : uint8_t;
+
+    /** Enumeration of analog watchdog zones. */
+    enum class Zone : uint8_t;
+
+    /** Clock used to timestamp samples. */
+    using Clock = uint32_t (*)();
+
+    /** Callback invoked in interrupt context when a sample enters another watchdog zone. */
+    using WatchdogCallback = void (*)(const uint8_t channel, const uint16_t code, const Zone zone);
+
+    /** Fixed-point duty cycle corresponding to 1.0 (Q1.15), see dutyCycleQ15. */
+    static constexpr uint16_t DutyCycleScale{0x8000U};
+
     /**
      * @brief Delete the ADC.
      */
@@ -22,33 +55,93 @@ public:
     /**
      * @brief Get the resolution of the ADC.
      * 
-     * @return The resolution of the ADC in bits.
+     * @return The effective resolution of the ADC in bits, including extra bits gained by 
+     *         oversampling.
      */
     virtual uint8_t resolution() const = 0;
 
     /**
      * @brief Get the maximal input value of the ADC.
      * 
-     * @return The maximum digital value of the ADC.
+     * @return The maximum digital value of the ADC at the effective resolution.
      */
     virtual uint16_t maxValue() const = 0;
 
     /**
      * @brief Get the supply voltage of the ADC.
      * 
-     * @return The supply voltage of the ADC in Volts.
+     * @return The calibrated supply voltage of the ADC in Volts, see calibrate.
      */
     virtual double supplyVoltage() const = 0;
 
+    /**
+     * @brief Get the supply voltage of the ADC.
+     * 
+     * @return The calibrated supply voltage of the ADC in millivolts, see calibrate.
+     */
+    virtual uint16_t supplyMillivolts() const = 0;
+
+    /**
+     * @brief Set the supply voltage of the ADC, for instance a calibration restored at startup.
+     * 
+     *        The supply voltage is used as reference of all channels except internal ones.
+     * 
+     * @param[in] supplyVoltage The supply voltage in millivolts.
+     * 
+     * @return True if the supply voltage was set, false if it's out of range.
+     */
+    virtual bool setSupplyMillivolts(const uint16_t supplyVoltage) = 0;
+
+    /**
+     * @brief Calibrate the supply voltage by measuring an internal reference against it.
+     * 
+     *        The calibration is applied to subsequent conversions to millivolts without any 
+     *        per-read cost. Call periodically, since the supply voltage may drift.
+     * 
+     * @return True if the supply voltage was calibrated, false if the ADC is disabled, the 
+     *         reference couldn't be converted or the measured supply voltage is out of range.
+     */
+    virtual bool calibrate() = 0;
+
     /**
      * @brief Read input from given analog pin.
      * 
+     *        The latest sample is returned without blocking if the pin is scanned, see startScan.
+     * 
      * @param[in] analogPin The analog pin from which to read.
      * 
      * @return The digital value corresponding to the input of the specified analog pin.
      */
     virtual uint16_t read(const uint8_t analogPin) const = 0;
 
+    /**
+     * @brief Read input from the given analog pins with a single call.
+     * 
+     *        The pins are converted back to back in the given order, scanned pins are read 
+     *        from the cache, see startScan.
+     * 
+     * @param[in] analogPins The analog pins from which to read.
+     * @param[out] values Buffer to store the digital value of each pin, at least count values.
+     * @param[in] count The number of pins to read.
+     * 
+     * @return True if all pins were read, false otherwise.
+     */
+    virtual bool read(const uint8_t* analogPins, uint16_t* values, const size_t count) const = 0;
+
+    /**
+     * @brief Read input from the given analog pins with a single call, see above.
+     * 
+     * @tparam Size The number of pins to read.
+     * 
+     * @param[in] analogPins The analog pins from which to read.
+     * @param[out] values Array to store the digital value of each pin.
+     * 
+     * @return True if all pins were read, false otherwise.
+     */
+    template <size_t Size>
+    bool read(const container::Array<uint8_t, Size>& analogPins, 
+              container::Array<uint16_t, Size>& values) const noexcept;
+
     /**
      * @brief Calculate duty cycle out of input from given analog pin.
      * 
@@ -67,6 +160,251 @@ public:
      */
     virtual double inputVoltage(const uint8_t pin) const = 0;
 
+    /**
+     * @brief Calculate fixed-point duty cycle out of input from given analog pin.
+     * 
+     *        Unlike dutyCycle, no floating point arithmetic is used.
+     * 
+     * @param[in] analogPin The analog pin from which to read.
+     * 
+     * @return The duty cycle in Q1.15 format, i.e. between 0 - DutyCycleScale.
+     */
+    virtual uint16_t dutyCycleQ15(const uint8_t analogPin) const = 0;
+
+    /**
+     * @brief Read input voltage from given analog pin.
+     * 
+     *        Unlike inputVoltage, no floating point arithmetic is used.
+     * 
+     * @param[in] analogPin The analog pin from which to read.
+     * 
+     * @return The input voltage in millivolts.
+     */
+    virtual uint16_t inputMillivolts(const uint8_t analogPin) const = 0;
+
+    /**
+     * @brief Convert a digital value of the given analog pin to millivolts.
+     * 
+     *        Use to convert samples, see readSample and readLatest. No floating point arithmetic
+     *        is used.
+     * 
+     * @param[in] analogPin The analog pin the value was read from.
+     * @param[in] code The digital value at the current resolution, see resolution().
+     * 
+     * @return The corresponding input voltage in millivolts.
+     */
+    virtual uint16_t toMillivolts(const uint8_t analogPin, const uint16_t code) const = 0;
+
+    /**
+     * @brief Start an asynchronous conversion of the input of the given analog pin.
+     * 
+     *        The function returns immediately; the result is buffered as a sample when the
+     *        conversion is complete, see readSample.
+     * 
+     * @param[in] analogPin The analog pin from which to read.
+     * 
+     * @return True if the conversion was started, false if the pin is invalid, the ADC is 
+     *         disabled or another conversion is in progress.
+     */
+    virtual bool startConversion(const uint8_t analogPin) = 0;
+
+    /**
+     * @brief Check whether a conversion is in progress.
+     * 
+     * @return True if a conversion is in progress, false otherwise.
+     */
+    virtual bool isBusy() const = 0;
+
+    /**
+     * @brief Read the oldest buffered sample, if any.
+     * 
+     *        Samples are buffered in the background, hence this function never blocks.
+     * 
+     * @param[out] sample Reference to variable to store the sample.
+     * 
+     * @return True if a sample was read, false if no sample is available.
+     */
+    virtual bool readSample(Sample& sample) = 0;
+
+    /**
+     * @brief Get the number of samples lost due to a full sample buffer.
+     * 
+     * @return The number of lost samples since startup.
+     */
+    virtual uint32_t lostSampleCount() const = 0;
+
+    /**
+     * @brief Set the clock used to timestamp samples.
+     * 
+     * @param[in] clock The clock, or nullptr to timestamp all samples with 0.
+     */
+    virtual void setClock(const Clock clock) = 0;
+
+    /**
+     * @brief Start periodic conversions of the input of the given analog pin.
+     * 
+     *        The conversions are triggered by hardware at the given sample rate; the samples 
+     *        are buffered, see readSample. Any periodic conversions in progress are stopped first.
+     *        Blocking reads and asynchronous conversions aren't possible while sampling.
+     * 
+     * @param[in] analogPin The analog pin from which to read.
+     * @param[in] sampleRate_hz The sample rate in Hz.
+     * 
+     * @return True if sampling was started, false if the pin or sample rate is invalid, the ADC 
+     *         is disabled, a conversion is in progress or no trigger source is available.
+     */
+    virtual bool startSampling(const uint8_t analogPin, const uint16_t sampleRate_hz) = 0;
+
+    /**
+     * @brief Stop periodic conversions started via startSampling.
+     */
+    virtual void stopSampling() = 0;
+
+    /**
+     * @brief Get the sample rate of periodic conversions.
+     * 
+     * @return The sample rate in Hz, or 0 if no periodic conversions are in progress.
+     */
+    virtual uint16_t sampleRate_hz() const = 0;
+
+    /**
+     * @brief Set the scan rate of the given analog pin.
+     * 
+     *        The scan rate can be changed while scanning.
+     * 
+     * @param[in] analogPin The analog pin to scan.
+     * @param[in] scanRate_hz The scan rate in Hz, or 0 to remove the pin from the scan.
+     * 
+     * @return True if the scan rate was set, false if the pin or scan rate is invalid.
+     */
+    virtual bool setScanRate(const uint8_t analogPin, const uint16_t scanRate_hz) = 0;
+
+    /**
+     * @brief Start scanning the analog pins with a non-zero scan rate in the background.
+     * 
+     *        Blocking reads of pins that aren't scanned, asynchronous and periodic conversions 
+     *        aren't possible while scanning.
+     * 
+     * @return True if scanning was started, false if the ADC is disabled, a conversion is in 
+     *         progress or no trigger source is available.
+     */
+    virtual bool startScan() = 0;
+
+    /**
+     * @brief Stop scanning started via startScan; the cached samples are discarded.
+     */
+    virtual void stopScan() = 0;
+
+    /**
+     * @brief Check whether scanning is in progress.
+     * 
+     * @return True if scanning is in progress, false otherwise.
+     */
+    virtual bool isScanning() const = 0;
+
+    /**
+     * @brief Read the latest sample of the given scanned analog pin.
+     * 
+     * @param[in] analogPin The analog pin from which to read.
+     * @param[out] sample Reference to variable to store the sample.
+     * 
+     * @return True if a sample was read, false if the pin isn't scanned or hasn't been 
+     *         converted yet.
+     */
+    virtual bool readLatest(const uint8_t analogPin, Sample& sample) const = 0;
+
+    /**
+     * @brief Set the analog watchdog of the given analog pin.
+     * 
+     *        Each asynchronous, periodic or scanned sample of the pin is compared against the 
+     *        window in the conversion complete interrupt. The watchdog callback is only invoked 
+     *        when a sample enters another zone, see setWatchdogCallback. To leave the zone below
+     *        or above the window, a sample must be inside the window by the hysteresis. The pin
+     *        starts inside the window.
+     * 
+     * @param[in] analogPin The analog pin to watch.
+     * @param[in] low The lowest digital value inside the window.
+     * @param[in] high The highest digital value inside the window.
+     * @param[in] hysteresis Hysteresis in digital values, at most half the window size.
+     * 
+     * @return True if the watchdog was set, false if the pin or the window is invalid.
+     */
+    virtual bool setWatchdog(const uint8_t analogPin, const uint16_t low, const uint16_t high,
+                             const uint16_t hysteresis) = 0;
+
+    /**
+     * @brief Remove the analog watchdog of the given analog pin.
+     * 
+     * @param[in] analogPin The analog pin to stop watching.
+     */
+    virtual void clearWatchdog(const uint8_t analogPin) = 0;
+
+    /**
+     * @brief Set the callback invoked upon analog watchdog crossings.
+     * 
+     * @param[in] callback The callback, or nullptr to disable the callback.
+     */
+    virtual void setWatchdogCallback(const WatchdogCallback callback) = 0;
+
+    /**
+     * @brief Set the number of extra bits of resolution gained by oversampling.
+     * 
+     *        4^n conversions are accumulated and decimated to one sample with n extra bits, 
+     *        which reduces the conversion rate by 4^n. The accumulation is done in the 
+     *        background for asynchronous, periodic and scanned conversions.
+     * 
+     * @param[in] extraBitCount The number of extra bits, 0 to disable oversampling.
+     * 
+     * @return True if oversampling was set, false if the number of extra bits isn't supported
+     *         or conversions are in progress.
+     */
+    virtual bool setOversampling(const uint8_t extraBitCount) = 0;
+
+    /**
+     * @brief Get the number of extra bits of resolution gained by oversampling.
+     * 
+     * @return The number of extra bits, 0 if oversampling is disabled.
+     */
+    virtual uint8_t oversampling() const = 0;
+
+    /**
+     * @brief Set the speed/accuracy profile.
+     * 
+     *        Faster profiles give a higher conversion rate at the cost of accuracy or 
+     *        resolution, see resolution().
+     * 
+     * @param[in] profile The new profile.
+     * 
+     * @return True if the profile was set, false if the profile is invalid or conversions 
+     *         are in progress.
+     */
+    virtual bool setProfile(const Profile profile) = 0;
+
+    /**
+     * @brief Get the speed/accuracy profile.
+     * 
+     * @return The current profile.
+     */
+    virtual Profile profile() const = 0;
+
+    /**
+     * @brief Set whether blocking conversions are made with the CPU asleep.
+     * 
+     *        Halting the CPU during conversions reduces digital switching noise and power, 
+     *        hence fewer oversampled conversions are needed for the same accuracy. Asynchronous,
+     *        periodic and scanned conversions don't block the CPU in the first place.
+     * 
+     * @param[in] enable Indicate whether to convert asleep.
+     */
+    virtual void setNoiseReduction(const bool enable) = 0;
+
+    /**
+     * @brief Check whether blocking conversions are made with the CPU asleep.
+     * 
+     * @return True if blocking conversions are made asleep, false otherwise.
+     */
+    virtual bool isNoiseReductionEnabled() const = 0;
+
     /**
      * @brief Check whether the ADC is initialized.
      * 
@@ -88,4 +426,49 @@ public:
      */
     virtual void setEnabled(const bool enable) = 0;
 };
+
+/**
+ * @brief Structure holding the result of an asynchronous conversion.
+ */
+struct AdcInterface::Sample
+{
+    /** The analog pin (channel) the sample was read from. */
+    uint8_t channel;
+
+    /** The digital value of the sample. */
+    uint16_t code;
+
+    /** Time when the conversion was completed, according to the clock, see setClock. */
+    uint32_t timestamp;
+};
+
+/**
+ * @brief Enumeration of speed/accuracy profiles.
+ */
+enum class AdcInterface::Profile : uint8_t
+{
+    Precise,  // Full resolution at the recommended ADC clock.
+    Balanced, // Full resolution at a faster ADC clock, with reduced accuracy.
+    Fast,     // Reduced resolution at the fastest ADC clock.
+    Count,    // The number of profiles available.
+};
+
+/**
+ * @brief Enumeration of analog watchdog zones.
+ */
+enum class AdcInterface::Zone : uint8_t
+{
+    Inside, // Inside the window.
+    Below,  // Below the window.
+    Above,  // Above the window.
+    Count,  // The number of zones available.
+};
+
+// -----------------------------------------------------------------------------
+template <size_t Size>
+bool AdcInterface::read(const container::Array<uint8_t, Size>& analogPins, 
+                        container::Array<uint16_t, Size>& values) const noexcept
+{
+    return read(analogPins.data(), values.data(), Size);
+}
 } // namespace driver
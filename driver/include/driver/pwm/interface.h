@@ -0,0 +1,94 @@
+/**
+ * @brief PWM (Pulse Width Modulation) interface.
+ */
+#pragma once
+
+#include <stdint.h>
+
+namespace driver
+{
+/**
+ * @brief PWM (Pulse Width Modulation) interface.
+ */
+class PwmInterface
+{
+public:
+    /**
+     * @brief Delete the PWM channel.
+     */
+    virtual ~PwmInterface() noexcept = default;
+
+    /**
+     * @brief Check whether the PWM channel is initialized.
+     *
+     *        An uninitialized channel indicates that the output pin or the timer circuit was
+     *        unavailable when the channel was created.
+     *
+     * @return True if the channel is initialized, false otherwise.
+     */
+    virtual bool isInitialized() const = 0;
+
+    /**
+     * @brief Check whether the PWM output is enabled.
+     *
+     * @return True if the output is enabled, false otherwise.
+     */
+    virtual bool isEnabled() const = 0;
+
+    /**
+     * @brief Enable or disable the PWM output.
+     *
+     *        The output pin is driven low while the output is disabled.
+     *
+     * @param[in] enable True to enable the output, false to disable it.
+     */
+    virtual void setEnabled(const bool enable) = 0;
+
+    /**
+     * @brief Get the PWM frequency.
+     *
+     * @return The frequency in Hz, rounded to the nearest integer.
+     */
+    virtual uint32_t frequency_hz() const = 0;
+
+    /**
+     * @brief Set the PWM frequency.
+     *
+     *        The frequency is approximated by the closest one supported by the hardware, the
+     *        duty cycle is kept.
+     *
+     * @param[in] frequency_hz The frequency in Hz.
+     *
+     * @return True if the frequency was set, false if it's out of range.
+     */
+    virtual bool setFrequency_hz(const uint32_t frequency_hz) = 0;
+
+    /**
+     * @brief Get the number of distinct duty cycles at the current frequency.
+     *
+     * @return The number of duty cycle steps from 0 % to 100 %.
+     */
+    virtual uint16_t resolution() const = 0;
+
+    /**
+     * @brief Get the duty cycle.
+     *
+     * @return The duty cycle in 16-bit resolution, where 0 is 0 % and 65535 is 100 %.
+     */
+    virtual uint16_t dutyCycle16() const = 0;
+
+    /**
+     * @brief Set the duty cycle in 8-bit resolution.
+     *
+     * @param[in] dutyCycle The duty cycle, where 0 is 0 % and 255 is 100 %.
+     */
+    virtual void setDutyCycle8(const uint8_t dutyCycle) = 0;
+
+    /**
+     * @brief Set the duty cycle in 16-bit resolution.
+     *
+     * @param[in] dutyCycle The duty cycle, where 0 is 0 % and 65535 is 100 %.
+     */
+    virtual void setDutyCycle16(const uint16_t dutyCycle) = 0;
+};
+} // namespace driver
@@ -3,17 +3,25 @@
  */
 #pragma once
 
+#include <stddef.h>
 #include <stdint.h>
-#include <stdio.h>
+
+#include "utils/format.h"
 
 namespace driver 
 {
 /**
  * @brief Serial transmission interface.
+ * 
+ *        Formatted output is written character by character via the (private) format output,
+ *        hence no intermediate buffer is used.
  */
-class SerialInterface
+class SerialInterface : private utils::format::Output
 {
 public:
+    /** Enumeration of policies for handling a full transmit buffer. */
+    enum class OverflowPolicy : uint8_t;
+
     /**
      * @brief Delete the serial device.
      */
@@ -47,11 +55,56 @@ public:
      */
     virtual void setEnabled(const bool enable) = 0;
 
+    /**
+     * @brief Get the policy used when the transmit buffer is full.
+     * 
+     * @return The overflow policy as an enumerator of enum OverflowPolicy.
+     */
+    virtual OverflowPolicy overflowPolicy() const = 0;
+
+    /**
+     * @brief Set the policy to use when the transmit buffer is full.
+     * 
+     * @param[in] policy The new overflow policy.
+     */
+    virtual void setOverflowPolicy(const OverflowPolicy policy) = 0;
+
+    /**
+     * @brief Get the number of bytes dropped due to a full transmit buffer.
+     * 
+     * @return The number of dropped bytes since startup or the last counter reset.
+     */
+    virtual uint32_t droppedByteCount() const = 0;
+
+    /**
+     * @brief Reset the counter of dropped bytes.
+     */
+    virtual void resetDroppedByteCount() = 0;
+
+    /**
+     * @brief Read the next received character, if any.
+     * 
+     *        Received characters are buffered in the background, hence this function never blocks.
+     * 
+     * @param[out] character Reference to variable to store the received character.
+     * 
+     * @return True if a character was read, false if no character has been received.
+     */
+    virtual bool read(char& character) = 0;
+
+    /**
+     * @brief Get the number of received bytes lost due to a full receive buffer or data overrun.
+     * 
+     * @return The number of lost bytes since startup.
+     */
+    virtual uint32_t lostByteCount() const = 0;
+
     /**
      * @brief Print formatted string in the serial terminal. 
      * 
      *        If the formatted string contains format specifiers, the additional arguments are 
-     *        formatted and inserted into the format string.
+     *        formatted and inserted into the format string. See utils/format.h for the 
+     *        supported format specifiers.
      *
      * @tparam Args  Parameter pack containing an arbitrary number of arguments.
      *
@@ -63,13 +116,69 @@ public:
     template <typename... Args>
     bool printf(const char* format, const Args&... args) const noexcept;
 
+    /**
+     * @brief Print formatted string in the serial terminal. 
+     * 
+     *        The format string is checked against the argument types at compile time.
+     *
+     * @tparam Chars The characters of the format string.
+     * @tparam Args  Parameter pack containing an arbitrary number of arguments.
+     *
+     * @param[in] format Format string created with the _fmt literal.
+     * @param[in] args Parameter pack containing potential additional arguments.
+     *
+     * @return True if the string was printed, false otherwise.
+     */
+    template <char... Chars, typename... Args>
+    bool printf(const utils::format::String<Chars...>& format, const Args&... args) const noexcept;
+
+    /**
+     * @brief Print formatted string stored in flash memory in the serial terminal. 
+     * 
+     *        The format string is checked against the argument types at compile time and read
+     *        from flash memory while printing, hence it doesn't occupy any RAM. Only format
+     *        strings created with the _fmt_P literal are accepted.
+     *
+     * @tparam Chars The characters of the format string.
+     * @tparam Args  Parameter pack containing an arbitrary number of arguments.
+     *
+     * @param[in] format Format string created with the _fmt_P literal.
+     * @param[in] args Parameter pack containing potential additional arguments.
+     *
+     * @return True if the string was printed, false otherwise.
+     */
+    template <char... Chars, typename... Args>
+    bool printf_P(const utils::format::ProgmemString<Chars...>& format, 
+                  const Args&... args) const noexcept;
+
+    /**
+     * @brief Write raw data, such as binary frames, without any character translation.
+     * 
+     * @param[in] data Pointer to the data to write.
+     * @param[in] size The size of the data in bytes.
+     * 
+     * @return True if the data was written, false otherwise.
+     */
+    virtual bool write(const uint8_t* data, const size_t size) const = 0;
+
 private:
     /**
-     * @brief Print the given string in the serial terminal.
+     * @brief Print the given character in the serial terminal.
      * 
-     * @param[in] str The string to print.
+     * @param[in] character The character to print.
      */
-    virtual void print(const char* str) const = 0;
+    void put(const char character) const override = 0;
+};
+
+/**
+ * @brief Enumeration of policies for handling a full transmit buffer.
+ */
+enum class SerialInterface::OverflowPolicy : uint8_t
+{
+    Block,      // Wait until there is room for the new byte (no data is lost).
+    DropNewest, // Discard the new byte.
+    DropOldest, // Discard the oldest buffered byte to make room for the new byte.
+    Count,      // The number of overflow policies available.
 };
 
 // -----------------------------------------------------------------------------
@@ -78,16 +187,30 @@ bool SerialInterface::printf(const char* format, const Args&... args) const noex
 {
     if (nullptr == format) { return false; }
 
-    // Format and insert given additional arguments (if any).
-    if (0U < sizeof...(args))
-    {
-        constexpr size_t length{101U};
-        char buffer[length]{'\0'};
-        (void) snprintf(buffer, length, format, args...);
-        print(buffer);
-    }
-    // Print the string.
-    else { print(format); }
+    // Format and insert given additional arguments (if any) while printing.
+    utils::format::print(*this, format, args...);
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+template <char... Chars, typename... Args>
+bool SerialInterface::printf(const utils::format::String<Chars...>& format, 
+                             const Args&... args) const noexcept
+{
+    // Generate a compiler error if the format string doesn't match the arguments.
+    static_assert(utils::format::isValid<Args...>(utils::format::String<Chars...>::value),
+        "Format string doesn't match the argument types!");
+    (void) format;
+    return printf(utils::format::String<Chars...>::value, args...);
+}
+
+// -----------------------------------------------------------------------------
+template <char... Chars, typename... Args>
+bool SerialInterface::printf_P(const utils::format::ProgmemString<Chars...>& format, 
+                               const Args&... args) const noexcept
+{
+    // Format and insert given additional arguments (if any) while reading the format string.
+    utils::format::print(*this, format, args...);
     return true;
 }
 } // namespace driver
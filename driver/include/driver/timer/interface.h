@@ -38,12 +38,34 @@ public:
     /**
      * @brief Check whether the timer has timed out.
      * 
-     *        The timer will restart automatically on timeout.
+     *        The timer will restart automatically on timeout. The next timeout is counted from
+     *        the previous deadline rather than from the check, hence late checks don't drift.
      *
      * @return True if the timer has timed out, false otherwise.
      */
     virtual bool hasTimedOut() = 0;
 
+    /**
+     * @brief Get the number of overrun timeouts.
+     * 
+     *        A timeout is overrun if the timer times out again before the previous timeout was 
+     *        handled, i.e. checked via hasTimedOut or, for deferred callbacks, dispatched. 
+     *        Overrun timeouts are skipped rather than delaying the following ones.
+     * 
+     * @return The number of overrun timeouts since the timer was created.
+     */
+    virtual uint32_t overrunCount() const = 0;
+
+    /**
+     * @brief Get the worst lateness of the timer.
+     * 
+     *        The lateness is the time from a deadline until the timeout is detected, such as the 
+     *        latency of the timer interrupt. 
+     * 
+     * @return The worst lateness in microseconds since the timer was created.
+     */
+    virtual uint32_t maxLateness_us() const = 0;
+
     /**
      * @brief Get the timeout of the timer.
      * 
@@ -0,0 +1,69 @@
+/**
+ * @brief Implementation details of the logger front-end.
+ *
+ * @note Don't include this header, use <logger.h> instead!
+ */
+#pragma once
+
+namespace logger
+{
+// -----------------------------------------------------------------------------
+template <Level MessageLevel, char... Chars, typename... Args>
+void Logger::log(const utils::format::ProgmemString<Chars...>& format,
+                 const Args&... args) noexcept
+{
+    static_assert(Level::Off > MessageLevel, "Invalid message level!");
+    (void) format;
+
+    // Remove messages below the minimum level at compile time.
+    if constexpr (MinLevel <= MessageLevel)
+    {
+        // Generate a compiler error if the format string doesn't match the arguments.
+        static_assert(utils::format::isValid<Args...>(utils::format::ProgmemString<Chars...>::value),
+            "Format string doesn't match the argument types!");
+
+        if constexpr (0U == sizeof...(Args))
+        {
+            write(MessageLevel, utils::format::ProgmemString<Chars...>::value, nullptr, 0U);
+        }
+        else
+        {
+            const utils::format::Argument arguments[]{utils::format::Argument{args}...};
+            write(MessageLevel, utils::format::ProgmemString<Chars...>::value, arguments,
+                  sizeof...(Args));
+        }
+    }
+}
+
+// -----------------------------------------------------------------------------
+template <char... Chars, typename... Args>
+void Logger::debug(const utils::format::ProgmemString<Chars...>& format,
+                   const Args&... args) noexcept
+{
+    log<Level::Debug>(format, args...);
+}
+
+// -----------------------------------------------------------------------------
+template <char... Chars, typename... Args>
+void Logger::info(const utils::format::ProgmemString<Chars...>& format,
+                  const Args&... args) noexcept
+{
+    log<Level::Info>(format, args...);
+}
+
+// -----------------------------------------------------------------------------
+template <char... Chars, typename... Args>
+void Logger::warning(const utils::format::ProgmemString<Chars...>& format,
+                     const Args&... args) noexcept
+{
+    log<Level::Warning>(format, args...);
+}
+
+// -----------------------------------------------------------------------------
+template <char... Chars, typename... Args>
+void Logger::error(const utils::format::ProgmemString<Chars...>& format,
+                   const Args&... args) noexcept
+{
+    log<Level::Error>(format, args...);
+}
+} // namespace logger
@@ -0,0 +1,237 @@
+/**
+ * @brief Logger front-end with compile-time levels and rate-limited sinks.
+ *
+ *        Log messages are given a level and format strings created with the _fmt_P literal:
+ *
+ *            using namespace utils::format::literals;
+ *            logger.warning("Lost %lu bytes!\n"_fmt_P, lostByteCount);
+ *
+ *        Messages below the minimum level LOGGER_MIN_LEVEL are removed at compile time, i.e.
+ *        neither the call nor the format string end up in the program. The minimum level is
+ *        given as the numeric value of logger::Level, for instance -DLOGGER_MIN_LEVEL=2 to only
+ *        keep warnings and errors. Debug messages are removed by default.
+ *
+ *        Enabled messages are formatted once and written to each registered sink, see
+ *        logger/sink/interface.h. Each sink has a minimum level that can be changed at runtime
+ *        and a message budget per level, which is restored by Logger::refill. Messages are only
+ *        formatted if at least one sink accepts them.
+ */
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "utils/format.h"
+
+#ifndef LOGGER_MIN_LEVEL
+#define LOGGER_MIN_LEVEL 1 // Minimum level of messages to keep (Info).
+#endif
+
+namespace logger
+{
+namespace sink
+{
+/** Log sink interface. */
+class Interface;
+} // namespace sink
+
+/**
+ * @brief Enumeration of log levels.
+ */
+enum class Level : uint8_t
+{
+    Debug,   // Detailed information for debugging.
+    Info,    // Status messages.
+    Warning, // Unexpected events the system recovers from.
+    Error,   // Failures.
+    Off,     // No messages (only used as minimum level).
+    Count,   // The number of log levels available.
+};
+
+/** Minimum level of messages kept at compile time. */
+constexpr Level MinLevel{static_cast<Level>(LOGGER_MIN_LEVEL)};
+
+static_assert(Level::Count > MinLevel, "Invalid minimum log level!");
+
+/**
+ * @brief Get the tag of the given log level, used to mark stored messages.
+ *
+ * @param[in] level The log level.
+ *
+ * @return The tag as a single character, e.g. 'W' for warnings.
+ */
+constexpr char tag(const Level level) noexcept
+{
+    switch (level)
+    {
+        case Level::Debug:
+            return 'D';
+        case Level::Info:
+            return 'I';
+        case Level::Warning:
+            return 'W';
+        case Level::Error:
+            return 'E';
+        default:
+            return '?';
+    }
+}
+
+/**
+ * @brief Structure holding the message budget of a sink.
+ *
+ *        The budget of each level is independent, hence chatty debug messages can't suppress
+ *        warnings and errors.
+ */
+struct RateLimit
+{
+    /** Indicator for no limit. */
+    static constexpr uint8_t Unlimited{0xFFU};
+
+    /** The maximum number of messages of each level per refill period. */
+    uint8_t maxMessageCount[static_cast<uint8_t>(Level::Off)];
+};
+
+/**
+ * @brief Logger front-end with compile-time levels and rate-limited sinks.
+ *
+ *        Messages may be logged from both the main loop and interrupt context.
+ *
+ *        This class is non-copyable and non-movable.
+ */
+class Logger final
+{
+public:
+    /** Maximum number of sinks. */
+    static constexpr uint8_t MaxSinkCount{3U};
+
+    /** Maximum length of a formatted message (longer messages are truncated). */
+    static constexpr uint8_t MaxMessageLength{48U};
+
+    /**
+     * @brief Create a new logger without sinks.
+     */
+    Logger() noexcept;
+
+    /**
+     * @brief Delete the logger.
+     */
+    ~Logger() noexcept = default;
+
+    /**
+     * @brief Add a sink.
+     *
+     * @param[in] sink The sink to add.
+     * @param[in] minLevel Minimum level of messages written to the sink.
+     * @param[in] rateLimit The message budget of the sink.
+     *
+     * @return True if the sink was added, false if the maximum number of sinks is reached.
+     */
+    bool addSink(sink::Interface& sink, const Level minLevel, const RateLimit& rateLimit) noexcept;
+
+    /**
+     * @brief Set the minimum level of messages written to the given sink.
+     *
+     * @param[in] sink The sink to update.
+     * @param[in] minLevel The new minimum level (Level::Off to disable the sink).
+     *
+     * @return True if the level was set, false if the sink hasn't been added.
+     */
+    bool setMinLevel(const sink::Interface& sink, const Level minLevel) noexcept;
+
+    /**
+     * @brief Restore the message budget of all sinks.
+     *
+     *        Call periodically, for instance from a timer callback; the rate limits are given
+     *        per refill period.
+     */
+    void refill() noexcept;
+
+    /**
+     * @brief Get the number of messages suppressed by the rate limits.
+     *
+     * @return The number of suppressed messages since startup (counted once per sink).
+     */
+    uint32_t suppressedCount() const noexcept;
+
+    /**
+     * @brief Log a message with the given level.
+     *
+     *        The format string is checked against the argument types at compile time. The call
+     *        is removed at compile time if the level is below the minimum level.
+     *
+     * @tparam MessageLevel The level of the message.
+     * @tparam Chars The characters of the format string.
+     * @tparam Args The argument types.
+     *
+     * @param[in] format Format string created with the _fmt_P literal.
+     * @param[in] args The arguments to insert in the format string.
+     */
+    template <Level MessageLevel, char... Chars, typename... Args>
+    void log(const utils::format::ProgmemString<Chars...>& format, const Args&... args) noexcept;
+
+    /**
+     * @brief Log a debug message, see Logger::log.
+     */
+    template <char... Chars, typename... Args>
+    void debug(const utils::format::ProgmemString<Chars...>& format, const Args&... args) noexcept;
+
+    /**
+     * @brief Log a status message, see Logger::log.
+     */
+    template <char... Chars, typename... Args>
+    void info(const utils::format::ProgmemString<Chars...>& format, const Args&... args) noexcept;
+
+    /**
+     * @brief Log a warning, see Logger::log.
+     */
+    template <char... Chars, typename... Args>
+    void warning(const utils::format::ProgmemString<Chars...>& format,
+                 const Args&... args) noexcept;
+
+    /**
+     * @brief Log an error, see Logger::log.
+     */
+    template <char... Chars, typename... Args>
+    void error(const utils::format::ProgmemString<Chars...>& format, const Args&... args) noexcept;
+
+    Logger(const Logger&)            = delete; // No copy constructor.
+    Logger(Logger&&)                 = delete; // No move constructor.
+    Logger& operator=(const Logger&) = delete; // No copy assignment.
+    Logger& operator=(Logger&&)      = delete; // No move assignment.
+
+private:
+    void write(const Level level, const char* format, const utils::format::Argument* args,
+               const size_t argCount) noexcept;
+    uint8_t acceptingSinks(const Level level) noexcept;
+
+    /**
+     * @brief Structure holding a sink and its state.
+     */
+    struct Entry
+    {
+        /** The sink. */
+        sink::Interface* sink;
+
+        /** Minimum level of messages written to the sink. */
+        Level minLevel;
+
+        /** The message budget of the sink. */
+        RateLimit rateLimit;
+
+        /** The remaining number of messages of each level until the next refill. */
+        uint8_t remaining[static_cast<uint8_t>(Level::Off)];
+    };
+
+    /** The registered sinks. */
+    Entry mySinks[MaxSinkCount];
+
+    /** The number of registered sinks. */
+    uint8_t mySinkCount;
+
+    /** The number of messages suppressed by the rate limits. */
+    volatile uint32_t mySuppressedCount;
+};
+} // namespace logger
+
+#include "impl/logger_impl.h"
@@ -0,0 +1,101 @@
+/**
+ * @brief Log sink storing messages in EEPROM.
+ */
+#pragma once
+
+#include "logger/sink/interface.h"
+
+namespace driver
+{
+/** EEPROM (Electrically Erasable Programmable ROM) stream interface. */
+class EepromInterface;
+} // namespace driver
+
+namespace logger
+{
+namespace sink
+{
+/**
+ * @brief Log sink storing messages in EEPROM, so that they survive a reset.
+ *
+ *        Messages are stored in a circular region, each as a level tag followed by the message
+ *        text. The end of the log is marked by an erased byte (0xFF), which is used to find the
+ *        write position again after a reset; the marker is moved before a message is written,
+ *        hence a reset while writing leaves at most one partial message. Bytes that already
+ *        hold the value to write aren't written, which saves time and wear.
+ *
+ *        Each written byte takes about 3.4 ms, hence this sink should only receive rare
+ *        messages, such as errors, with a tight rate limit.
+ *
+ *        This class is non-copyable and non-movable.
+ */
+class Eeprom final : public Interface
+{
+public:
+    /**
+     * @brief Create a new EEPROM sink.
+     *
+     * @param[in] eeprom EEPROM stream to store the messages in (must be enabled).
+     * @param[in] startAddress Start address of the log region.
+     * @param[in] size The size of the log region in bytes.
+     */
+    explicit Eeprom(driver::EepromInterface& eeprom, const uint16_t startAddress,
+                    const uint16_t size) noexcept;
+
+    /**
+     * @brief Delete the EEPROM sink.
+     */
+    ~Eeprom() noexcept override = default;
+
+    /**
+     * @brief Store a formatted message.
+     *
+     * @param[in] level The level of the message.
+     * @param[in] message The formatted message (null-terminated).
+     * @param[in] length The length of the message, excluding the null terminator.
+     */
+    void write(const Level level, const char* message, const size_t length) noexcept override;
+
+    /**
+     * @brief Read a stored character, from the oldest to the newest.
+     *
+     *        Unused space, i.e. erased bytes, is read as null characters.
+     *
+     * @param[in] index Index of the character, where index 0 is the oldest one.
+     * @param[out] character Reference to variable to store the character.
+     *
+     * @return True if a character was read, false if the index is out of range.
+     */
+    bool read(const uint16_t index, char& character) const noexcept;
+
+    /**
+     * @brief Erase all stored messages.
+     */
+    void clear() noexcept;
+
+    Eeprom()                         = delete; // No default constructor.
+    Eeprom(const Eeprom&)            = delete; // No copy constructor.
+    Eeprom(Eeprom&&)                 = delete; // No move constructor.
+    Eeprom& operator=(const Eeprom&) = delete; // No copy assignment.
+    Eeprom& operator=(Eeprom&&)      = delete; // No move assignment.
+
+private:
+    uint8_t readByte(const uint16_t offset) const noexcept;
+    void writeByte(const uint16_t offset, const uint8_t data) const noexcept;
+    void push(const char character) noexcept;
+    uint16_t findEnd() const noexcept;
+
+    /** EEPROM stream to store the messages in. */
+    driver::EepromInterface& myEeprom;
+
+    /** Start address of the log region. */
+    const uint16_t myStartAddress;
+
+    /** The size of the log region in bytes. */
+    const uint16_t mySize;
+
+    /** Offset of the end marker, i.e. where the next message is written. */
+    uint16_t myEnd;
+};
+} // namespace sink
+} // namespace logger
@@ -0,0 +1,40 @@
+/**
+ * @brief Log sink interface.
+ */
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace logger
+{
+/** Enumeration of log levels. */
+enum class Level : uint8_t;
+
+namespace sink
+{
+/**
+ * @brief Log sink interface.
+ *
+ *        Sinks receive formatted messages from the logger, see logger/logger.h. Messages may be
+ *        written from interrupt context, hence writing should be fast.
+ */
+class Interface
+{
+public:
+    /**
+     * @brief Delete the sink.
+     */
+    virtual ~Interface() noexcept = default;
+
+    /**
+     * @brief Write a formatted message.
+     *
+     * @param[in] level The level of the message.
+     * @param[in] message The formatted message (null-terminated).
+     * @param[in] length The length of the message, excluding the null terminator.
+     */
+    virtual void write(const Level level, const char* message, const size_t length) = 0;
+};
+} // namespace sink
+} // namespace logger
@@ -0,0 +1,68 @@
+/**
+ * @brief Log sink keeping the latest messages in RAM.
+ */
+#pragma once
+
+#include "container/ring_buffer.h"
+#include "logger/sink/interface.h"
+
+namespace logger
+{
+namespace sink
+{
+/**
+ * @brief Log sink keeping the latest messages in RAM.
+ *
+ *        Each message is stored as a level tag followed by the message text, see logger::tag.
+ *        The oldest characters are discarded to make room for new messages, hence the buffer
+ *        always holds the latest messages, for instance to be printed after an error.
+ *
+ *        This class is non-copyable and non-movable.
+ */
+class Ram final : public Interface
+{
+public:
+    /** The number of characters kept. */
+    static constexpr size_t Capacity{128U};
+
+    /**
+     * @brief Create a new empty RAM sink.
+     */
+    Ram() noexcept;
+
+    /**
+     * @brief Delete the RAM sink.
+     */
+    ~Ram() noexcept override = default;
+
+    /**
+     * @brief Store a formatted message.
+     *
+     * @param[in] level The level of the message.
+     * @param[in] message The formatted message (null-terminated).
+     * @param[in] length The length of the message, excluding the null terminator.
+     */
+    void write(const Level level, const char* message, const size_t length) noexcept override;
+
+    /**
+     * @brief Read and remove the oldest stored character.
+     *
+     * @param[out] character Reference to variable to store the character.
+     *
+     * @return True if a character was read, false if the buffer is empty.
+     */
+    bool read(char& character) noexcept;
+
+    Ram(const Ram&)            = delete; // No copy constructor.
+    Ram(Ram&&)                 = delete; // No move constructor.
+    Ram& operator=(const Ram&) = delete; // No copy assignment.
+    Ram& operator=(Ram&&)      = delete; // No move assignment.
+
+private:
+    void push(const char character) noexcept;
+
+    /** Buffer holding the latest characters. */
+    container::RingBuffer<char, Capacity> myBuffer;
+};
+} // namespace sink
+} // namespace logger
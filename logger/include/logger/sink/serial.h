@@ -0,0 +1,60 @@
+/**
+ * @brief Log sink writing messages to a serial device.
+ */
+#pragma once
+
+#include "logger/sink/interface.h"
+
+namespace driver
+{
+/** Serial transmission interface. */
+class SerialInterface;
+} // namespace driver
+
+namespace logger
+{
+namespace sink
+{
+/**
+ * @brief Log sink writing messages to a serial device.
+ *
+ *        Messages are printed as is, i.e. without level tag, since they're read by humans.
+ *
+ *        This class is non-copyable and non-movable.
+ */
+class Serial final : public Interface
+{
+public:
+    /**
+     * @brief Create a new serial sink.
+     *
+     * @param[in] serial Serial device to write the messages to.
+     */
+    explicit Serial(driver::SerialInterface& serial) noexcept;
+
+    /**
+     * @brief Delete the serial sink.
+     */
+    ~Serial() noexcept override = default;
+
+    /**
+     * @brief Write a formatted message to the serial device.
+     *
+     * @param[in] level The level of the message.
+     * @param[in] message The formatted message (null-terminated).
+     * @param[in] length The length of the message, excluding the null terminator.
+     */
+    void write(const Level level, const char* message, const size_t length) noexcept override;
+
+    Serial()                         = delete; // No default constructor.
+    Serial(const Serial&)            = delete; // No copy constructor.
+    Serial(Serial&&)                 = delete; // No move constructor.
+    Serial& operator=(const Serial&) = delete; // No copy assignment.
+    Serial& operator=(Serial&&)      = delete; // No move assignment.
+
+private:
+    /** Serial device to write the messages to. */
+    driver::SerialInterface& mySerial;
+};
+} // namespace sink
+} // namespace logger
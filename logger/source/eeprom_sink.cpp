@@ -0,0 +1,106 @@
+/**
+ * @brief Implementation details of the EEPROM log sink.
+ */
+#include "driver/eeprom/interface.h"
+#include "logger/logger.h"
+#include "logger/sink/eeprom.h"
+
+namespace logger
+{
+namespace sink
+{
+namespace
+{
+/**
+ * @brief Structure holding EEPROM sink parameters.
+ */
+struct EepromParam
+{
+    /** Value of erased bytes, marking the end of the log. */
+    static constexpr uint8_t Erased{0xFFU};
+
+    /** The number of bytes stored ahead of each message (level tag and space). */
+    static constexpr uint16_t TagSize{2U};
+};
+} // namespace
+
+// -----------------------------------------------------------------------------
+Eeprom::Eeprom(driver::EepromInterface& eeprom, const uint16_t startAddress,
+               const uint16_t size) noexcept
+    : myEeprom{eeprom}
+    , myStartAddress{startAddress}
+    , mySize{size}
+    , myEnd{0U}
+{
+    // Continue after the messages stored before the last reset.
+    myEnd = findEnd();
+}
+
+// -----------------------------------------------------------------------------
+void Eeprom::write(const Level level, const char* message, const size_t length) noexcept
+{
+    // Truncate messages that don't fit in the region along with the tag and the end marker.
+    const uint16_t maxLength{static_cast<uint16_t>(EepromParam::TagSize < mySize ? 
+        mySize - EepromParam::TagSize - 1U : 0U)};
+    const uint16_t count{static_cast<uint16_t>(length < maxLength ? length : maxLength)};
+    if (0U == maxLength) { return; }
+
+    // Move the end marker first, so that the log stays valid if a reset occurs while writing.
+    const uint16_t end{static_cast<uint16_t>((myEnd + EepromParam::TagSize + count) % mySize)};
+    writeByte(end, EepromParam::Erased);
+    push(tag(level));
+    push(' ');
+    for (uint16_t i{}; i < count; ++i) { push(message[i]); }
+}
+
+// -----------------------------------------------------------------------------
+bool Eeprom::read(const uint16_t index, char& character) const noexcept
+{
+    // The oldest character follows the end marker, the last byte is the marker itself.
+    if (mySize <= index + 1U) { return false; }
+    const uint8_t data{readByte(static_cast<uint16_t>((myEnd + 1U + index) % mySize))};
+    character = EepromParam::Erased == data ? '\0' : static_cast<char>(data);
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+void Eeprom::clear() noexcept
+{
+    for (uint16_t i{}; i < mySize; ++i) { writeByte(i, EepromParam::Erased); }
+    myEnd = 0U;
+}
+
+// -----------------------------------------------------------------------------
+uint8_t Eeprom::readByte(const uint16_t offset) const noexcept
+{
+    uint8_t data{EepromParam::Erased};
+    myEeprom.read(myStartAddress + offset, data);
+    return data;
+}
+
+// -----------------------------------------------------------------------------
+void Eeprom::writeByte(const uint16_t offset, const uint8_t data) const noexcept
+{
+    // Skip bytes already holding the value, writing takes several milliseconds.
+    if (data != readByte(offset)) { myEeprom.write(myStartAddress + offset, data); }
+}
+
+// -----------------------------------------------------------------------------
+void Eeprom::push(const char character) noexcept
+{
+    writeByte(myEnd, static_cast<uint8_t>(character));
+    myEnd = static_cast<uint16_t>((myEnd + 1U) % mySize);
+}
+
+// -----------------------------------------------------------------------------
+uint16_t Eeprom::findEnd() const noexcept
+{
+    // Start at the first erased byte, or at the beginning if there is none.
+    for (uint16_t i{}; i < mySize; ++i)
+    {
+        if (EepromParam::Erased == readByte(i)) { return i; }
+    }
+    return 0U;
+}
+} // namespace sink
+} // namespace logger
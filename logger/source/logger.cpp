@@ -0,0 +1,151 @@
+/**
+ * @brief Implementation details of the logger front-end.
+ */
+#include <util/atomic.h>
+
+#include "logger/logger.h"
+#include "logger/sink/interface.h"
+
+namespace logger
+{
+namespace
+{
+/**
+ * @brief Format output writing to a message buffer, truncating long messages.
+ */
+class MessageOutput final : public utils::format::Output
+{
+public:
+    explicit MessageOutput(char* buffer) noexcept
+        : myBuffer{buffer}
+        , myLength{0U}
+    {}
+
+    void put(const char character) const noexcept override
+    {
+        if (Logger::MaxMessageLength > myLength) { myBuffer[myLength++] = character; }
+    }
+
+    size_t length() const noexcept { return myLength; }
+
+private:
+    char* myBuffer;
+    mutable size_t myLength;
+};
+
+// -----------------------------------------------------------------------------
+constexpr uint8_t levelIndex(const Level level) noexcept { return static_cast<uint8_t>(level); }
+} // namespace
+
+// -----------------------------------------------------------------------------
+Logger::Logger() noexcept
+    : mySinks{}
+    , mySinkCount{0U}
+    , mySuppressedCount{0U}
+{}
+
+// -----------------------------------------------------------------------------
+bool Logger::addSink(sink::Interface& sink, const Level minLevel,
+                     const RateLimit& rateLimit) noexcept
+{
+    if (MaxSinkCount <= mySinkCount) { return false; }
+    Entry& entry{mySinks[mySinkCount]};
+    entry.sink      = &sink;
+    entry.minLevel  = minLevel;
+    entry.rateLimit = rateLimit;
+
+    for (uint8_t i{}; i < levelIndex(Level::Off); ++i)
+    {
+        entry.remaining[i] = rateLimit.maxMessageCount[i];
+    }
+
+    // Publish the sink only once it's fully initialized.
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) { ++mySinkCount; }
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+bool Logger::setMinLevel(const sink::Interface& sink, const Level minLevel) noexcept
+{
+    for (uint8_t i{}; i < mySinkCount; ++i)
+    {
+        if (&sink == mySinks[i].sink)
+        {
+            mySinks[i].minLevel = minLevel;
+            return true;
+        }
+    }
+    return false;
+}
+
+// -----------------------------------------------------------------------------
+void Logger::refill() noexcept
+{
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        for (uint8_t i{}; i < mySinkCount; ++i)
+        {
+            for (uint8_t j{}; j < levelIndex(Level::Off); ++j)
+            {
+                mySinks[i].remaining[j] = mySinks[i].rateLimit.maxMessageCount[j];
+            }
+        }
+    }
+}
+
+// -----------------------------------------------------------------------------
+uint32_t Logger::suppressedCount() const noexcept
+{
+    uint32_t count{};
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) { count = mySuppressedCount; }
+    return count;
+}
+
+// -----------------------------------------------------------------------------
+void Logger::write(const Level level, const char* format, const utils::format::Argument* args,
+                   const size_t argCount) noexcept
+{
+    // Skip formatting altogether if no sink accepts the message.
+    const uint8_t sinks{acceptingSinks(level)};
+    if (0U == sinks) { return; }
+
+    char message[MaxMessageLength + 1U]{};
+    const MessageOutput output{message};
+    utils::format::vprint_P(output, format, args, argCount);
+    message[output.length()] = '\0';
+
+    for (uint8_t i{}; i < mySinkCount; ++i)
+    {
+        if (sinks & (1U << i)) { mySinks[i].sink->write(level, message, output.length()); }
+    }
+}
+
+// -----------------------------------------------------------------------------
+uint8_t Logger::acceptingSinks(const Level level) noexcept
+{
+    uint8_t sinks{};
+
+    // Consume the budget atomically, since messages may be logged from interrupt context.
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        for (uint8_t i{}; i < mySinkCount; ++i)
+        {
+            Entry& entry{mySinks[i]};
+            uint8_t& remaining{entry.remaining[levelIndex(level)]};
+            if (entry.minLevel > level) { continue; }
+
+            if (RateLimit::Unlimited == entry.rateLimit.maxMessageCount[levelIndex(level)])
+            {
+                sinks |= (1U << i);
+            }
+            else if (0U < remaining)
+            {
+                --remaining;
+                sinks |= (1U << i);
+            }
+            else { mySuppressedCount = mySuppressedCount + 1U; }
+        }
+    }
+    return sinks;
+}
+} // namespace logger
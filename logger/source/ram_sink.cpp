@@ -0,0 +1,51 @@
+/**
+ * @brief Implementation details of the RAM log sink.
+ */
+#include <util/atomic.h>
+
+#include "logger/logger.h"
+#include "logger/sink/ram.h"
+
+namespace logger
+{
+namespace sink
+{
+// -----------------------------------------------------------------------------
+Ram::Ram() noexcept
+    : myBuffer{}
+{}
+
+// -----------------------------------------------------------------------------
+void Ram::write(const Level level, const char* message, const size_t length) noexcept
+{
+    // Messages may be written from both the main loop and interrupt context, and the oldest 
+    // characters are discarded here, hence the buffer isn't used as a single-producer queue.
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        push(tag(level));
+        push(' ');
+        for (size_t i{}; i < length; ++i) { push(message[i]); }
+    }
+}
+
+// -----------------------------------------------------------------------------
+bool Ram::read(char& character) noexcept
+{
+    bool result{false};
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) { result = myBuffer.pop(character); }
+    return result;
+}
+
+// -----------------------------------------------------------------------------
+void Ram::push(const char character) noexcept
+{
+    // Discard the oldest character to make room for the new one.
+    if (myBuffer.isFull())
+    {
+        char discarded{};
+        myBuffer.pop(discarded);
+    }
+    myBuffer.push(character);
+}
+} // namespace sink
+} // namespace logger
@@ -0,0 +1,27 @@
+/**
+ * @brief Implementation details of the serial log sink.
+ */
+#include "driver/serial/interface.h"
+#include "logger/sink/serial.h"
+#include "utils/format.h"
+
+using namespace utils::format::literals;
+
+namespace logger
+{
+namespace sink
+{
+// -----------------------------------------------------------------------------
+Serial::Serial(driver::SerialInterface& serial) noexcept
+    : mySerial{serial}
+{}
+
+// -----------------------------------------------------------------------------
+void Serial::write(const Level level, const char* message, const size_t length) noexcept
+{
+    (void) level;
+    (void) length;
+    mySerial.printf_P("%s"_fmt_P, message);
+}
+} // namespace sink
+} // namespace logger
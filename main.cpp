@@ -9,18 +9,24 @@
  *            - An EEPROM stream is used to store the LED state. On startup, this value is read;
  *              if the last stored state before power down was "on," the LED will automatically blink.
  */
+#include "benchmark/benchmark.h"
 #include "container/vector.h"
 #include "driver/atmega328p/adc.h"
 #include "driver/atmega328p/eeprom.h"
 #include "driver/atmega328p/gpio.h"
 #include "driver/atmega328p/serial.h"
-#include "driver/atmega328p/timer.h"
+#include "driver/atmega328p/timebase.h"
+#include "driver/atmega328p/virtual_timer.h"
 #include "driver/atmega328p/watchdog.h"
 #include "ml/lin_reg/lin_reg.h"
 #include "target/system.h"
+#include "utils/format.h"
+#include "utils/scheduler.h"
+#include "utils/work_queue.h"
 
 using namespace container;
 using namespace driver::atmega328p;
+using namespace utils::format::literals;
 
 namespace
 {
@@ -46,6 +52,31 @@ void debounceTimerCallback() noexcept { mySys->handleDebounceTimerInterrupt(); }
  */
 void predictTimerCallback() noexcept { mySys->handlePredictTimerInterrupt(); }
 
+/**
+ * @brief Callback for the log timer.
+ * 
+ *        This callback is invoked once per second to restore the message budget of the log sinks.
+ */
+void logTimerCallback() noexcept { mySys->handleLogTimerInterrupt(); }
+
+/**
+ * @brief Callback for the analog watchdog.
+ * 
+ *        This callback is invoked whenever a watched ADC channel crosses its window.
+ */
+void adcWatchdogCallback(const uint8_t, const uint16_t code, 
+                         const driver::AdcInterface::Zone zone) noexcept
+{
+    mySys->handleAdcWatchdog(code, zone);
+}
+
+/**
+ * @brief Callback for the work queue.
+ * 
+ *        This callback is invoked whenever an interrupt handler is deferred to the main loop.
+ */
+void workPostedCallback() noexcept { mySys->handleWorkPosted(); }
+
 constexpr int round(const double number)
 {
     // Round to the nearest integer - 2.7 is rounded to 3, 2.2 is rounded to 2, 
@@ -69,7 +100,15 @@ int main()
     auto& serial{Serial::getInstance()};
     serial.setEnabled(true);
 
-    serial.printf("Machine learning project!\n");
+    serial.printf_P("Machine learning project!\n"_fmt_P);
+
+#ifdef BENCHMARK
+    // Run the benchmarks before any timer is created, since the benchmarks use Timer 1.
+    benchmark::runFormat(serial);
+    benchmark::runAdc(serial, Adc::getInstance(), Adc::Pin::Bandgap);
+    benchmark::runTimer(serial);
+    benchmark::runWorkQueue(serial);
+#endif
 
     // Input voltage 0 - 5 V.
     const Vector<double> trainInput{0.0, 0.1, 0.2, 0.3, 0.4, 0.5, 0.6, 0.7, 0.8, 0.9, 1.0};
@@ -91,18 +130,21 @@ int main()
         const double prediction{model.predict(input)};
         const auto mV{input * 1000.0};
 
-        serial.printf("Input: %d mV, predicted output: %d!\n", round(mV), round(prediction));
+        serial.printf_P("Input: %d mV, predicted output: %.1f!\n"_fmt_P, round(mV), prediction);
     }
 
     constexpr uint8_t tempSensorPin{2U};
 
-    // Initialize the GPIO devices.
+    // Initialize the GPIO devices, the button handler is deferred to the main loop.
     Gpio led{8U, Gpio::Direction::Output};
-    Gpio button{13U, Gpio::Direction::InputPullup, buttonCallback};
+    Gpio button{13U, Gpio::Direction::InputPullup, buttonCallback, utils::CallbackMode::Deferred};
 
-    // Initialize the timers.
-    Timer debounceTimer{300U, debounceTimerCallback};
-    Timer predictTimer{6000UL, predictTimerCallback};
+    // Initialize the timers, which share Timer 2 and leave the other circuits free, such as
+    // Timer 1 for periodic ADC conversions. Only the short debounce handler runs in interrupt 
+    // context, the others are deferred to the main loop.
+    VirtualTimer debounceTimer{300U, debounceTimerCallback};
+    VirtualTimer predictTimer{6000UL, predictTimerCallback, false, utils::CallbackMode::Deferred};
+    VirtualTimer logTimer{1000UL, logTimerCallback, false, utils::CallbackMode::Deferred};
 
     // Obtain a reference to the singleton watchdog timer instance.
     auto& watchdog{Watchdog::getInstance()};
@@ -110,14 +152,32 @@ int main()
     // Obtain a reference to the singleton EEPROM instance.
     auto& eeprom{Eeprom::getInstance()};
 
+    // Enable the EEPROM before the system is created, since the stored log is read on startup.
+    eeprom.setEnabled(true);
+
     // Obtain a reference to the singleton ADC instance.
     auto& adc{Adc::getInstance()};
 
+    // Sleep during blocking conversions, such as supply voltage calibrations, to reduce noise.
+    adc.setNoiseReduction(true);
+
+    // Timestamp samples and deferred work, and schedule the system tasks, with the system 
+    // timebase, which counts on Timer 0.
+    Timebase::start();
+    adc.setClock(Timebase::micros);
+    utils::WorkQueue::setClock(Timebase::micros);
+    utils::Scheduler::setClock(Timebase::micros);
+
     // Initialize the system with the given hardware.
-    target::System system{led, button, debounceTimer, predictTimer, 
+    target::System system{led, button, debounceTimer, predictTimer, logTimer,
         serial, watchdog, eeprom, adc, model, tempSensorPin};
     mySys = &system;
 
+    // Set the watchdog callback and the work queue notifier once the system exists, since the 
+    // callbacks are forwarded to it.
+    adc.setWatchdogCallback(adcWatchdogCallback);
+    utils::WorkQueue::setNotifier(workPostedCallback);
+
     // Run the system perpetually on the target MCU.
     mySys->run();
 
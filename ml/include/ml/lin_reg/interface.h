@@ -14,6 +14,12 @@ public:
     @param[in] input The input for which to predict.
     @return The predicted value.*/
     virtual double predict(double input) const = 0;
+
+    /*@brief Train the model during the given number of epochs.
+    @param[in] epochCount The number of epochs to train.
+    @param[in] learningRate The learning rate to use.
+    @return True if the model was trained, false otherwise.*/
+    virtual bool train(unsigned int epochCount, double learningRate) = 0;
 };
 } // namespace lin_reg
 } //namespace ml
\ No newline at end of file
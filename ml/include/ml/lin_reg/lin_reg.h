@@ -27,7 +27,7 @@ public:
     double predict(double input) const override;
 
     /*trains the model in a set number of epochs with a learning rate of 1%*/
-    bool train(unsigned int epochCount, double learningRate = 0.01);
+    bool train(unsigned int epochCount, double learningRate = 0.01) override;
 
     LinReg() = delete;                          // no default-constructor
     LinReg(const LinReg&) = delete;             // no copying(constructor)
@@ -0,0 +1,54 @@
+/**
+ * @brief COBS (Consistent Overhead Byte Stuffing) encoding.
+ * 
+ *        COBS removes all zero bytes from the data at a cost of at most one byte per 254 bytes,
+ *        so that a zero byte can be used to delimit frames. A receiver can therefore always
+ *        resynchronize at the next zero byte, for instance after a lost byte.
+ */
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace protocol
+{
+namespace cobs
+{
+/** Frame delimiter, never present in encoded data. */
+constexpr uint8_t Delimiter{0x00U};
+
+/**
+ * @brief Get the maximum encoded size of data of the given size.
+ * 
+ * @param[in] size The size of the data to encode in bytes.
+ * 
+ * @return The maximum size of the encoded data in bytes (excluding delimiter).
+ */
+constexpr size_t maxEncodedSize(const size_t size) noexcept { return size + size / 254U + 1U; }
+
+/**
+ * @brief Encode the given data.
+ * 
+ * @param[in] data Pointer to the data to encode.
+ * @param[in] size The size of the data in bytes.
+ * @param[out] output Pointer to buffer of at least maxEncodedSize(size) bytes for the 
+ *                    encoded data.
+ * 
+ * @return The size of the encoded data in bytes (excluding delimiter).
+ */
+size_t encode(const uint8_t* data, const size_t size, uint8_t* output) noexcept;
+
+/**
+ * @brief Decode the given data.
+ * 
+ * @param[in] data Pointer to the data to decode (excluding delimiter).
+ * @param[in] size The size of the data in bytes.
+ * @param[out] output Pointer to buffer of at least size bytes for the decoded data.
+ * @param[out] outputSize Reference to variable to store the size of the decoded data.
+ * 
+ * @return True if the data was decoded, false if the data isn't valid COBS.
+ */
+bool decode(const uint8_t* data, const size_t size, uint8_t* output, 
+            size_t& outputSize) noexcept;
+} // namespace cobs
+} // namespace protocol
@@ -0,0 +1,39 @@
+/**
+ * @brief CRC-16 checksum calculation.
+ */
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace protocol
+{
+namespace crc16
+{
+/** Initial CRC value (CRC-16/CCITT-FALSE). */
+constexpr uint16_t InitValue{0xFFFFU};
+
+/**
+ * @brief Update the given CRC with the given byte.
+ * 
+ *        The CRC is calculated bitwise with polynomial 0x1021 (CRC-16/CCITT-FALSE), which 
+ *        requires no lookup table.
+ * 
+ * @param[in] crc The CRC to update.
+ * @param[in] byte The byte to add to the CRC.
+ * 
+ * @return The updated CRC.
+ */
+uint16_t update(uint16_t crc, const uint8_t byte) noexcept;
+
+/**
+ * @brief Calculate the CRC of the given data.
+ * 
+ * @param[in] data Pointer to the data.
+ * @param[in] size The size of the data in bytes.
+ * 
+ * @return The calculated CRC.
+ */
+uint16_t calculate(const uint8_t* data, const size_t size) noexcept;
+} // namespace crc16
+} // namespace protocol
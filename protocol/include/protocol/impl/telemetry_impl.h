@@ -0,0 +1,31 @@
+/**
+ * @brief Implementation details of binary telemetry transmission.
+ * 
+ * @note Don't include this header, use <telemetry.h> instead!
+ */
+#pragma once
+
+namespace protocol
+{
+// -----------------------------------------------------------------------------
+template <const char* Format, typename... Args>
+bool Telemetry::log(const Args&... args) noexcept
+{
+    // Generate a compiler error if the format string doesn't match the arguments.
+    static_assert(utils::format::isValid<Args...>(Format),
+        "Format string doesn't match the argument types!");
+    constexpr auto sizes{log::detail::argSizes<sizeof...(Args)>(Format)};
+    static_assert(sizes.isSupported, "Strings can't be logged as tokens!");
+    static_assert(LogMessage::MaxArgSize >= sizes.total, "Too many log message arguments!");
+
+    // Compute the token at compile time, since the format string isn't loaded on the target.
+    constexpr uint32_t token{log::token(Format)};
+
+    LogMessage message{};
+    message.token   = token;
+    message.argSize = static_cast<uint8_t>(sizes.total);
+    uint8_t* it{message.args};
+    log::detail::writeArgs(it, sizes.value, args...);
+    return send(message);
+}
+} // namespace protocol
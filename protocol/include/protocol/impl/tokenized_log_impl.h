@@ -0,0 +1,83 @@
+/**
+ * @brief Implementation details of tokenized log messages.
+ * 
+ * @note Don't include this header, use <tokenized_log.h> instead!
+ */
+#pragma once
+
+#include <string.h>
+
+namespace protocol
+{
+namespace log
+{
+namespace detail
+{
+// -----------------------------------------------------------------------------
+template <size_t Count>
+constexpr ArgSizes<Count> argSizes(const char* format) noexcept
+{
+    ArgSizes<Count> sizes{{}, 0U, true};
+    size_t index{};
+    const char* it{format};
+
+    while (*it)
+    {
+        if ('%' != *it++) { continue; }
+
+        // The format string has already been validated, hence each specifier is complete.
+        utils::format::Specifier specifier{};
+        while (*it && !specifier.parse(*it++));
+        if (('%' == specifier.conversion) || (Count <= index)) { continue; }
+
+        sizes.value[index] = argSize(specifier.conversion, specifier.isLong);
+        sizes.total += sizes.value[index];
+        if (0U == sizes.value[index++]) { sizes.isSupported = false; }
+    }
+    return sizes;
+}
+
+// -----------------------------------------------------------------------------
+inline void writeBytes(uint8_t*& it, const uint32_t value, const uint8_t size) noexcept
+{
+    for (uint8_t i{}; i < size; ++i) { *it++ = static_cast<uint8_t>(value >> (8U * i)); }
+}
+
+// -----------------------------------------------------------------------------
+template <typename T>
+void writeArg(uint8_t*& it, const uint8_t size, const T& value) noexcept
+{
+    constexpr auto type{utils::format::detail::TypeOf<T>::value};
+    static_assert((utils::format::Type::String != type) && 
+                  (utils::format::Type::FixedPoint != type),
+        "Only integers, floating point numbers and characters can be logged as tokens!");
+
+    if constexpr (utils::format::Type::Floating == type)
+    {
+        // Send the IEEE 754 representation of the number.
+        static_assert(4U == sizeof(float), "Floating point arguments are sent in single precision!");
+        const float number{static_cast<float>(value)};
+        uint32_t bits{};
+        memcpy(&bits, &number, sizeof(bits));
+        writeBytes(it, bits, size);
+    }
+    else if constexpr (utils::format::Type::Signed == type)
+    {
+        writeBytes(it, static_cast<uint32_t>(static_cast<int32_t>(value)), size);
+    }
+    else { writeBytes(it, static_cast<uint32_t>(value), size); }
+}
+
+// -----------------------------------------------------------------------------
+inline void writeArgs(uint8_t*&, const uint8_t*) noexcept {}
+
+// -----------------------------------------------------------------------------
+template <typename T, typename... Args>
+void writeArgs(uint8_t*& it, const uint8_t* sizes, const T& first, const Args&... rest) noexcept
+{
+    writeArg(it, *sizes, first);
+    writeArgs(it, sizes + 1U, rest...);
+}
+} // namespace detail
+} // namespace log
+} // namespace protocol
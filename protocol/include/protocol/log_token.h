@@ -0,0 +1,76 @@
+/**
+ * @brief Tokens and argument encoding of tokenized log messages.
+ * 
+ *        Rather than formatting text on the target, a tokenized log message consists of a token 
+ *        identifying the format string followed by the raw arguments. The token is the 32-bit 
+ *        FNV-1a hash of the format string, computed at compile time. The host reconstructs 
+ *        the text by looking up the format string in a table extracted from the ELF file.
+ * 
+ *        The arguments are encoded little-endian, with the size given by the format specifier:
+ * 
+ *            - %d, %i, %u, %x, %X:      2 bytes.
+ *            - %ld, %li, %lu, %lx, %lX: 4 bytes.
+ *            - %f:                      4 bytes (IEEE 754 single precision).
+ *            - %c:                      1 byte.
+ * 
+ * @note This header is also used by the host tools, hence it must not depend on the target.
+ */
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace protocol
+{
+namespace log
+{
+/** Name of the ELF section holding the format strings of tokenized log messages. */
+constexpr char SectionName[]{".log_strings"};
+
+/**
+ * @brief Calculate the token of the given format string.
+ * 
+ * @param[in] format The format string.
+ * 
+ * @return The token, i.e. the 32-bit FNV-1a hash of the format string.
+ */
+constexpr uint32_t token(const char* format) noexcept
+{
+    uint32_t hash{2166136261UL};
+
+    for (const char* it{format}; *it; ++it)
+    {
+        hash ^= static_cast<uint8_t>(*it);
+        hash *= 16777619UL;
+    }
+    return hash;
+}
+
+/**
+ * @brief Get the encoded size of an argument.
+ * 
+ * @param[in] conversion The conversion character of the format specifier, e.g. 'd'.
+ * @param[in] isLong Indicate whether the long length modifier was given.
+ * 
+ * @return The encoded size of the argument in bytes, or 0 if the conversion isn't supported.
+ */
+constexpr uint8_t argSize(const char conversion, const bool isLong) noexcept
+{
+    switch (conversion)
+    {
+        case 'd':
+        case 'i':
+        case 'u':
+        case 'x':
+        case 'X':
+            return isLong ? 4U : 2U;
+        case 'f':
+            return 4U;
+        case 'c':
+            return 1U;
+        default:
+            return 0U;
+    }
+}
+} // namespace log
+} // namespace protocol
@@ -0,0 +1,156 @@
+/**
+ * @brief Telemetry packets and their binary frame format.
+ * 
+ *        Each packet is sent as a frame with the following layout (multi-byte fields are 
+ *        little-endian):
+ * 
+ *            | type (1) | sequence (1) | payload (1 - 16) | CRC-16 (2) |
+ * 
+ *        The CRC is calculated over the type, sequence and payload fields. The frame is COBS 
+ *        encoded and terminated by a zero byte, see protocol/cobs.h.
+ */
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "protocol/cobs.h"
+
+namespace protocol
+{
+/** Enumeration of packet types. */
+enum class PacketType : uint8_t;
+
+/**
+ * @brief Raw ADC sample.
+ */
+struct AdcSample
+{
+    /** The analog channel the sample was read from. */
+    uint8_t channel;
+
+    /** The raw ADC code. */
+    uint16_t code;
+};
+
+/**
+ * @brief Temperature prediction.
+ */
+struct Prediction
+{
+    /** The input voltage in millivolts. */
+    uint16_t input_mV;
+
+    /** The predicted temperature in tenths of degrees Celsius. */
+    int16_t output_dC;
+};
+
+/**
+ * @brief System counters.
+ */
+struct Counters
+{
+    /** The number of temperature predictions since startup. */
+    uint32_t predictionCount;
+
+    /** The number of button presses since startup. */
+    uint32_t buttonPressCount;
+
+    /** The number of transmitted bytes dropped due to a full transmit buffer. */
+    uint32_t droppedTxByteCount;
+
+    /** The number of received bytes lost due to a full receive buffer or data overrun. */
+    uint32_t lostRxByteCount;
+};
+
+/**
+ * @brief Tokenized log message, see protocol/log_token.h.
+ */
+struct LogMessage
+{
+    /** Maximum size of the encoded arguments in bytes. */
+    static constexpr uint8_t MaxArgSize{12U};
+
+    /** Token identifying the format string. */
+    uint32_t token;
+
+    /** Size of the encoded arguments in bytes. */
+    uint8_t argSize;
+
+    /** The encoded arguments. */
+    uint8_t args[MaxArgSize];
+};
+
+/**
+ * @brief Telemetry packet.
+ */
+struct Packet
+{
+    /** The packet type, which selects the valid payload member. */
+    PacketType type;
+
+    /** Sequence number, incremented for every packet sent (used to detect lost packets). */
+    uint8_t sequence;
+
+    /** The packet payload. */
+    union
+    {
+        AdcSample adcSample;
+        Prediction prediction;
+        Counters counters;
+        LogMessage logMessage;
+    };
+};
+
+/**
+ * @brief Enumeration of packet types.
+ */
+enum class PacketType : uint8_t
+{
+    AdcSample  = 0x01U, // Raw ADC sample.
+    Prediction = 0x02U, // Temperature prediction.
+    Counters   = 0x03U, // System counters.
+    LogMessage = 0x04U, // Tokenized log message (variable size).
+};
+
+namespace packet
+{
+/** Size of the frame header (type and sequence) in bytes. */
+constexpr size_t HeaderSize{2U};
+
+/** Size of the frame CRC in bytes. */
+constexpr size_t CrcSize{2U};
+
+/** Size of the largest payload in bytes. */
+constexpr size_t MaxPayloadSize{16U};
+
+/** Size of the largest unencoded frame in bytes. */
+constexpr size_t MaxRawFrameSize{HeaderSize + MaxPayloadSize + CrcSize};
+
+/** Size of the largest encoded frame in bytes, including the delimiter. */
+constexpr size_t MaxFrameSize{cobs::maxEncodedSize(MaxRawFrameSize) + 1U};
+
+/**
+ * @brief Encode the given packet into a frame.
+ * 
+ * @param[in] packet The packet to encode.
+ * @param[out] frame Pointer to buffer of at least MaxFrameSize bytes for the frame.
+ * 
+ * @return The size of the frame in bytes including the delimiter, or 0 if the packet type
+ *         is invalid.
+ */
+size_t encode(const Packet& packet, uint8_t* frame) noexcept;
+
+/**
+ * @brief Decode the given frame into a packet.
+ * 
+ * @param[in] frame Pointer to the frame (excluding the delimiter).
+ * @param[in] size The size of the frame in bytes.
+ * @param[out] packet Reference to packet to store the decoded packet.
+ * 
+ * @return True if the frame was decoded, false if the frame is invalid (e.g. due to a CRC
+ *         mismatch or an unknown packet type).
+ */
+bool decode(const uint8_t* frame, const size_t size, Packet& packet) noexcept;
+} // namespace packet
+} // namespace protocol
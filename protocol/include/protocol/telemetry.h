@@ -0,0 +1,108 @@
+/**
+ * @brief Binary telemetry transmission over a serial device.
+ */
+#pragma once
+
+#include <stdint.h>
+
+#include "protocol/packet.h"
+#include "protocol/tokenized_log.h"
+
+namespace driver
+{
+/** Serial transmission interface. */
+class SerialInterface;
+} // namespace driver
+
+namespace protocol
+{
+/**
+ * @brief Binary telemetry transmission over a serial device.
+ * 
+ *        Packets are sent as COBS encoded frames with a CRC-16, see protocol/packet.h. Frames
+ *        are written with interrupts enabled, hence packets must only be sent from the main
+ *        loop; a frame sent from interrupt context could end up in the middle of another one.
+ * 
+ *        Log messages are sent tokenized, i.e. as a token identifying the format string and the 
+ *        raw arguments, see protocol/tokenized_log.h.
+ * 
+ *        This class is non-copyable and non-movable.
+ */
+class Telemetry final
+{
+public:
+    /**
+     * @brief Create a new telemetry transmitter.
+     * 
+     * @param[in] serial Serial device used to transmit the frames.
+     */
+    explicit Telemetry(driver::SerialInterface& serial) noexcept;
+
+    /**
+     * @brief Delete the telemetry transmitter.
+     */
+    ~Telemetry() noexcept = default;
+
+    /**
+     * @brief Send a raw ADC sample.
+     * 
+     * @param[in] sample The sample to send.
+     * 
+     * @return True if the packet was sent, false otherwise.
+     */
+    bool send(const AdcSample& sample) noexcept;
+
+    /**
+     * @brief Send a temperature prediction.
+     * 
+     * @param[in] prediction The prediction to send.
+     * 
+     * @return True if the packet was sent, false otherwise.
+     */
+    bool send(const Prediction& prediction) noexcept;
+
+    /**
+     * @brief Send system counters.
+     * 
+     * @param[in] counters The counters to send.
+     * 
+     * @return True if the packet was sent, false otherwise.
+     */
+    bool send(const Counters& counters) noexcept;
+
+    /**
+     * @brief Send a tokenized log message.
+     * 
+     *        The format string is checked against the argument types at compile time. Use the 
+     *        PROTOCOL_LOG macro rather than calling this function directly, so that the format 
+     *        string is emitted in the log section.
+     * 
+     * @tparam Format Pointer to the format string.
+     * @tparam Args The argument types.
+     * 
+     * @param[in] args The arguments to send.
+     * 
+     * @return True if the packet was sent, false otherwise.
+     */
+    template <const char* Format, typename... Args>
+    bool log(const Args&... args) noexcept;
+
+    Telemetry()                            = delete; // No default constructor.
+    Telemetry(const Telemetry&)            = delete; // No copy constructor.
+    Telemetry(Telemetry&&)                 = delete; // No move constructor.
+    Telemetry& operator=(const Telemetry&) = delete; // No copy assignment.
+    Telemetry& operator=(Telemetry&&)      = delete; // No move assignment.
+
+private:
+    bool send(const LogMessage& message) noexcept;
+    bool send(Packet& packet) noexcept;
+
+    /** Serial device used to transmit the frames. */
+    driver::SerialInterface& mySerial;
+
+    /** Sequence number of the next packet. */
+    uint8_t mySequence;
+};
+} // namespace protocol
+
+#include "impl/telemetry_impl.h"
@@ -0,0 +1,94 @@
+/**
+ * @brief Tokenized log messages, sent by protocol::Telemetry::log.
+ * 
+ *        Format strings given to the PROTOCOL_LOG macro are placed in the ELF section 
+ *        .log_strings, which isn't allocated on the target, i.e. the strings occupy neither 
+ *        flash nor RAM. Only the token of the format string and the raw arguments are sent, 
+ *        see protocol/log_token.h; the host tool extracts the format strings from the ELF file:
+ * 
+ *            PROTOCOL_LOG(telemetry, "Input: %u mV, predicted output: %.1f!\n", mV, temp);
+ * 
+ *        Integers, floating point numbers and characters can be logged, but not strings.
+ * 
+ * @note The macro must be used in non-inline, non-template functions. Variables of inline 
+ *       functions and templates are emitted in COMDAT sections, for which the section attribute 
+ *       is ignored, hence their format strings would be missing in the log section.
+ */
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "protocol/log_token.h"
+#include "utils/format.h"
+
+/**
+ * @brief Attribute placing a variable in the (non-allocated) log section.
+ * 
+ *        The section flags are given explicitly and the flags appended by the compiler are
+ *        commented out (';' starts a comment in AVR assembly), since a section can't be marked
+ *        as non-allocated via the section attribute alone.
+ */
+#ifdef __AVR__
+#define PROTOCOL_LOG_SECTION __attribute__((section(".log_strings,\"\",@progbits;"), used))
+#else
+#define PROTOCOL_LOG_SECTION __attribute__((section(".log_strings"), used))
+#endif
+
+/**
+ * @brief Send a tokenized log message via the given telemetry transmitter.
+ * 
+ *        The format string is defined at the call site, so that it's emitted in the log section, 
+ *        and checked against the argument types at compile time.
+ * 
+ * @param[in] telemetry The telemetry transmitter, see protocol::Telemetry.
+ * @param[in] format The format string (a string literal).
+ * @param[in] ... The arguments to send.
+ */
+#define PROTOCOL_LOG(telemetry, format, ...)                                                   \
+    do                                                                                          \
+    {                                                                                           \
+        static constexpr char protocolLogFormat[] PROTOCOL_LOG_SECTION{format};                 \
+        (telemetry).log<protocolLogFormat>(__VA_ARGS__);                                        \
+    } while (false)
+
+namespace protocol
+{
+namespace log
+{
+namespace detail
+{
+/**
+ * @brief Encoded sizes of the arguments of a format string.
+ * 
+ * @tparam Count The number of arguments.
+ */
+template <size_t Count>
+struct ArgSizes
+{
+    /** The encoded size of each argument (a trailing element avoids zero-sized arrays). */
+    uint8_t value[Count + 1U];
+
+    /** The total encoded size of the arguments. */
+    size_t total;
+
+    /** Indicate whether all specifiers can be encoded. */
+    bool isSupported;
+};
+
+/**
+ * @brief Get the encoded sizes of the arguments of the given format string.
+ * 
+ * @tparam Count The number of arguments.
+ * 
+ * @param[in] format The format string.
+ * 
+ * @return The encoded argument sizes.
+ */
+template <size_t Count>
+constexpr ArgSizes<Count> argSizes(const char* format) noexcept;
+} // namespace detail
+} // namespace log
+} // namespace protocol
+
+#include "impl/tokenized_log_impl.h"
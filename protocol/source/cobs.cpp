@@ -0,0 +1,72 @@
+/**
+ * @brief Implementation details of COBS (Consistent Overhead Byte Stuffing) encoding.
+ * 
+ * @note This file is also compiled by the host tools, hence it must not depend on the target.
+ */
+#include "protocol/cobs.h"
+
+namespace protocol
+{
+namespace cobs
+{
+namespace
+{
+/** Code of a block of 254 non-zero bytes not followed by a zero byte. */
+constexpr uint8_t MaxCode{0xFFU};
+} // namespace
+
+// -----------------------------------------------------------------------------
+size_t encode(const uint8_t* data, const size_t size, uint8_t* output) noexcept
+{
+    // Each block starts with a code holding the distance to the next zero byte (the code).
+    size_t codeIndex{0U};
+    size_t index{1U};
+    uint8_t code{1U};
+
+    for (size_t i{}; i < size; ++i)
+    {
+        if (Delimiter != data[i])
+        {
+            output[index++] = data[i];
+            ++code;
+        }
+
+        // Finish the block on a zero byte or when the block is full.
+        if ((Delimiter == data[i]) || (MaxCode == code))
+        {
+            output[codeIndex] = code;
+            codeIndex         = index++;
+            code              = 1U;
+        }
+    }
+    output[codeIndex] = code;
+    return index;
+}
+
+// -----------------------------------------------------------------------------
+bool decode(const uint8_t* data, const size_t size, uint8_t* output, 
+            size_t& outputSize) noexcept
+{
+    size_t index{};
+    size_t count{};
+
+    while (index < size)
+    {
+        const uint8_t code{data[index++]};
+        if (Delimiter == code) { return false; }
+
+        // Copy the block, which must not contain any zero bytes.
+        for (uint8_t i{1U}; i < code; ++i)
+        {
+            if ((index >= size) || (Delimiter == data[index])) { return false; }
+            output[count++] = data[index++];
+        }
+
+        // Restore the zero byte following the block, except at the end of the data.
+        if ((MaxCode != code) && (index < size)) { output[count++] = Delimiter; }
+    }
+    outputSize = count;
+    return true;
+}
+} // namespace cobs
+} // namespace protocol
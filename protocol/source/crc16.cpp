@@ -0,0 +1,42 @@
+/**
+ * @brief Implementation details of CRC-16 checksum calculation.
+ * 
+ * @note This file is also compiled by the host tools, hence it must not depend on the target.
+ */
+#include "protocol/crc16.h"
+
+namespace protocol
+{
+namespace crc16
+{
+namespace
+{
+/** CRC polynomial (x^16 + x^12 + x^5 + 1). */
+constexpr uint16_t Polynomial{0x1021U};
+
+/** Most significant bit of the CRC. */
+constexpr uint16_t Msb{0x8000U};
+} // namespace
+
+// -----------------------------------------------------------------------------
+uint16_t update(uint16_t crc, const uint8_t byte) noexcept
+{
+    crc ^= static_cast<uint16_t>(byte << 8U);
+
+    for (uint8_t i{}; i < 8U; ++i)
+    {
+        crc = (crc & Msb) ? static_cast<uint16_t>((crc << 1U) ^ Polynomial) 
+                          : static_cast<uint16_t>(crc << 1U);
+    }
+    return crc;
+}
+
+// -----------------------------------------------------------------------------
+uint16_t calculate(const uint8_t* data, const size_t size) noexcept
+{
+    uint16_t crc{InitValue};
+    for (size_t i{}; i < size; ++i) { crc = update(crc, data[i]); }
+    return crc;
+}
+} // namespace crc16
+} // namespace protocol
@@ -0,0 +1,186 @@
+/**
+ * @brief Implementation details of telemetry packets.
+ * 
+ * @note This file is also compiled by the host tools, hence it must not depend on the target.
+ *       Fields are serialized byte by byte, so the frame format doesn't depend on the 
+ *       endianness or the struct layout of the platform.
+ */
+#include "protocol/crc16.h"
+#include "protocol/packet.h"
+
+namespace protocol
+{
+namespace packet
+{
+namespace
+{
+/** Size of the log message token in bytes. */
+constexpr size_t TokenSize{4U};
+
+static_assert(TokenSize + LogMessage::MaxArgSize <= MaxPayloadSize, 
+    "Log messages must fit in the largest payload!");
+
+// -----------------------------------------------------------------------------
+size_t payloadSize(const PacketType type, const uint8_t logArgSize = 0U) noexcept
+{
+    switch (type)
+    {
+        case PacketType::AdcSample:
+            return 3U;
+        case PacketType::Prediction:
+            return 4U;
+        case PacketType::Counters:
+            return 16U;
+        case PacketType::LogMessage:
+            return LogMessage::MaxArgSize >= logArgSize ? TokenSize + logArgSize : 0U;
+        default:
+            return 0U;
+    }
+}
+
+// -----------------------------------------------------------------------------
+void write16(uint8_t*& it, const uint16_t value) noexcept
+{
+    *it++ = static_cast<uint8_t>(value);
+    *it++ = static_cast<uint8_t>(value >> 8U);
+}
+
+// -----------------------------------------------------------------------------
+void write32(uint8_t*& it, const uint32_t value) noexcept
+{
+    write16(it, static_cast<uint16_t>(value));
+    write16(it, static_cast<uint16_t>(value >> 16U));
+}
+
+// -----------------------------------------------------------------------------
+uint16_t read16(const uint8_t*& it) noexcept
+{
+    const uint16_t value{static_cast<uint16_t>(it[0U] | (it[1U] << 8U))};
+    it += 2U;
+    return value;
+}
+
+// -----------------------------------------------------------------------------
+uint32_t read32(const uint8_t*& it) noexcept
+{
+    const uint32_t low{read16(it)};
+    const uint32_t high{read16(it)};
+    return low | (high << 16U);
+}
+
+// -----------------------------------------------------------------------------
+void writePayload(uint8_t*& it, const Packet& packet) noexcept
+{
+    switch (packet.type)
+    {
+        case PacketType::AdcSample:
+            *it++ = packet.adcSample.channel;
+            write16(it, packet.adcSample.code);
+            break;
+        case PacketType::Prediction:
+            write16(it, packet.prediction.input_mV);
+            write16(it, static_cast<uint16_t>(packet.prediction.output_dC));
+            break;
+        case PacketType::Counters:
+            write32(it, packet.counters.predictionCount);
+            write32(it, packet.counters.buttonPressCount);
+            write32(it, packet.counters.droppedTxByteCount);
+            write32(it, packet.counters.lostRxByteCount);
+            break;
+        case PacketType::LogMessage:
+            write32(it, packet.logMessage.token);
+            for (uint8_t i{}; i < packet.logMessage.argSize; ++i) 
+            { 
+                *it++ = packet.logMessage.args[i]; 
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+// -----------------------------------------------------------------------------
+void readPayload(const uint8_t*& it, Packet& packet, const size_t size) noexcept
+{
+    switch (packet.type)
+    {
+        case PacketType::AdcSample:
+            packet.adcSample.channel = *it++;
+            packet.adcSample.code    = read16(it);
+            break;
+        case PacketType::Prediction:
+            packet.prediction.input_mV  = read16(it);
+            packet.prediction.output_dC = static_cast<int16_t>(read16(it));
+            break;
+        case PacketType::Counters:
+            packet.counters.predictionCount    = read32(it);
+            packet.counters.buttonPressCount   = read32(it);
+            packet.counters.droppedTxByteCount = read32(it);
+            packet.counters.lostRxByteCount    = read32(it);
+            break;
+        case PacketType::LogMessage:
+            packet.logMessage.token   = read32(it);
+            packet.logMessage.argSize = static_cast<uint8_t>(size - TokenSize);
+            for (uint8_t i{}; i < packet.logMessage.argSize; ++i) 
+            { 
+                packet.logMessage.args[i] = *it++; 
+            }
+            break;
+        default:
+            break;
+    }
+}
+} // namespace
+
+// -----------------------------------------------------------------------------
+size_t encode(const Packet& packet, uint8_t* frame) noexcept
+{
+    const uint8_t logArgSize{PacketType::LogMessage == packet.type ? packet.logMessage.argSize 
+                                                                    : static_cast<uint8_t>(0U)};
+    if (0U == payloadSize(packet.type, logArgSize)) { return 0U; }
+    uint8_t raw[MaxRawFrameSize]{};
+    uint8_t* it{raw};
+
+    // Serialize the header and the payload, then append the CRC of both.
+    *it++ = static_cast<uint8_t>(packet.type);
+    *it++ = packet.sequence;
+    writePayload(it, packet);
+    write16(it, crc16::calculate(raw, static_cast<size_t>(it - raw)));
+
+    // Encode the frame and terminate it with the delimiter.
+    const size_t size{cobs::encode(raw, static_cast<size_t>(it - raw), frame)};
+    frame[size] = cobs::Delimiter;
+    return size + 1U;
+}
+
+// -----------------------------------------------------------------------------
+bool decode(const uint8_t* frame, const size_t size, Packet& packet) noexcept
+{
+    if (cobs::maxEncodedSize(MaxRawFrameSize) < size) { return false; }
+    uint8_t raw[cobs::maxEncodedSize(MaxRawFrameSize)]{};
+    size_t rawSize{};
+
+    if (!cobs::decode(frame, size, raw, rawSize) || (HeaderSize + CrcSize > rawSize)) 
+    { 
+        return false; 
+    }
+
+    // Verify the CRC before interpreting the contents.
+    const uint8_t* crc{raw + rawSize - CrcSize};
+    if (crc16::calculate(raw, rawSize - CrcSize) != read16(crc)) { return false; }
+
+    // Verify that the payload size matches the packet type (log messages are of variable size).
+    const PacketType type{static_cast<PacketType>(raw[0U])};
+    const size_t dataSize{rawSize - HeaderSize - CrcSize};
+    const uint8_t logArgSize{static_cast<uint8_t>(TokenSize <= dataSize ? dataSize - TokenSize : 0U)};
+    const size_t expectedSize{payloadSize(type, logArgSize)};
+    if ((0U == expectedSize) || (expectedSize != dataSize)) { return false; }
+
+    const uint8_t* it{raw + HeaderSize};
+    packet.type     = type;
+    packet.sequence = raw[1U];
+    readPayload(it, packet, dataSize);
+    return true;
+}
+} // namespace packet
+} // namespace protocol
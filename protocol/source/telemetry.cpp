@@ -0,0 +1,64 @@
+/**
+ * @brief Implementation details of binary telemetry transmission.
+ */
+#include <util/atomic.h>
+
+#include "driver/serial/interface.h"
+#include "protocol/telemetry.h"
+
+namespace protocol
+{
+// -----------------------------------------------------------------------------
+Telemetry::Telemetry(driver::SerialInterface& serial) noexcept
+    : mySerial{serial}
+    , mySequence{0U}
+{}
+
+// -----------------------------------------------------------------------------
+bool Telemetry::send(const AdcSample& sample) noexcept
+{
+    Packet packet{};
+    packet.type      = PacketType::AdcSample;
+    packet.adcSample = sample;
+    return send(packet);
+}
+
+// -----------------------------------------------------------------------------
+bool Telemetry::send(const Prediction& prediction) noexcept
+{
+    Packet packet{};
+    packet.type       = PacketType::Prediction;
+    packet.prediction = prediction;
+    return send(packet);
+}
+
+// -----------------------------------------------------------------------------
+bool Telemetry::send(const Counters& counters) noexcept
+{
+    Packet packet{};
+    packet.type     = PacketType::Counters;
+    packet.counters = counters;
+    return send(packet);
+}
+
+// -----------------------------------------------------------------------------
+bool Telemetry::send(const LogMessage& message) noexcept
+{
+    Packet packet{};
+    packet.type       = PacketType::LogMessage;
+    packet.logMessage = message;
+    return send(packet);
+}
+
+// -----------------------------------------------------------------------------
+bool Telemetry::send(Packet& packet) noexcept
+{
+    uint8_t frame[packet::MaxFrameSize]{};
+
+    // Only assign the sequence number atomically. The frame is written with interrupts enabled,
+    // since a full transmit buffer is drained by the data register empty interrupt.
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) { packet.sequence = mySequence++; }
+    const size_t size{packet::encode(packet, frame)};
+    return (0U < size) && mySerial.write(frame, size);
+}
+} // namespace protocol
@@ -0,0 +1,141 @@
+/**
+ * @brief Line-oriented command shell for serial terminals.
+ */
+#pragma once
+
+#include <stdint.h>
+
+namespace driver
+{
+/** Serial transmission interface. */
+class SerialInterface;
+} // namespace driver
+
+namespace target
+{
+/**
+ * @brief Line-oriented command shell for serial terminals.
+ *
+ *        Received characters are echoed and collected into a command line, which is split into
+ *        space-separated words when a line ending is received. The words are stored in place,
+ *        hence no memory is allocated.
+ *
+ *        The shell is polled from the main loop and never blocks; received characters are only
+ *        buffered in interrupt context, never parsed.
+ *
+ *        This class is non-copyable and non-movable.
+ */
+class Shell final
+{
+public:
+    /** Maximum number of characters in a command line. */
+    static constexpr uint8_t MaxLineLength{32U};
+
+    /** Maximum number of words in a command line, including the command itself. */
+    static constexpr uint8_t MaxWordCount{4U};
+
+    /**
+     * @brief Create a new shell.
+     *
+     * @param[in] serial Serial device used to receive commands and print responses.
+     */
+    explicit Shell(driver::SerialInterface& serial) noexcept;
+
+    /**
+     * @brief Delete the shell.
+     */
+    ~Shell() noexcept = default;
+
+    /**
+     * @brief Process received characters without blocking.
+     *
+     *        The words of a completed command line are available until the next call.
+     *
+     * @return True if a complete command line is available, false otherwise.
+     */
+    bool poll() noexcept;
+
+    /**
+     * @brief Get the number of words in the current command line.
+     *
+     * @return The number of words, including the command itself.
+     */
+    uint8_t wordCount() const noexcept;
+
+    /**
+     * @brief Get a word of the current command line.
+     *
+     * @param[in] index Index of the word, where index 0 is the command itself.
+     *
+     * @return Pointer to the word, or nullptr if the index is out of range.
+     */
+    const char* word(const uint8_t index) const noexcept;
+
+    /**
+     * @brief Check whether the current command matches the given name.
+     *
+     * @param[in] name Pointer to the command name stored in flash memory.
+     *
+     * @return True if the command matches the given name, false otherwise.
+     */
+    bool isCommand(const char* name) const noexcept;
+
+    /**
+     * @brief Check whether a word of the current command line matches the given string.
+     *
+     * @param[in] index Index of the word, where index 0 is the command itself.
+     * @param[in] str Pointer to the string to compare with, stored in flash memory.
+     *
+     * @return True if the word matches the given string, false otherwise.
+     */
+    bool matches(const uint8_t index, const char* str) const noexcept;
+
+    /**
+     * @brief Read a word of the current command line as an unsigned integer.
+     *
+     * @param[in] index Index of the word, where index 0 is the command itself.
+     * @param[out] value Reference to variable to store the value.
+     *
+     * @return True if the word is a valid unsigned integer, false otherwise.
+     */
+    bool readUnsigned(const uint8_t index, uint32_t& value) const noexcept;
+
+    /**
+     * @brief Print the command prompt.
+     */
+    void printPrompt() const noexcept;
+
+    Shell()                        = delete; // No default constructor.
+    Shell(const Shell&)            = delete; // No copy constructor.
+    Shell(Shell&&)                 = delete; // No move constructor.
+    Shell& operator=(const Shell&) = delete; // No copy assignment.
+    Shell& operator=(Shell&&)      = delete; // No move assignment.
+
+private:
+    void clearLine() noexcept;
+    bool completeLine() noexcept;
+    void addCharacter(const char character) noexcept;
+    void removeCharacter() noexcept;
+
+    /** Serial device used to receive commands and print responses. */
+    driver::SerialInterface& mySerial;
+
+    /** The current command line (null-terminated). */
+    char myLine[MaxLineLength + 1U];
+
+    /** Pointers to the words of the current command line. */
+    const char* myWords[MaxWordCount];
+
+    /** The number of characters in the current command line. */
+    uint8_t myLength;
+
+    /** The number of words in the current command line. */
+    uint8_t myWordCount;
+
+    /** Indicate whether the current command line is too long. */
+    bool myOverflow;
+
+    /** Indicate whether the current command line is complete. */
+    bool myComplete;
+};
+} // namespace target
@@ -3,12 +3,20 @@
  */
 #pragma once
 
+#include <stdint.h>
+
+#include "driver/adc/interface.h"
+#include "logger/logger.h"
+#include "logger/sink/eeprom.h"
+#include "logger/sink/ram.h"
+#include "logger/sink/serial.h"
+#include "protocol/telemetry.h"
+#include "target/shell.h"
+#include "utils/scheduler.h"
+
 namespace driver
 {
-/** ADC (A/D converter) interface. */
-class AdcInterface;
-
-/** EEPROM (Electrically Erasable Programmable ROM) stream interface. */
+/** EEPROM(Electrically Erasable Programmable ROM) stream interface. */
 class EepromInterface;
 
 /** GPIO interface. */
@@ -50,11 +58,23 @@ namespace target
  *
  *            - The LED state is written to EEPROM upon every change. This value is evaluated upon startup.
  * 
+ *            - The ADC supply voltage is calibrated once per minute and stored in EEPROM, hence
+ *              the calibration is restored upon startup without measuring.
+ * 
+ *            - An analog watchdog can be set on the temperature sensor, in which case only 
+ *              crossings of the watchdog window are predicted.
+ * 
+ *            - A command shell on the serial port is used to change the behavior at runtime,
+ *              type 'help' in the serial terminal for a list of commands.
+ * 
  *        This class is non-copyable and non-movable.
  */
 class System final
 {
 public:
+    /** Enumeration of output modes for status messages. */
+    enum class OutputMode : uint8_t;
+
     /**
      * @brief Create a new system.
      *     
@@ -62,6 +82,7 @@ public:
      * @param[in] button Button used to toggle the toggle timer.
      * @param[in] debounceTimer Timer used to mitigate effects of contact bounces.
      * @param[in] predictTimer Timer used to toggle the LED.
+     * @param[in] logTimer Timer used to restore the message budget of the log sinks.
      * @param[in] serial Serial device used to print status messages.
      * @param[in] watchdog Watchdog timer that resets the program if it becomes unresponsive.
      * @param[in] eeprom EEPROM stream to write the status of the LED to EEPROM.
@@ -71,9 +92,10 @@ public:
      */
     explicit System(driver::GpioInterface& led, driver::GpioInterface& button, 
                     driver::TimerInterface& debounceTimer, driver::TimerInterface& predictTimer,
-                    driver::SerialInterface& serial, driver::WatchdogInterface& watchdog, 
-                    driver::EepromInterface& eeprom, driver::AdcInterface& adc,
-                    ml::lin_reg::Interface& model, const uint8_t tempSensorPin) noexcept;
+                    driver::TimerInterface& logTimer, driver::SerialInterface& serial,
+                    driver::WatchdogInterface& watchdog, driver::EepromInterface& eeprom,
+                    driver::AdcInterface& adc, ml::lin_reg::Interface& model,
+                    const uint8_t tempSensorPin) noexcept;
 
     /**
      * @brief Delete system.
@@ -93,7 +115,8 @@ public:
      *        Toggle the timer whenever the button is pressed. 
      * 
      *        Pin change interrupts are disabled for 300 ms after a press to mitigate the effects 
-     *        of contact bounce.
+     *        of contact bounce. The handler may be deferred to the main loop, see 
+     *        utils::WorkQueue, in which case bounces posted meanwhile are ignored.
      */
     void handleButtonInterrupt() noexcept;
 
@@ -111,8 +134,39 @@ public:
      */
     void handlePredictTimerInterrupt() noexcept;
 
+    /**
+     * @brief Log timer interrupt handler.
+     * 
+     *        Restore the message budget of the log sinks once per period and warn about lost 
+     *        received bytes.
+     */
+    void handleLogTimerInterrupt() noexcept;
+
+    /**
+     * @brief Analog watchdog handler, invoked in interrupt context.
+     * 
+     *        Predict the temperature in the main loop when the temperature sensor crosses the 
+     *        watchdog window, see the 'watch' command.
+     * 
+     * @param[in] code The digital value of the sample that crossed the window.
+     * @param[in] zone The zone entered.
+     */
+    void handleAdcWatchdog(const uint16_t code, const driver::AdcInterface::Zone zone) noexcept;
+
+    /**
+     * @brief Work posted handler, invoked in interrupt context.
+     * 
+     *        Signal the task running the interrupt handlers deferred to the main loop, see 
+     *        utils::WorkQueue::setNotifier.
+     */
+    void handleWorkPosted() noexcept;
+
     /**
      * @brief Run the system as long as voltage is supplied.                                                               
+     * 
+     *        Commands received via the serial port and deferred interrupt handlers are handled 
+     *        by tasks of the cooperative scheduler, see utils::Scheduler. The CPU sleeps while
+     *        no task is ready.
      */
     void run() noexcept;
 
@@ -123,8 +177,40 @@ public:
     System& operator=(System&&)      = delete; // No move assignment.
 
 private:
+    /** Enumeration of system tasks. */
+    enum class Task : uint8_t;
+
+    /** The number of system tasks, see System::Task. */
+    static constexpr uint8_t TaskCount{7U};
+
+    void addTasks() noexcept;
+    void addTask(const Task task, const utils::Scheduler::Task function, const uint8_t priority, 
+                 const uint16_t period_ms = 0U) noexcept;
+    void signal(const Task task) const noexcept;
+    void handleSamples() noexcept;
+    void handlePredictionRequest() noexcept;
+    void pollShell() noexcept;
     void handleButtonPressed() noexcept;
-    void predictTemperature() const noexcept;
+    void requestPrediction() noexcept;
+    void predictTemperature(const uint16_t adcValue) noexcept;
+    void handleExcursion() noexcept;
+    void restoreCalibration() noexcept;
+    bool calibrateSupply() noexcept;
+    void handleCommand() noexcept;
+    void printHelp() const noexcept;
+    void printStatistics() noexcept;
+    void handlePeriodCommand() noexcept;
+    void handleTrainCommand() noexcept;
+    void handleOutputCommand() noexcept;
+    void handleLogCommand() noexcept;
+    void handleSampleCommand() noexcept;
+    void handleScanCommand() noexcept;
+    void handleOversampleCommand() noexcept;
+    void handleProfileCommand() noexcept;
+    void handleCalibrateCommand() noexcept;
+    void handleWatchCommand() noexcept;
+    void handleReadCommand() noexcept;
+    void handleTasksCommand() noexcept;
 
     /** Reference to the LED to toggle. */
     driver::GpioInterface& myLed;
@@ -138,6 +224,9 @@ private:
     /** Timer used to toggle the LED. */
     driver::TimerInterface& myPredictTimer;
 
+    /** Timer used to restore the message budget of the log sinks. */
+    driver::TimerInterface& myLogTimer;
+
     /** Serial device used to print status messages. */
     driver::SerialInterface& mySerial;
 
@@ -155,5 +244,80 @@ private:
 
     /** Temperature sensor pin. */
     const uint8_t myTempSensorPin;
+
+    /** Command shell for changing the behavior at runtime. */
+    Shell myShell;
+
+    /** The number of temperature predictions since startup. */
+    volatile uint32_t myPredictionCount;
+
+    /** The number of button presses since startup. */
+    volatile uint32_t myButtonPressCount;
+
+    /** Binary telemetry transmitter, used in binary and tokenized output modes. */
+    protocol::Telemetry myTelemetry;
+
+    /** Output mode of status messages, such as predictions. */
+    volatile OutputMode myOutputMode;
+
+    /** Log sink printing messages in the serial terminal. */
+    logger::sink::Serial mySerialLog;
+
+    /** Log sink keeping the latest messages in RAM. */
+    logger::sink::Ram myRamLog;
+
+    /** Log sink storing warnings and errors in EEPROM. */
+    logger::sink::Eeprom myEepromLog;
+
+    /** Logger for status messages and diagnostics. */
+    logger::Logger myLogger;
+
+    /** The number of lost received bytes at the last check. */
+    uint32_t myLostByteCount;
+
+    /** The number of log timer periods until the next supply voltage calibration. */
+    uint8_t myCalibrationCountdown;
+
+    /** The supply voltage stored in EEPROM in millivolts (0 if none). */
+    uint16_t myStoredSupplyVoltage;
+
+    /** Indicate whether the temperature sensor is watched, i.e. only crossings are predicted. */
+    bool myWatching;
+
+    /** The digital value of the latest crossing. */
+    volatile uint16_t myExcursionCode;
+
+    /** The zone entered by the latest crossing. */
+    volatile driver::AdcInterface::Zone myExcursionZone;
+
+    /** Scheduler identifiers of the system tasks. */
+    uint8_t myTasks[TaskCount];
+};
+
+/**
+ * @brief Enumeration of output modes for status messages.
+ */
+enum class System::OutputMode : uint8_t
+{
+    Off,       // No status messages.
+    Text,      // Status messages as human-readable text.
+    Binary,    // Status messages as binary telemetry frames, see protocol/packet.h.
+    Tokenized, // Status messages as tokenized log frames, see protocol/tokenized_log.h.
+    Count,     // The number of output modes available.
+};
+
+/**
+ * @brief Enumeration of system tasks, in order of the task list printed by the 'tasks' command.
+ */
+enum class System::Task : uint8_t
+{
+    Dispatch,    // Run the interrupt handlers deferred to the main loop.
+    Excursion,   // Handle analog watchdog crossings.
+    Samples,     // Handle completed conversions.
+    Prediction,  // Predict from the latest scanned sample.
+    Shell,       // Handle received commands.
+    Calibration, // Calibrate the supply voltage.
+    Watchdog,    // Reset the watchdog timer.
+    Count,       // The number of system tasks.
 };
 } // namespace target
\ No newline at end of file
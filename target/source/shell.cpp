@@ -0,0 +1,207 @@
+/**
+ * @brief Implementation details of line-oriented command shell.
+ */
+#include <avr/pgmspace.h>
+
+#include "driver/serial/interface.h"
+#include "target/shell.h"
+#include "utils/format.h"
+
+using namespace utils::format::literals;
+
+namespace target
+{
+namespace
+{
+/**
+ * @brief Structure holding shell parameters.
+ */
+struct ShellParam
+{
+    /** Carriage return character. */
+    static constexpr char CarriageReturn{'\r'};
+
+    /** New line character. */
+    static constexpr char NewLine{'\n'};
+
+    /** Backspace character. */
+    static constexpr char Backspace{'\b'};
+
+    /** Delete character (sent as backspace by many terminals). */
+    static constexpr char Delete{0x7F};
+
+    /** Word separator. */
+    static constexpr char Separator{' '};
+};
+
+// -----------------------------------------------------------------------------
+constexpr bool isLineEnding(const char character) noexcept
+{
+    return (ShellParam::CarriageReturn == character) || (ShellParam::NewLine == character);
+}
+
+// -----------------------------------------------------------------------------
+constexpr bool isBackspace(const char character) noexcept
+{
+    return (ShellParam::Backspace == character) || (ShellParam::Delete == character);
+}
+
+// -----------------------------------------------------------------------------
+constexpr bool isPrintable(const char character) noexcept
+{
+    return (' ' <= character) && (ShellParam::Delete > character);
+}
+} // namespace
+
+// -----------------------------------------------------------------------------
+Shell::Shell(driver::SerialInterface& serial) noexcept
+    : mySerial{serial}
+    , myLine{}
+    , myWords{}
+    , myLength{0U}
+    , myWordCount{0U}
+    , myOverflow{false}
+    , myComplete{false}
+{}
+
+// -----------------------------------------------------------------------------
+bool Shell::poll() noexcept
+{
+    // Start a new command line if the previous one has been handled.
+    if (myComplete) { clearLine(); }
+    char character{};
+
+    // Process received characters until a command line is complete or no characters remain.
+    while (mySerial.read(character))
+    {
+        if (isLineEnding(character))
+        {
+            if (completeLine()) { return true; }
+        }
+        else if (isBackspace(character)) { removeCharacter(); }
+        else if (isPrintable(character)) { addCharacter(character); }
+    }
+    return false;
+}
+
+// -----------------------------------------------------------------------------
+uint8_t Shell::wordCount() const noexcept { return myWordCount; }
+
+// -----------------------------------------------------------------------------
+const char* Shell::word(const uint8_t index) const noexcept
+{
+    return index < myWordCount ? myWords[index] : nullptr;
+}
+
+// -----------------------------------------------------------------------------
+bool Shell::isCommand(const char* name) const noexcept { return matches(0U, name); }
+
+// -----------------------------------------------------------------------------
+bool Shell::matches(const uint8_t index, const char* str) const noexcept
+{
+    return (index < myWordCount) && (0 == strcmp_P(myWords[index], str));
+}
+
+// -----------------------------------------------------------------------------
+bool Shell::readUnsigned(const uint8_t index, uint32_t& value) const noexcept
+{
+    const char* str{word(index)};
+    if (nullptr == str) { return false; }
+    uint32_t result{};
+
+    for (const char* it{str}; *it; ++it)
+    {
+        if (('0' > *it) || ('9' < *it)) { return false; }
+        const uint8_t digit{static_cast<uint8_t>(*it - '0')};
+
+        // Reject values that don't fit in 32 bits.
+        if (result > (UINT32_MAX - digit) / 10U) { return false; }
+        result = result * 10U + digit;
+    }
+    value = result;
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+void Shell::printPrompt() const noexcept { mySerial.printf_P("> "_fmt_P); }
+
+// -----------------------------------------------------------------------------
+void Shell::clearLine() noexcept
+{
+    myLength    = 0U;
+    myWordCount = 0U;
+    myOverflow  = false;
+    myComplete  = false;
+}
+
+// -----------------------------------------------------------------------------
+bool Shell::completeLine() noexcept
+{
+    // Ignore empty lines, such as the new line following a carriage return.
+    if ((0U == myLength) && !myOverflow) { return false; }
+    mySerial.printf_P("\n"_fmt_P);
+
+    if (myOverflow)
+    {
+        mySerial.printf_P("Command line too long (max %u characters)!\n"_fmt_P, MaxLineLength);
+        clearLine();
+        printPrompt();
+        return false;
+    }
+
+    // Split the command line into words in place by terminating each word.
+    myLine[myLength] = '\0';
+
+    for (uint8_t i{}; i < myLength; ++i)
+    {
+        if (ShellParam::Separator == myLine[i])
+        {
+            myLine[i] = '\0';
+        }
+        else if ((0U == i) || ('\0' == myLine[i - 1U]))
+        {
+            if (MaxWordCount <= myWordCount)
+            {
+                mySerial.printf_P("Too many arguments (max %u)!\n"_fmt_P, MaxWordCount - 1U);
+                clearLine();
+                printPrompt();
+                return false;
+            }
+            myWords[myWordCount++] = &myLine[i];
+        }
+    }
+
+    // Lines consisting of separators only are ignored.
+    if (0U == myWordCount)
+    {
+        clearLine();
+        printPrompt();
+        return false;
+    }
+    myComplete = true;
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+void Shell::addCharacter(const char character) noexcept
+{
+    // Keep reading until the line ending if the line is too long, then discard it.
+    if (MaxLineLength <= myLength)
+    {
+        myOverflow = true;
+        return;
+    }
+    myLine[myLength++] = character;
+    mySerial.printf_P("%c"_fmt_P, character);
+}
+
+// -----------------------------------------------------------------------------
+void Shell::removeCharacter() noexcept
+{
+    if ((0U == myLength) || myOverflow) { return; }
+    --myLength;
+
+    // Erase the last character in the terminal.
+    mySerial.printf_P("\b \b"_fmt_P);
+}
+} // namespace target
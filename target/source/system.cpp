@@ -2,6 +2,8 @@
  * @brief Generic system implementation details for an MCU with configurable hardware devices.
  */
 #include <stdint.h>
+#include <avr/pgmspace.h>
+#include <util/atomic.h>
 
 #include "driver/adc/interface.h"
 #include "driver/eeprom/interface.h"
@@ -9,42 +11,282 @@
 #include "driver/serial/interface.h"
 #include "driver/timer/interface.h"
 #include "driver/watchdog/interface.h"
+#include "logger/logger.h"
 #include "ml/lin_reg/interface.h"
 #include "target/system.h"
+#include "utils/format.h"
+#include "utils/scheduler.h"
+#include "utils/work_queue.h"
+
+using namespace utils::format::literals;
 
 namespace target
 {
 namespace
 {
+/**
+ * @brief Structure holding system parameters.
+ */
+struct SystemParam
+{
+    /** The number of epochs to train if no epoch count is given. */
+    static constexpr uint32_t DefaultEpochCount{2000U};
+
+    /** The maximum number of epochs to train per command. */
+    static constexpr uint32_t MaxEpochCount{100000U};
+
+    /** The number of epochs to train between watchdog timer resets. */
+    static constexpr uint32_t EpochsPerWatchdogReset{100U};
+
+    /** Learning rate used for training. */
+    static constexpr double LearningRate{0.1};
+
+    /** Scale factor for predictions sent as telemetry (tenths of degrees). */
+    static constexpr double TelemetryScale{10.0};
+
+    /** Factor to convert millivolts to the model input in Volts (avoids a division). */
+    static constexpr double VoltsPerMillivolt{0.001};
+
+    /** Start address of the log region in EEPROM. */
+    static constexpr uint16_t EepromLogAddress{768U};
+
+    /** The size of the log region in EEPROM in bytes. */
+    static constexpr uint16_t EepromLogSize{255U};
+
+    /** Address of the supply voltage calibration in EEPROM (4 bytes below the log region). */
+    static constexpr uint16_t EepromCalibrationAddress{764U};
+
+    /** The number of log timer periods between supply voltage calibrations. */
+    static constexpr uint8_t CalibrationPeriod{60U};
+
+    /** Minimum change of the supply voltage in mV to store, limits EEPROM wear. */
+    static constexpr uint16_t MinCalibrationChange_mV{10U};
+
+    /** Analog watchdog hysteresis in ADC codes if none is given. */
+    static constexpr uint16_t DefaultWatchdogHysteresis{4U};
+
+    /** Message budget of the serial log per log timer period (debug, info, warning, error). */
+    static constexpr logger::RateLimit SerialLogLimit{{4U, 8U, 4U, logger::RateLimit::Unlimited}};
+
+    /** Message budget of the RAM log per log timer period (debug, info, warning, error). */
+    static constexpr logger::RateLimit RamLogLimit{{8U, 8U, 8U, logger::RateLimit::Unlimited}};
+
+    /** Message budget of the EEPROM log per log timer period (debug, info, warning, error). */
+    static constexpr logger::RateLimit EepromLogLimit{{0U, 0U, 1U, 2U}};
+};
+
+/**
+ * @brief Structure holding task parameters.
+ */
+struct TaskParam
+{
+    /** Priority of tasks handling interrupts, which run first. */
+    static constexpr uint8_t InterruptPriority{3U};
+
+    /** Priority of tasks handling samples and predictions. */
+    static constexpr uint8_t SamplePriority{2U};
+
+    /** Priority of tasks handling commands and calibrations, which may block. */
+    static constexpr uint8_t CommandPriority{1U};
+
+    /** Priority of the watchdog task, which runs last. */
+    static constexpr uint8_t WatchdogPriority{0U};
+
+    /** Period for polling completed conversions in ms, the ADC buffers 8 samples. */
+    static constexpr uint16_t SamplePeriod_ms{1U};
+
+    /** Period for polling received commands in ms, the serial port buffers 32 bytes. */
+    static constexpr uint16_t ShellPeriod_ms{10U};
+
+    /** Period for resetting the watchdog timer in ms, well below its timeout. */
+    static constexpr uint16_t WatchdogPeriod_ms{100U};
+};
+
+/**
+ * @brief Structure holding task names, stored in flash memory.
+ */
+struct TaskName
+{
+    /** Name of the task running deferred interrupt handlers. */
+    static constexpr char Dispatch[] PROGMEM{"dispatch"};
+
+    /** Name of the task handling analog watchdog crossings. */
+    static constexpr char Excursion[] PROGMEM{"excursion"};
+
+    /** Name of the task handling completed conversions. */
+    static constexpr char Samples[] PROGMEM{"samples"};
+
+    /** Name of the task predicting from the latest scanned sample. */
+    static constexpr char Prediction[] PROGMEM{"prediction"};
+
+    /** Name of the task handling received commands. */
+    static constexpr char Shell[] PROGMEM{"shell"};
+
+    /** Name of the task calibrating the supply voltage. */
+    static constexpr char Calibration[] PROGMEM{"calibration"};
+
+    /** Name of the task resetting the watchdog timer. */
+    static constexpr char Watchdog[] PROGMEM{"watchdog"};
+};
+
+/**
+ * @brief Structure holding shell command names and arguments, stored in flash memory.
+ */
+struct Command
+{
+    /** Print the available commands. */
+    static constexpr char Help[] PROGMEM{"help"};
+
+    /** Print or set the predict period. */
+    static constexpr char Period[] PROGMEM{"period"};
+
+    /** Print counters. */
+    static constexpr char Stats[] PROGMEM{"stats"};
+
+    /** Retrain the model. */
+    static constexpr char Train[] PROGMEM{"train"};
+
+    /** Print, enable or disable status messages. */
+    static constexpr char Output[] PROGMEM{"output"};
+
+    /** Argument for enabling. */
+    static constexpr char On[] PROGMEM{"on"};
+
+    /** Argument for disabling. */
+    static constexpr char Off[] PROGMEM{"off"};
+
+    /** Argument for binary output. */
+    static constexpr char Binary[] PROGMEM{"binary"};
+
+    /** Argument for tokenized log output. */
+    static constexpr char Tokenized[] PROGMEM{"tokenized"};
+
+    /** Print or erase stored log messages. */
+    static constexpr char Log[] PROGMEM{"log"};
+
+    /** Argument for the log in EEPROM. */
+    static constexpr char Eeprom[] PROGMEM{"eeprom"};
+
+    /** Argument for erasing the log in EEPROM. */
+    static constexpr char Clear[] PROGMEM{"clear"};
+
+    /** Print, start or stop periodic sampling of the temperature sensor. */
+    static constexpr char Sample[] PROGMEM{"sample"};
+
+    /** Print, start or stop background scanning of the temperature sensor. */
+    static constexpr char Scan[] PROGMEM{"scan"};
+
+    /** Print or set the ADC resolution gained by oversampling. */
+    static constexpr char Oversample[] PROGMEM{"oversample"};
+
+    /** Print or set the ADC speed/accuracy profile. */
+    static constexpr char Profile[] PROGMEM{"profile"};
+
+    /** Precise ADC profile. */
+    static constexpr char Precise[] PROGMEM{"precise"};
+
+    /** Balanced ADC profile. */
+    static constexpr char Balanced[] PROGMEM{"balanced"};
+
+    /** Fast ADC profile. */
+    static constexpr char Fast[] PROGMEM{"fast"};
+
+    /** Calibrate the supply voltage of the ADC. */
+    static constexpr char Calibrate[] PROGMEM{"calibrate"};
+
+    /** Print, set or stop the analog watchdog of the temperature sensor. */
+    static constexpr char Watch[] PROGMEM{"watch"};
+
+    /** Read the given analog pins. */
+    static constexpr char Read[] PROGMEM{"read"};
+
+    /** Print or reset the task statistics. */
+    static constexpr char Tasks[] PROGMEM{"tasks"};
+};
+
 // -----------------------------------------------------------------------------
 constexpr int round(const double number) noexcept
 {
     return 0.0 <= number ? static_cast<int>(number + 0.5) : static_cast<int>(number - 0.5);
 }
+
+// -----------------------------------------------------------------------------
+constexpr uint32_t min(const uint32_t x, const uint32_t y) noexcept { return x <= y ? x : y; }
+
+// -----------------------------------------------------------------------------
+constexpr uint32_t percent(const uint32_t part, const uint32_t total) noexcept
+{
+    // Divide the total instead of multiplying the part to avoid an overflow.
+    return 100U <= total ? part / (total / 100U) : 0U;
+}
+
+// -----------------------------------------------------------------------------
+constexpr uint32_t calibrationRecord(const uint16_t supplyVoltage_mV) noexcept
+{
+    // Store the complement in the upper half to detect erased or corrupted records.
+    return (static_cast<uint32_t>(static_cast<uint16_t>(~supplyVoltage_mV)) << 16U) 
+        | supplyVoltage_mV;
+}
+
+// -----------------------------------------------------------------------------
+constexpr uint16_t calibratedSupply(const uint32_t record) noexcept
+{
+    return static_cast<uint16_t>(record);
+}
+
+// -----------------------------------------------------------------------------
+constexpr bool isCalibrationValid(const uint32_t record) noexcept
+{
+    return calibrationRecord(calibratedSupply(record)) == record;
+}
 } // namespace
 
 // -----------------------------------------------------------------------------
 System::System(driver::GpioInterface& led, driver::GpioInterface& button,
                driver::TimerInterface& debounceTimer, driver::TimerInterface& toggleTimer,
-               driver::SerialInterface& serial, driver::WatchdogInterface& watchdog,
-               driver::EepromInterface& eeprom, driver::AdcInterface& adc,
-               ml::lin_reg::Interface& model, const uint8_t tempSensorPin) noexcept
+               driver::TimerInterface& logTimer, driver::SerialInterface& serial,
+               driver::WatchdogInterface& watchdog, driver::EepromInterface& eeprom,
+               driver::AdcInterface& adc, ml::lin_reg::Interface& model,
+               const uint8_t tempSensorPin) noexcept
     : myLed{led}
     , myButton{button}
     , myDebounceTimer{debounceTimer}
     , myPredictTimer{toggleTimer}
+    , myLogTimer{logTimer}
     , mySerial{serial}
     , myWatchdog{watchdog}
     , myEeprom{eeprom}
     , myAdc{adc}
     , myModel{model}
     , myTempSensorPin{tempSensorPin}
+    , myShell{serial}
+    , myPredictionCount{0U}
+    , myButtonPressCount{0U}
+    , myTelemetry{serial}
+    , myOutputMode{OutputMode::Text}
+    , mySerialLog{serial}
+    , myRamLog{}
+    , myEepromLog{eeprom, SystemParam::EepromLogAddress, SystemParam::EepromLogSize}
+    , myLogger{}
+    , myLostByteCount{0U}
+    , myCalibrationCountdown{SystemParam::CalibrationPeriod}
+    , myStoredSupplyVoltage{0U}
+    , myWatching{false}
+    , myExcursionCode{0U}
+    , myExcursionZone{driver::AdcInterface::Zone::Inside}
+    , myTasks{}
 {
+    myLogger.addSink(mySerialLog, logger::Level::Info, SystemParam::SerialLogLimit);
+    myLogger.addSink(myRamLog, logger::Level::Debug, SystemParam::RamLogLimit);
+    myLogger.addSink(myEepromLog, logger::Level::Warning, SystemParam::EepromLogLimit);
     myButton.enableInterrupt(true);
     mySerial.setEnabled(true);
     myWatchdog.setEnabled(true);
     myAdc.setEnabled(true);
+    restoreCalibration();
+    addTasks();
     myPredictTimer.start();
+    myLogTimer.start();
 }
 
 // -----------------------------------------------------------------------------
@@ -54,6 +296,10 @@ System::~System() noexcept
     myButton.enableInterrupt(false);
     myDebounceTimer.stop();
     myPredictTimer.stop();
+    myLogTimer.stop();
+    myAdc.stopSampling();
+    myAdc.stopScan();
+    myAdc.clearWatchdog(myTempSensorPin);
     myWatchdog.setEnabled(false);
 }
 
@@ -66,6 +312,9 @@ void System::enableSerialTransmission(const bool enable) noexcept
 // -----------------------------------------------------------------------------
 void System::handleButtonInterrupt() noexcept
 {
+    // Ignore contact bounces that were posted before the interrupt was disabled, in case 
+    // this handler is deferred.
+    if (myDebounceTimer.isEnabled()) { return; }
     myButton.enableInterruptOnPort(false);
     myDebounceTimer.start();
     if (myButton.read()) { handleButtonPressed(); }
@@ -81,36 +330,691 @@ void System::handleDebounceTimerInterrupt() noexcept
 // -----------------------------------------------------------------------------
 void System::handlePredictTimerInterrupt() noexcept 
 { 
-    predictTemperature(); 
+    requestPrediction();
+}
+
+// -----------------------------------------------------------------------------
+void System::handleLogTimerInterrupt() noexcept
+{
+    myLogger.refill();
+    const uint32_t lostByteCount{mySerial.lostByteCount()};
+
+    if (myLostByteCount != lostByteCount)
+    {
+        myLogger.warning("Lost %lu received bytes!\n"_fmt_P, lostByteCount - myLostByteCount);
+        myLostByteCount = lostByteCount;
+    }
+
+    // Calibrate in a task of its own, since the conversions may block.
+    if (0U == --myCalibrationCountdown)
+    {
+        myCalibrationCountdown = SystemParam::CalibrationPeriod;
+        signal(Task::Calibration);
+    }
+}
+
+// -----------------------------------------------------------------------------
+void System::handleAdcWatchdog(const uint16_t code, const driver::AdcInterface::Zone zone) noexcept
+{
+    // Only store the crossing here, the prediction is made in the main loop.
+    myExcursionCode = code;
+    myExcursionZone = zone;
+    signal(Task::Excursion);
 }
 
+// -----------------------------------------------------------------------------
+void System::handleWorkPosted() noexcept { signal(Task::Dispatch); }
+
 // -----------------------------------------------------------------------------
 void System::run() noexcept
 {
-    mySerial.printf("Running the system!\n");
-    
-    while (1)
+    mySerial.printf_P("Running the system!\n"_fmt_P);
+    mySerial.printf_P("Type 'help' for a list of commands.\n"_fmt_P);
+    myShell.printPrompt();
+
+    // Run the work posted before the notifier was set, if any.
+    signal(Task::Dispatch);
+    utils::Scheduler::resetStatistics();
+    utils::Scheduler::run();
+}
+
+// -----------------------------------------------------------------------------
+void System::addTasks() noexcept
+{
+    // The watchdog timer is reset by the task with the lowest priority, hence the program is
+    // restarted if the other tasks starve it. Event sources without a notification, such as 
+    // the serial port, are polled instead.
+    addTask(Task::Dispatch, [](void*) { (void) utils::WorkQueue::dispatch(); }, 
+            TaskParam::InterruptPriority);
+    addTask(Task::Excursion, [](void* system) { static_cast<System*>(system)->handleExcursion(); },
+            TaskParam::InterruptPriority);
+    addTask(Task::Samples, [](void* system) { static_cast<System*>(system)->handleSamples(); },
+            TaskParam::SamplePriority, TaskParam::SamplePeriod_ms);
+    addTask(Task::Prediction, 
+            [](void* system) { static_cast<System*>(system)->handlePredictionRequest(); },
+            TaskParam::SamplePriority);
+    addTask(Task::Shell, [](void* system) { static_cast<System*>(system)->pollShell(); },
+            TaskParam::CommandPriority, TaskParam::ShellPeriod_ms);
+    addTask(Task::Calibration, 
+            [](void* system) { (void) static_cast<System*>(system)->calibrateSupply(); },
+            TaskParam::CommandPriority);
+    addTask(Task::Watchdog, [](void* system) { static_cast<System*>(system)->myWatchdog.reset(); },
+            TaskParam::WatchdogPriority, TaskParam::WatchdogPeriod_ms);
+}
+
+// -----------------------------------------------------------------------------
+void System::addTask(const Task task, const utils::Scheduler::Task function, 
+                     const uint8_t priority, const uint16_t period_ms) noexcept
+{
+    // The task list is indexed by task, hence it must hold every task.
+    static_assert(static_cast<uint8_t>(Task::Count) == TaskCount, "Invalid number of tasks!");
+    const uint8_t id{utils::Scheduler::add(function, this, priority, period_ms)};
+    myTasks[static_cast<uint8_t>(task)] = id;
+
+    if (utils::Scheduler::InvalidTask == id)
     {
-        myWatchdog.reset();
+        myLogger.error("Failed to add task %u!\n"_fmt_P, static_cast<uint8_t>(task)); 
+    }
+}
+
+// -----------------------------------------------------------------------------
+void System::signal(const Task task) const noexcept
+{
+    utils::Scheduler::signal(myTasks[static_cast<uint8_t>(task)]);
+}
+
+// -----------------------------------------------------------------------------
+void System::handleSamples() noexcept
+{
+    // Handle completed conversions without blocking. While watching, the samples are 
+    // compared by the analog watchdog and only crossings are handled.
+    driver::AdcInterface::Sample sample{};
+    while (myAdc.readSample(sample)) 
+    { 
+        if (!myWatching) { predictTemperature(sample.code); }
+    }
+}
+
+// -----------------------------------------------------------------------------
+void System::handlePredictionRequest() noexcept
+{
+    driver::AdcInterface::Sample sample{};
+    if (!myWatching && myAdc.readLatest(myTempSensorPin, sample)) 
+    { 
+        predictTemperature(sample.code); 
     }
 }
 
+// -----------------------------------------------------------------------------
+void System::pollShell() noexcept
+{
+    // Handle received commands without blocking.
+    if (myShell.poll()) { handleCommand(); }
+}
+
 // -----------------------------------------------------------------------------
 void System::handleButtonPressed() noexcept
 {
-    mySerial.printf("Button pressed!\n");
-    predictTemperature();
+    myButtonPressCount = myButtonPressCount + 1U;
+    myLogger.info("Button pressed!\n"_fmt_P);
+    if (OutputMode::Tokenized == myOutputMode) { PROTOCOL_LOG(myTelemetry, "Button pressed!\n"); }
+    requestPrediction();
 
     // Restart the timer after button press.
     myPredictTimer.restart();
 }
 
 // -----------------------------------------------------------------------------
-void System::predictTemperature() const noexcept
+void System::requestPrediction() noexcept
+{
+    // Only start the conversion here, the prediction is made in the main loop. The latest 
+    // sample is used if the sensor is scanned, since no conversions can be started meanwhile.
+    if (myAdc.isScanning()) { signal(Task::Prediction); }
+    else { myAdc.startConversion(myTempSensorPin); }
+}
+
+// -----------------------------------------------------------------------------
+void System::handleExcursion() noexcept
+{
+    using Zone = driver::AdcInterface::Zone;
+    uint16_t code{};
+    Zone zone{};
+
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        code = myExcursionCode;
+        zone = myExcursionZone;
+    }
+
+    if (Zone::Below == zone) { myLogger.warning("Temperature below the window!\n"_fmt_P); }
+    else if (Zone::Above == zone) { myLogger.warning("Temperature above the window!\n"_fmt_P); }
+    else { myLogger.info("Temperature back inside the window!\n"_fmt_P); }
+    predictTemperature(code);
+}
+
+// -----------------------------------------------------------------------------
+void System::restoreCalibration() noexcept
+{
+    uint32_t record{};
+
+    // Restore the stored calibration to avoid measuring at startup, calibrate if there is none.
+    if (myEeprom.read(SystemParam::EepromCalibrationAddress, record) 
+        && isCalibrationValid(record) && myAdc.setSupplyMillivolts(calibratedSupply(record)))
+    {
+        myStoredSupplyVoltage = calibratedSupply(record);
+    }
+    else { (void) calibrateSupply(); }
+}
+
+// -----------------------------------------------------------------------------
+bool System::calibrateSupply() noexcept
+{
+    // Calibration isn't possible while sampling, or while scanning without the bandgap reference.
+    if (!myAdc.calibrate())
+    {
+        myLogger.debug("Supply voltage calibration skipped!\n"_fmt_P);
+        return false;
+    }
+    const uint16_t supplyVoltage{myAdc.supplyMillivolts()};
+    const uint16_t change{static_cast<uint16_t>(myStoredSupplyVoltage < supplyVoltage 
+        ? supplyVoltage - myStoredSupplyVoltage : myStoredSupplyVoltage - supplyVoltage)};
+
+    // Only store significant changes to limit EEPROM wear.
+    if (SystemParam::MinCalibrationChange_mV <= change)
+    {
+        myEeprom.write(SystemParam::EepromCalibrationAddress, calibrationRecord(supplyVoltage));
+        myStoredSupplyVoltage = supplyVoltage;
+        myLogger.info("Supply voltage calibrated to %u mV!\n"_fmt_P, supplyVoltage);
+    }
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+void System::predictTemperature(const uint16_t adcValue) noexcept
+{
+    // The input voltage is computed in fixed point; only the model uses floating point.
+    const uint16_t mV{myAdc.toMillivolts(myTempSensorPin, adcValue)};
+    const double predictedTemp{myModel.predict(mV * SystemParam::VoltsPerMillivolt)};
+    myPredictionCount = myPredictionCount + 1U;
+    myLogger.debug("ADC code: %u\n"_fmt_P, adcValue);
+
+    // The serial log only prints status messages in text output mode, see handleOutputCommand.
+    myLogger.info("Input: %u mV, predicted output: %.1f!\n"_fmt_P, mV, predictedTemp);
+
+    if (OutputMode::Binary == myOutputMode)
+    {
+        myTelemetry.send(protocol::AdcSample{myTempSensorPin, adcValue});
+        myTelemetry.send(protocol::Prediction{mV, 
+            static_cast<int16_t>(round(predictedTemp * SystemParam::TelemetryScale))});
+    }
+    else if (OutputMode::Tokenized == myOutputMode)
+    {
+        // Send the format string token and the raw arguments, the host formats the text.
+        PROTOCOL_LOG(myTelemetry, "Input: %u mV, predicted output: %.1f!\n", mV, predictedTemp);
+    }
+}
+
+// -----------------------------------------------------------------------------
+void System::handleCommand() noexcept
+{
+    if (myShell.isCommand(Command::Help)) { printHelp(); }
+    else if (myShell.isCommand(Command::Period)) { handlePeriodCommand(); }
+    else if (myShell.isCommand(Command::Stats)) { printStatistics(); }
+    else if (myShell.isCommand(Command::Train)) { handleTrainCommand(); }
+    else if (myShell.isCommand(Command::Output)) { handleOutputCommand(); }
+    else if (myShell.isCommand(Command::Log)) { handleLogCommand(); }
+    else if (myShell.isCommand(Command::Sample)) { handleSampleCommand(); }
+    else if (myShell.isCommand(Command::Scan)) { handleScanCommand(); }
+    else if (myShell.isCommand(Command::Oversample)) { handleOversampleCommand(); }
+    else if (myShell.isCommand(Command::Profile)) { handleProfileCommand(); }
+    else if (myShell.isCommand(Command::Calibrate)) { handleCalibrateCommand(); }
+    else if (myShell.isCommand(Command::Watch)) { handleWatchCommand(); }
+    else if (myShell.isCommand(Command::Read)) { handleReadCommand(); }
+    else if (myShell.isCommand(Command::Tasks)) { handleTasksCommand(); }
+    else 
+    { 
+        mySerial.printf_P("Unknown command '%s', type 'help' for a list of commands!\n"_fmt_P, 
+                          myShell.word(0U)); 
+    }
+    myShell.printPrompt();
+}
+
+// -----------------------------------------------------------------------------
+void System::printHelp() const noexcept
+{
+    mySerial.printf_P("Available commands:\n"_fmt_P);
+    mySerial.printf_P("    help             Print this message.\n"_fmt_P);
+    mySerial.printf_P("    period [ms]      Print or set the predict period.\n"_fmt_P);
+    mySerial.printf_P("    stats            Print counters.\n"_fmt_P);
+    mySerial.printf_P("    train [epochs]   Retrain the model (default %lu epochs).\n"_fmt_P, 
+                      SystemParam::DefaultEpochCount);
+    mySerial.printf_P("    output [on|off|binary|tokenized]\n"_fmt_P);
+    mySerial.printf_P("                     Print or set the output mode of status messages.\n"_fmt_P);
+    mySerial.printf_P("    log [eeprom|clear]\n"_fmt_P);
+    mySerial.printf_P("                     Print the latest messages in RAM or EEPROM,\n"_fmt_P);
+    mySerial.printf_P("                     or erase the messages in EEPROM.\n"_fmt_P);
+    mySerial.printf_P("    sample [hz|off]  Print, start or stop hardware-triggered sampling\n"_fmt_P);
+    mySerial.printf_P("                     of the temperature sensor.\n"_fmt_P);
+    mySerial.printf_P("    scan [hz|off]    Print the latest sample, start or stop background\n"_fmt_P);
+    mySerial.printf_P("                     scanning of the temperature sensor.\n"_fmt_P);
+    mySerial.printf_P("    oversample [bits]\n"_fmt_P);
+    mySerial.printf_P("                     Print or set the extra ADC resolution in bits.\n"_fmt_P);
+    mySerial.printf_P("    profile [precise|balanced|fast]\n"_fmt_P);
+    mySerial.printf_P("                     Print or set the ADC speed/accuracy profile.\n"_fmt_P);
+    mySerial.printf_P("    calibrate        Calibrate the ADC supply voltage.\n"_fmt_P);
+    mySerial.printf_P("    watch [low high [hysteresis]|off]\n"_fmt_P);
+    mySerial.printf_P("                     Print, set or stop the analog watchdog window of\n"_fmt_P);
+    mySerial.printf_P("                     the temperature sensor in ADC codes; only crossings\n"_fmt_P);
+    mySerial.printf_P("                     are predicted while watching.\n"_fmt_P);
+    mySerial.printf_P("    read [pins]      Read the given analog pins at once (default the\n"_fmt_P);
+    mySerial.printf_P("                     temperature sensor).\n"_fmt_P);
+    mySerial.printf_P("    tasks [clear]    Print or reset the task runtime statistics.\n"_fmt_P);
+}
+
+// -----------------------------------------------------------------------------
+void System::printStatistics() noexcept
+{
+    uint32_t predictionCount{};
+    uint32_t buttonPressCount{};
+
+    // Read the counters atomically, since they are updated in interrupt context.
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        predictionCount  = myPredictionCount;
+        buttonPressCount = myButtonPressCount;
+    }
+
+    mySerial.printf_P("Predictions:        %lu\n"_fmt_P, predictionCount);
+    mySerial.printf_P("Button presses:     %lu\n"_fmt_P, buttonPressCount);
+    mySerial.printf_P("Predict period:     %lu ms\n"_fmt_P, myPredictTimer.timeout_ms());
+    mySerial.printf_P("Predict timer:      %lu overruns, %lu us max lateness\n"_fmt_P, 
+                      myPredictTimer.overrunCount(), myPredictTimer.maxLateness_us());
+    mySerial.printf_P("Dropped TX bytes:   %lu\n"_fmt_P, mySerial.droppedByteCount());
+    mySerial.printf_P("Lost RX bytes:      %lu\n"_fmt_P, mySerial.lostByteCount());
+    mySerial.printf_P("Suppressed logs:    %lu\n"_fmt_P, myLogger.suppressedCount());
+    mySerial.printf_P("Lost ADC samples:   %lu\n"_fmt_P, myAdc.lostSampleCount());
+    mySerial.printf_P("Sample rate:        %u Hz\n"_fmt_P, myAdc.sampleRate_hz());
+    mySerial.printf_P("Supply voltage:     %u mV\n"_fmt_P, myAdc.supplyMillivolts());
+    mySerial.printf_P("Deferred work:      %lu us max latency, %u max pending, %u dropped\n"_fmt_P,
+                      utils::WorkQueue::maxLatency(), utils::WorkQueue::maxPendingCount(), 
+                      utils::WorkQueue::droppedCount());
+
+    // Send the counters as telemetry as well in binary output mode.
+    if (OutputMode::Binary == myOutputMode)
+    {
+        myTelemetry.send(protocol::Counters{predictionCount, buttonPressCount, 
+            mySerial.droppedByteCount(), mySerial.lostByteCount()});
+    }
+}
+
+// -----------------------------------------------------------------------------
+void System::handlePeriodCommand() noexcept
+{
+    uint32_t period_ms{};
+
+    if (1U == myShell.wordCount())
+    {
+        mySerial.printf_P("Predict period: %lu ms\n"_fmt_P, myPredictTimer.timeout_ms());
+    }
+    else if ((2U == myShell.wordCount()) && myShell.readUnsigned(1U, period_ms) && (0U < period_ms))
+    {
+        myPredictTimer.setTimeout_ms(period_ms);
+
+        // Restart the timer to apply the new period immediately.
+        if (myPredictTimer.isEnabled()) { myPredictTimer.restart(); }
+        mySerial.printf_P("Predict period set to %lu ms!\n"_fmt_P, myPredictTimer.timeout_ms());
+    }
+    else { mySerial.printf_P("Usage: period [ms], where ms > 0!\n"_fmt_P); }
+}
+
+// -----------------------------------------------------------------------------
+void System::handleTrainCommand() noexcept
 {
-    const auto inputVoltage{myAdc.inputVoltage(myTempSensorPin)};
-    const auto mV{inputVoltage * 1000.0};
-    const double predictedTemp{myModel.predict(inputVoltage)};
-    mySerial.printf("Input: %d mV, predicted output: %d!\n", round(mV), round(predictedTemp));
+    uint32_t epochCount{SystemParam::DefaultEpochCount};
+
+    if ((2U < myShell.wordCount()) || ((2U == myShell.wordCount()) && 
+        (!myShell.readUnsigned(1U, epochCount) || (0U == epochCount) || 
+        (SystemParam::MaxEpochCount < epochCount))))
+    {
+        mySerial.printf_P("Usage: train [epochs], where 0 < epochs <= %lu!\n"_fmt_P, 
+                          SystemParam::MaxEpochCount);
+        return;
+    }
+
+    // Stop the predict timer during training, which blocks the main loop for many prediction
+    // periods, hence the timeouts would otherwise be reported as overruns.
+    const bool timerEnabled{myPredictTimer.isEnabled()};
+    myPredictTimer.stop();
+    mySerial.printf_P("Training the model during %lu epochs...\n"_fmt_P, epochCount);
+
+    // Train in chunks to reset the watchdog timer in between.
+    while (0U < epochCount)
+    {
+        const uint32_t epochs{min(epochCount, SystemParam::EpochsPerWatchdogReset)};
+        if (!myModel.train(static_cast<unsigned int>(epochs), SystemParam::LearningRate))
+        {
+            myLogger.error("Training failed!\n"_fmt_P);
+            break;
+        }
+        epochCount -= epochs;
+        myWatchdog.reset();
+    }
+
+    mySerial.printf_P("Training done, prediction at 0 V: %.1f, at 1 V: %.1f!\n"_fmt_P,
+                      myModel.predict(0.0), myModel.predict(1.0));
+    if (timerEnabled) { myPredictTimer.start(); }
+}
+
+// -----------------------------------------------------------------------------
+void System::handleOutputCommand() noexcept
+{
+    if ((2U == myShell.wordCount()) && myShell.matches(1U, Command::On)) 
+    { 
+        myOutputMode = OutputMode::Text; 
+    }
+    else if ((2U == myShell.wordCount()) && myShell.matches(1U, Command::Off)) 
+    { 
+        myOutputMode = OutputMode::Off; 
+    }
+    else if ((2U == myShell.wordCount()) && myShell.matches(1U, Command::Binary)) 
+    { 
+        myOutputMode = OutputMode::Binary; 
+    }
+    else if ((2U == myShell.wordCount()) && myShell.matches(1U, Command::Tokenized)) 
+    { 
+        myOutputMode = OutputMode::Tokenized; 
+    }
+    else if (1U != myShell.wordCount())
+    {
+        mySerial.printf_P("Usage: output [on|off|binary|tokenized]!\n"_fmt_P);
+        return;
+    }
+
+    // Print status messages in text output mode only, and nothing but frames in the binary
+    // output modes. Warnings and errors are still printed when status messages are disabled.
+    switch (myOutputMode)
+    {
+        case OutputMode::Text:
+            myLogger.setMinLevel(mySerialLog, logger::Level::Info);
+            mySerial.printf_P("Status messages enabled!\n"_fmt_P);
+            break;
+        case OutputMode::Binary:
+            myLogger.setMinLevel(mySerialLog, logger::Level::Off);
+            mySerial.printf_P("Status messages sent as binary telemetry frames!\n"_fmt_P);
+            break;
+        case OutputMode::Tokenized:
+            myLogger.setMinLevel(mySerialLog, logger::Level::Off);
+            mySerial.printf_P("Status messages sent as tokenized log frames!\n"_fmt_P);
+            break;
+        default:
+            myLogger.setMinLevel(mySerialLog, logger::Level::Warning);
+            mySerial.printf_P("Status messages disabled!\n"_fmt_P);
+            break;
+    }
+}
+
+// -----------------------------------------------------------------------------
+void System::handleLogCommand() noexcept
+{
+    char character{};
+
+    if (1U == myShell.wordCount())
+    {
+        // Print (and remove) the latest messages kept in RAM.
+        while (myRamLog.read(character)) { mySerial.printf_P("%c"_fmt_P, character); }
+    }
+    else if ((2U == myShell.wordCount()) && myShell.matches(1U, Command::Eeprom))
+    {
+        // Print the messages stored in EEPROM, skipping unused space.
+        for (uint16_t i{}; myEepromLog.read(i, character); ++i)
+        {
+            if ('\0' != character) { mySerial.printf_P("%c"_fmt_P, character); }
+        }
+    }
+    else if ((2U == myShell.wordCount()) && myShell.matches(1U, Command::Clear))
+    {
+        myEepromLog.clear();
+        mySerial.printf_P("Log in EEPROM erased!\n"_fmt_P);
+    }
+    else { mySerial.printf_P("Usage: log [eeprom|clear]!\n"_fmt_P); }
+}
+
+// -----------------------------------------------------------------------------
+void System::handleSampleCommand() noexcept
+{
+    uint32_t sampleRate_hz{};
+
+    if ((2U == myShell.wordCount()) && myShell.matches(1U, Command::Off))
+    {
+        myAdc.stopSampling();
+        mySerial.printf_P("Sampling stopped!\n"_fmt_P);
+    }
+    else if ((2U == myShell.wordCount()) && myShell.readUnsigned(1U, sampleRate_hz) 
+             && (0U < sampleRate_hz) && (UINT16_MAX >= sampleRate_hz))
+    {
+        // Each sample is handled like a prediction in the main loop.
+        if (myAdc.startSampling(myTempSensorPin, static_cast<uint16_t>(sampleRate_hz)))
+        {
+            mySerial.printf_P("Sampling at %u Hz!\n"_fmt_P, myAdc.sampleRate_hz());
+        }
+        else { mySerial.printf_P("Failed to start sampling at %lu Hz!\n"_fmt_P, sampleRate_hz); }
+    }
+    else if (1U == myShell.wordCount())
+    {
+        if (0U < myAdc.sampleRate_hz())
+        {
+            mySerial.printf_P("Sampling at %u Hz!\n"_fmt_P, myAdc.sampleRate_hz());
+        }
+        else { mySerial.printf_P("Sampling stopped!\n"_fmt_P); }
+    }
+    else { mySerial.printf_P("Usage: sample [hz|off], where hz > 0!\n"_fmt_P); }
+}
+
+// -----------------------------------------------------------------------------
+void System::handleScanCommand() noexcept
+{
+    uint32_t scanRate_hz{};
+    driver::AdcInterface::Sample sample{};
+
+    if ((2U == myShell.wordCount()) && myShell.matches(1U, Command::Off))
+    {
+        myAdc.stopScan();
+        myAdc.setScanRate(myTempSensorPin, 0U);
+        mySerial.printf_P("Scanning stopped!\n"_fmt_P);
+    }
+    else if ((2U == myShell.wordCount()) && myShell.readUnsigned(1U, scanRate_hz) 
+             && (0U < scanRate_hz) && (UINT16_MAX >= scanRate_hz))
+    {
+        // Predictions use the latest sample while scanning, see requestPrediction.
+        if (myAdc.setScanRate(myTempSensorPin, static_cast<uint16_t>(scanRate_hz)) 
+            && myAdc.startScan())
+        {
+            mySerial.printf_P("Scanning at %lu Hz!\n"_fmt_P, scanRate_hz);
+        }
+        else { mySerial.printf_P("Failed to start scanning at %lu Hz!\n"_fmt_P, scanRate_hz); }
+    }
+    else if (1U == myShell.wordCount())
+    {
+        if (myAdc.readLatest(myTempSensorPin, sample))
+        {
+            mySerial.printf_P("Latest sample: %u at %lu us\n"_fmt_P, sample.code, sample.timestamp);
+        }
+        else { mySerial.printf_P("No scanned sample available!\n"_fmt_P); }
+    }
+    else { mySerial.printf_P("Usage: scan [hz|off], where hz > 0!\n"_fmt_P); }
+}
+
+// -----------------------------------------------------------------------------
+void System::handleOversampleCommand() noexcept
+{
+    uint32_t extraBitCount{};
+
+    if ((2U == myShell.wordCount()) && myShell.readUnsigned(1U, extraBitCount))
+    {
+        // Oversampling can't be changed while sampling or scanning.
+        if ((UINT8_MAX < extraBitCount) 
+            || !myAdc.setOversampling(static_cast<uint8_t>(extraBitCount)))
+        {
+            mySerial.printf_P("Failed to set %lu extra bits!\n"_fmt_P, extraBitCount);
+            return;
+        }
+    }
+    else if (1U != myShell.wordCount())
+    {
+        mySerial.printf_P("Usage: oversample [bits]!\n"_fmt_P);
+        return;
+    }
+    mySerial.printf_P("ADC resolution: %u bits!\n"_fmt_P, myAdc.resolution());
+}
+
+// -----------------------------------------------------------------------------
+void System::handleProfileCommand() noexcept
+{
+    using Profile = driver::AdcInterface::Profile;
+    static constexpr const char* names[]{Command::Precise, Command::Balanced, Command::Fast};
+    static_assert(static_cast<uint8_t>(Profile::Count) == sizeof(names) / sizeof(names[0]), 
+                  "Invalid number of ADC profile names!");
+
+    if (2U == myShell.wordCount())
+    {
+        uint8_t i{};
+        while ((sizeof(names) / sizeof(names[0]) > i) && !myShell.matches(1U, names[i])) { ++i; }
+
+        // The profile can't be changed while sampling or scanning.
+        if ((sizeof(names) / sizeof(names[0]) <= i) 
+            || !myAdc.setProfile(static_cast<Profile>(i)))
+        {
+            mySerial.printf_P("Failed to set profile '%s'!\n"_fmt_P, myShell.word(1U));
+            return;
+        }
+    }
+    else if (1U != myShell.wordCount())
+    {
+        mySerial.printf_P("Usage: profile [precise|balanced|fast]!\n"_fmt_P);
+        return;
+    }
+    // The profile names are stored in flash memory, copy the name before printing.
+    char name[sizeof(Command::Balanced)]{};
+    strncpy_P(name, names[static_cast<uint8_t>(myAdc.profile())], sizeof(name) - 1U);
+    mySerial.printf_P("ADC profile: %s, %u bits!\n"_fmt_P, name, myAdc.resolution());
+}
+
+// -----------------------------------------------------------------------------
+void System::handleCalibrateCommand() noexcept
+{
+    if (1U != myShell.wordCount()) { mySerial.printf_P("Usage: calibrate!\n"_fmt_P); }
+    else if (calibrateSupply())
+    {
+        mySerial.printf_P("Supply voltage: %u mV!\n"_fmt_P, myAdc.supplyMillivolts());
+    }
+    else { mySerial.printf_P("Failed to calibrate the supply voltage!\n"_fmt_P); }
+}
+
+// -----------------------------------------------------------------------------
+void System::handleWatchCommand() noexcept
+{
+    const uint8_t wordCount{myShell.wordCount()};
+    uint32_t low{};
+    uint32_t high{};
+    uint32_t hysteresis{SystemParam::DefaultWatchdogHysteresis};
+
+    if ((2U == wordCount) && myShell.matches(1U, Command::Off))
+    {
+        myAdc.clearWatchdog(myTempSensorPin);
+        myWatching = false;
+        mySerial.printf_P("Watchdog stopped!\n"_fmt_P);
+    }
+    else if (((3U == wordCount) || (4U == wordCount)) && myShell.readUnsigned(1U, low) 
+             && myShell.readUnsigned(2U, high) 
+             && ((3U == wordCount) || myShell.readUnsigned(3U, hysteresis)))
+    {
+        // The window is validated by the ADC, e.g. the hysteresis must fit twice in the window.
+        if ((UINT16_MAX >= low) && (UINT16_MAX >= high) && (UINT16_MAX >= hysteresis) 
+            && myAdc.setWatchdog(myTempSensorPin, static_cast<uint16_t>(low), 
+                                 static_cast<uint16_t>(high), static_cast<uint16_t>(hysteresis)))
+        {
+            myWatching = true;
+            mySerial.printf_P("Watching codes %lu - %lu, hysteresis %lu!\n"_fmt_P, 
+                              low, high, hysteresis);
+        }
+        else { mySerial.printf_P("Invalid watchdog window!\n"_fmt_P); }
+    }
+    else if (1U == wordCount)
+    {
+        mySerial.printf_P("Watchdog %s!\n"_fmt_P, myWatching ? "active" : "stopped");
+    }
+    else { mySerial.printf_P("Usage: watch [low high [hysteresis]|off]!\n"_fmt_P); }
+}
+
+// -----------------------------------------------------------------------------
+void System::handleReadCommand() noexcept
+{
+    uint8_t pins[Shell::MaxWordCount]{myTempSensorPin};
+    uint16_t values[Shell::MaxWordCount]{};
+    const uint8_t wordCount{myShell.wordCount()};
+    const uint8_t pinCount{static_cast<uint8_t>(1U < wordCount ? wordCount - 1U : 1U)};
+
+    for (uint8_t i{1U}; i < wordCount; ++i)
+    {
+        uint32_t pin{};
+        if (!myShell.readUnsigned(i, pin) || (UINT8_MAX < pin))
+        {
+            mySerial.printf_P("Usage: read [pins]!\n"_fmt_P);
+            return;
+        }
+        pins[i - 1U] = static_cast<uint8_t>(pin);
+    }
+
+    // Convert all pins back to back with a single call.
+    if (!myAdc.read(pins, values, pinCount))
+    {
+        mySerial.printf_P("Failed to read the given pins!\n"_fmt_P);
+        return;
+    }
+
+    for (uint8_t i{}; i < pinCount; ++i)
+    {
+        mySerial.printf_P("Pin %u: %u (%u mV)\n"_fmt_P, pins[i], values[i], 
+                          myAdc.toMillivolts(pins[i], values[i]));
+    }
+}
+
+// -----------------------------------------------------------------------------
+void System::handleTasksCommand() noexcept
+{
+    static constexpr const char* names[]{TaskName::Dispatch, TaskName::Excursion, 
+        TaskName::Samples, TaskName::Prediction, TaskName::Shell, TaskName::Calibration, 
+        TaskName::Watchdog};
+    static_assert(static_cast<uint8_t>(Task::Count) == sizeof(names) / sizeof(names[0]), 
+                  "Invalid number of task names!");
+
+    if ((2U == myShell.wordCount()) && myShell.matches(1U, Command::Clear))
+    {
+        utils::Scheduler::resetStatistics();
+        mySerial.printf_P("Task statistics reset!\n"_fmt_P);
+        return;
+    }
+    else if (1U != myShell.wordCount())
+    {
+        mySerial.printf_P("Usage: tasks [clear]!\n"_fmt_P);
+        return;
+    }
+    const uint32_t elapsedTime_us{utils::Scheduler::elapsedTime_us()};
+    mySerial.printf_P("       Task       Runs   Total us     Max us  Load\n"_fmt_P);
+
+    for (uint8_t i{}; i < static_cast<uint8_t>(Task::Count); ++i)
+    {
+        utils::Scheduler::Statistics statistics{};
+        if (!utils::Scheduler::statistics(myTasks[i], statistics)) { continue; }
+
+        // The task names are stored in flash memory, copy the name before printing.
+        char name[sizeof(TaskName::Calibration)]{};
+        strncpy_P(name, names[i], sizeof(name) - 1U);
+        mySerial.printf_P("%11s %10lu %10lu %10lu %4lu %%\n"_fmt_P, name, statistics.runCount, 
+                          statistics.totalRuntime_us, statistics.maxRuntime_us, 
+                          percent(statistics.totalRuntime_us, elapsedTime_us));
+    }
+    mySerial.printf_P("Idle: %lu us of %lu us (%lu %%)\n"_fmt_P, utils::Scheduler::idleTime_us(),
+                      elapsedTime_us, percent(utils::Scheduler::idleTime_us(), elapsedTime_us));
 }
-} // namespace target
\ No newline at end of file
+} // namespace target
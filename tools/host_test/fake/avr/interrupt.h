@@ -0,0 +1,17 @@
+/**
+ * @brief Register fake of <avr/interrupt.h>.
+ *
+ *        Interrupt service routines are plain functions named after their vector, hence the
+ *        tests run them by calling the vector, e.g. USART_UDRE_vect().
+ */
+#pragma once
+
+#include <avr/io.h>
+
+#define ISR(vector) extern "C" void vector(void)
+
+#define sei() (SREG |= (1U << SREG_I))
+#define cli() (SREG &= static_cast<uint8_t>(~(1U << SREG_I)))
+
+extern "C" void USART_RX_vect(void);
+extern "C" void USART_UDRE_vect(void);
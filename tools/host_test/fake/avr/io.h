@@ -0,0 +1,46 @@
+/**
+ * @brief Register fake of <avr/io.h>, holding the registers used by the drivers under test.
+ *
+ *        Registers are plain variables, hence hardware side effects (such as flags cleared on
+ *        read) must be emulated by the tests.
+ */
+#pragma once
+
+#include <stdint.h>
+
+/** Status register. */
+extern volatile uint8_t SREG;
+
+/** USART 0 registers. */
+extern volatile uint8_t UCSR0A;
+extern volatile uint8_t UCSR0B;
+extern volatile uint8_t UCSR0C;
+extern volatile uint8_t UDR0;
+extern volatile uint16_t UBRR0;
+
+/** Global interrupt enable bit in SREG. */
+#define SREG_I 7
+
+/** USART 0 control and status register A bits. */
+#define RXC0  7
+#define TXC0  6
+#define UDRE0 5
+#define FE0   4
+#define DOR0  3
+#define UPE0  2
+#define U2X0  1
+#define MPCM0 0
+
+/** USART 0 control and status register B bits. */
+#define RXCIE0 7
+#define TXCIE0 6
+#define UDRIE0 5
+#define RXEN0  4
+#define TXEN0  3
+#define UCSZ02 2
+#define RXB80  1
+#define TXB80  0
+
+/** USART 0 control and status register C bits. */
+#define UCSZ01 2
+#define UCSZ00 1
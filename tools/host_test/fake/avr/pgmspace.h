@@ -0,0 +1,17 @@
+/**
+ * @brief Register fake of <avr/pgmspace.h>, where flash memory is ordinary memory.
+ */
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+
+#define PROGMEM
+#define PSTR(s) (s)
+
+#define pgm_read_byte(address)  (*reinterpret_cast<const uint8_t*>(address))
+#define pgm_read_word(address)  (*reinterpret_cast<const uint16_t*>(address))
+#define pgm_read_dword(address) (*reinterpret_cast<const uint32_t*>(address))
+
+#define strcmp_P(s1, s2)     strcmp((s1), (s2))
+#define strncpy_P(s1, s2, n) strncpy((s1), (s2), (n))
@@ -0,0 +1,36 @@
+/**
+ * @brief Register fake of <util/atomic.h>.
+ *
+ *        The global interrupt enable bit is cleared within the block and SREG is restored when 
+ *        the block is left, also by return or break, like avr-libc does.
+ */
+#pragma once
+
+#include <avr/io.h>
+
+#define ATOMIC_RESTORESTATE 0
+#define ATOMIC_FORCEON      1
+
+/**
+ * @brief Guard disabling interrupts during its lifetime.
+ */
+struct AtomicGuard
+{
+    AtomicGuard() noexcept
+        : sreg{SREG}
+        , once{true}
+    {
+        SREG = static_cast<uint8_t>(SREG & ~(1U << SREG_I));
+    }
+
+    ~AtomicGuard() noexcept { SREG = sreg; }
+
+    /** SREG saved when the block was entered. */
+    const uint8_t sreg;
+
+    /** Indicate whether the block is still to be run. */
+    bool once;
+};
+
+#define ATOMIC_BLOCK(type) \
+    for (AtomicGuard atomicGuard{}; atomicGuard.once; atomicGuard.once = false)
@@ -0,0 +1,189 @@
+/**
+ * @brief Host tests of drivers and containers, built against a register fake.
+ *
+ *        The AVR headers are replaced by the register fake in the fake directory, hence the
+ *        code under test is built unmodified and interrupt service routines are run by calling
+ *        their vectors. Failed checks are printed, the exit status is the number of failures.
+ *
+ *        Usage: host_test
+ */
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+#include <avr/interrupt.h>
+#include <avr/io.h>
+
+#include "container/ring_buffer.h"
+#include "driver/atmega328p/serial.h"
+#include "utils/utils.h"
+
+namespace
+{
+/** The number of failed checks. */
+int failureCount{};
+
+// -----------------------------------------------------------------------------
+void check(const bool condition, const char* test, const char* description)
+{
+    if (condition) { return; }
+    std::printf("%s: %s failed!\n", test, description);
+    ++failureCount;
+}
+
+// -----------------------------------------------------------------------------
+void testRingBufferFullEmpty()
+{
+    constexpr const char* test{"RingBuffer full/empty"};
+    container::RingBuffer<std::uint8_t, 4U> buffer{};
+    std::uint8_t value{};
+
+    check(4U == buffer.capacity(), test, "capacity");
+    check(buffer.isEmpty() && !buffer.isFull() && (0U == buffer.size()), test, "initially empty");
+    check(!buffer.pop(value) && !buffer.peek(value), test, "pop from empty buffer");
+
+    for (std::uint8_t i{}; i < 4U; ++i) { check(buffer.push(i), test, "push"); }
+    check(buffer.isFull() && !buffer.isEmpty() && (4U == buffer.size()), test, "full");
+    check(!buffer.push(4U), test, "push to full buffer");
+    check(buffer.peek(value) && (0U == value) && (4U == buffer.size()), test, "peek");
+
+    for (std::uint8_t i{}; i < 4U; ++i)
+    {
+        check(buffer.pop(value) && (i == value), test, "pop in order");
+    }
+    check(buffer.isEmpty() && !buffer.isFull(), test, "empty after pop");
+
+    (void) buffer.push(1U);
+    buffer.clear();
+    check(buffer.isEmpty(), test, "empty after clear");
+}
+
+// -----------------------------------------------------------------------------
+void testRingBufferWrap()
+{
+    constexpr const char* test{"RingBuffer wrap"};
+    container::RingBuffer<std::uint16_t, 8U> buffer{};
+    std::uint16_t next{};
+    std::uint16_t expected{};
+    std::uint16_t value{};
+
+    // Keep the buffer partially filled across several wrap arounds of the eight-bit indexes.
+    for (std::uint16_t i{}; i < 1000U; ++i)
+    {
+        while (!buffer.isFull()) { (void) buffer.push(next++); }
+        for (std::uint8_t j{}; j < 5U; ++j)
+        {
+            check(buffer.pop(value) && (expected++ == value), test, "pop in order");
+        }
+        check(3U == buffer.size(), test, "size");
+    }
+}
+
+// -----------------------------------------------------------------------------
+void testRingBufferMaxSize()
+{
+    constexpr const char* test{"RingBuffer 128 entries"};
+    container::RingBuffer<std::uint8_t, 128U> buffer{};
+    std::uint8_t value{};
+
+    // The size of a full buffer equals the difference of the eight-bit indexes, which must
+    // not be mistaken for an empty buffer, also once the indexes have wrapped around.
+    for (std::uint8_t round{}; round < 3U; ++round)
+    {
+        for (std::uint8_t i{}; i < 128U; ++i) { check(buffer.push(i), test, "push"); }
+        check(buffer.isFull() && !buffer.isEmpty() && (128U == buffer.size()), test, "full");
+        check(!buffer.push(0U), test, "push to full buffer");
+
+        for (std::uint8_t i{}; i < 128U; ++i)
+        {
+            check(buffer.pop(value) && (i == value), test, "pop in order");
+        }
+        check(buffer.isEmpty() && (0U == buffer.size()), test, "empty");
+
+        // Offset the indexes, hence the next round fills the buffer across the wrap around.
+        (void) buffer.push(0U);
+        (void) buffer.pop(value);
+    }
+}
+
+// -----------------------------------------------------------------------------
+std::string drain()
+{
+    // Run the data register empty interrupt until it disables itself, which happens on the
+    // first run once the buffer is empty.
+    std::string output{};
+
+    while (utils::read(UCSR0B, UDRIE0))
+    {
+        USART_UDRE_vect();
+        if (utils::read(UCSR0B, UDRIE0)) { output += static_cast<char>(UDR0); }
+    }
+    return output;
+}
+
+// -----------------------------------------------------------------------------
+std::string sequence(const std::uint8_t first, const std::uint8_t last)
+{
+    std::string characters{};
+    for (std::uint16_t i{first}; i <= last; ++i) { characters += static_cast<char>(i); }
+    return characters;
+}
+
+// -----------------------------------------------------------------------------
+void testSerial()
+{
+    constexpr const char* test{"Serial transmit"};
+    using OverflowPolicy = driver::SerialInterface::OverflowPolicy;
+    auto& serial{driver::atmega328p::Serial::getInstance()};
+    std::uint8_t data[100U]{};
+
+    // Write more data than the 64-byte transmit buffer can hold.
+    for (std::uint8_t i{}; i < sizeof(data); ++i) { data[i] = i; }
+    serial.setEnabled(true);
+    check(OverflowPolicy::Block == serial.overflowPolicy(), test, "block by default");
+
+    // The buffer is drained in the background, without blocking.
+    sei();
+    check(serial.write(data, 10U) && utils::read(UCSR0B, UDRIE0), test, "interrupt enabled");
+    check(sequence(0U, 9U) == drain(), test, "background transmission");
+    check(!utils::read(UCSR0B, UDRIE0), test, "interrupt disabled once drained");
+
+    // Newest bytes are dropped once the buffer is full.
+    serial.setOverflowPolicy(OverflowPolicy::DropNewest);
+    (void) serial.write(data, sizeof(data));
+    check(36U == serial.droppedByteCount(), test, "drop newest count");
+    check(sequence(0U, 63U) == drain(), test, "drop newest data");
+
+    // Oldest bytes are dropped once the buffer is full.
+    serial.resetDroppedByteCount();
+    serial.setOverflowPolicy(OverflowPolicy::DropOldest);
+    (void) serial.write(data, sizeof(data));
+    check(36U == serial.droppedByteCount(), test, "drop oldest count");
+    check(sequence(36U, 99U) == drain(), test, "drop oldest data");
+
+    // With interrupts disabled, e.g. in an interrupt service routine, blocking writes drain the
+    // buffer by polling the data register empty flag, hence no byte is lost.
+    serial.resetDroppedByteCount();
+    serial.setOverflowPolicy(OverflowPolicy::Block);
+    cli();
+    utils::set(UCSR0A, UDRE0);
+    (void) serial.write(data, sizeof(data));
+    check(0U == serial.droppedByteCount(), test, "block count");
+    check(35U == UDR0, test, "block polled data");
+    check(sequence(36U, 99U) == drain(), test, "block buffered data");
+    sei();
+    serial.setEnabled(false);
+}
+} // namespace
+
+// -----------------------------------------------------------------------------
+int main()
+{
+    testRingBufferFullEmpty();
+    testRingBufferWrap();
+    testRingBufferMaxSize();
+    testSerial();
+
+    std::printf("Host tests %s!\n", 0 == failureCount ? "passed" : "failed");
+    return failureCount;
+}
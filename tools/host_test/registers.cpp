@@ -0,0 +1,24 @@
+/**
+ * @brief Registers of the register fake, see fake/avr/io.h.
+ */
+#include <avr/interrupt.h>
+#include <avr/io.h>
+
+#include "utils/utils.h"
+
+volatile uint8_t SREG{};
+
+volatile uint8_t UCSR0A{};
+volatile uint8_t UCSR0B{};
+volatile uint8_t UCSR0C{};
+volatile uint8_t UDR0{};
+volatile uint16_t UBRR0{};
+
+namespace utils
+{
+// -----------------------------------------------------------------------------
+void globalInterruptEnable() noexcept { sei(); }
+
+// -----------------------------------------------------------------------------
+void globalInterruptDisable() noexcept { cli(); }
+} // namespace utils
@@ -0,0 +1,65 @@
+/**
+ * @brief Implementation details of the host-side telemetry stream decoder.
+ */
+#include <utility>
+
+#include "decoder.h"
+
+namespace telemetry
+{
+// -----------------------------------------------------------------------------
+StreamDecoder::StreamDecoder(PacketHandler handler)
+    : myHandler{std::move(handler)}
+    , myFrame{}
+    , myStatistics{}
+    , myNextSequence{0U}
+    , myOverflow{false}
+    , mySynchronized{false}
+{
+    myFrame.reserve(protocol::packet::MaxFrameSize);
+}
+
+// -----------------------------------------------------------------------------
+void StreamDecoder::feed(const std::uint8_t* data, const std::size_t size)
+{
+    for (std::size_t i{}; i < size; ++i)
+    {
+        if (protocol::cobs::Delimiter == data[i]) { decodeFrame(); }
+        else if (protocol::packet::MaxFrameSize > myFrame.size()) { myFrame.push_back(data[i]); }
+        else { myOverflow = true; }
+    }
+}
+
+// -----------------------------------------------------------------------------
+const StreamDecoder::Statistics& StreamDecoder::statistics() const noexcept
+{
+    return myStatistics;
+}
+
+// -----------------------------------------------------------------------------
+void StreamDecoder::decodeFrame()
+{
+    // Ignore empty frames, such as consecutive delimiters.
+    if (myFrame.empty()) { return; }
+    protocol::Packet packet{};
+    const bool valid{!myOverflow && protocol::packet::decode(myFrame.data(), myFrame.size(), packet)};
+    myFrame.clear();
+    myOverflow = false;
+
+    if (!valid)
+    {
+        ++myStatistics.invalidFrameCount;
+        return;
+    }
+
+    // Count the packets skipped since the last packet (the sequence number wraps at 256).
+    if (mySynchronized) 
+    { 
+        myStatistics.lostPacketCount += static_cast<std::uint8_t>(packet.sequence - myNextSequence); 
+    }
+    myNextSequence = static_cast<std::uint8_t>(packet.sequence + 1U);
+    mySynchronized = true;
+    ++myStatistics.packetCount;
+    if (myHandler) { myHandler(packet); }
+}
+} // namespace telemetry
@@ -0,0 +1,87 @@
+/**
+ * @brief Host-side decoder of binary telemetry streams.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include "protocol/packet.h"
+
+namespace telemetry
+{
+/**
+ * @brief Decoder of binary telemetry streams.
+ * 
+ *        Bytes are fed in arbitrary chunks, for instance as read from a serial port, a pty or
+ *        a pipe. Complete frames are decoded and passed to the packet handler. Invalid frames,
+ *        such as text output mixed into the stream or frames with bit errors, are counted and 
+ *        skipped; the decoder resynchronizes at the next frame delimiter.
+ */
+class StreamDecoder final
+{
+public:
+    /** Handler invoked for every decoded packet. */
+    using PacketHandler = std::function<void(const protocol::Packet&)>;
+
+    /**
+     * @brief Structure holding decoder statistics.
+     */
+    struct Statistics
+    {
+        /** The number of successfully decoded packets. */
+        std::size_t packetCount{};
+
+        /** The number of invalid frames (CRC mismatch, bad encoding etc.). */
+        std::size_t invalidFrameCount{};
+
+        /** The number of packets lost according to the sequence numbers. */
+        std::size_t lostPacketCount{};
+    };
+
+    /**
+     * @brief Create a new stream decoder.
+     * 
+     * @param[in] handler Handler invoked for every decoded packet.
+     */
+    explicit StreamDecoder(PacketHandler handler);
+
+    /**
+     * @brief Feed the given data to the decoder.
+     * 
+     * @param[in] data Pointer to the received data.
+     * @param[in] size The size of the data in bytes.
+     */
+    void feed(const std::uint8_t* data, std::size_t size);
+
+    /**
+     * @brief Get the decoder statistics.
+     * 
+     * @return Reference to the statistics.
+     */
+    const Statistics& statistics() const noexcept;
+
+private:
+    void decodeFrame();
+
+    /** Handler invoked for every decoded packet. */
+    PacketHandler myHandler;
+
+    /** Bytes of the current frame. */
+    std::vector<std::uint8_t> myFrame;
+
+    /** Decoder statistics. */
+    Statistics myStatistics;
+
+    /** Sequence number of the next expected packet. */
+    std::uint8_t myNextSequence;
+
+    /** Indicate whether the current frame exceeds the maximum frame size. */
+    bool myOverflow;
+
+    /** Indicate whether a packet has been received, i.e. whether the sequence is known. */
+    bool mySynchronized;
+};
+} // namespace telemetry
@@ -0,0 +1,228 @@
+/**
+ * @brief Implementation details of the host-side log format string table.
+ */
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+#include "log_table.h"
+#include "protocol/log_token.h"
+
+namespace telemetry
+{
+namespace
+{
+/**
+ * @brief Structure holding ELF file parameters.
+ */
+struct ElfParam
+{
+    /** Size of the ELF identification field. */
+    static constexpr std::size_t IdentSize{16U};
+
+    /** Index of the file class in the identification field. */
+    static constexpr std::size_t ClassIndex{4U};
+
+    /** Index of the data encoding in the identification field. */
+    static constexpr std::size_t DataIndex{5U};
+
+    /** 32-bit file class. */
+    static constexpr std::uint8_t Class32{1U};
+
+    /** 64-bit file class. */
+    static constexpr std::uint8_t Class64{2U};
+
+    /** Little-endian data encoding. */
+    static constexpr std::uint8_t LittleEndian{1U};
+};
+
+/**
+ * @brief Structure holding the location of a section in an ELF file.
+ */
+struct Section
+{
+    /** Offset of the section name in the section name string table. */
+    std::uint32_t name;
+
+    /** Offset of the section in the file. */
+    std::uint64_t offset;
+
+    /** Size of the section in bytes. */
+    std::uint64_t size;
+};
+
+// -----------------------------------------------------------------------------
+std::uint64_t readLittleEndian(const std::vector<std::uint8_t>& data, const std::uint64_t offset,
+                               const std::size_t size)
+{
+    std::uint64_t value{};
+    if (data.size() < offset + size) { return 0U; }
+
+    for (std::size_t i{}; i < size; ++i)
+    {
+        value |= static_cast<std::uint64_t>(data[offset + i]) << (8U * i);
+    }
+    return value;
+}
+
+// -----------------------------------------------------------------------------
+bool readSections(const std::vector<std::uint8_t>& data, std::vector<Section>& sections,
+                  std::size_t& nameTableIndex)
+{
+    if ((ElfParam::IdentSize > data.size()) || (0 != std::memcmp(data.data(), "\x7F" "ELF", 4U))
+        || (ElfParam::LittleEndian != data[ElfParam::DataIndex])) { return false; }
+
+    // The ELF header and section header fields are at different offsets in 32-bit and 64-bit files.
+    const bool is64Bit{ElfParam::Class64 == data[ElfParam::ClassIndex]};
+    if (!is64Bit && (ElfParam::Class32 != data[ElfParam::ClassIndex])) { return false; }
+    const std::size_t addressSize{is64Bit ? 8U : 4U};
+
+    const auto headerOffset{readLittleEndian(data, is64Bit ? 0x28U : 0x20U, addressSize)};
+    const auto headerSize{readLittleEndian(data, is64Bit ? 0x3AU : 0x2EU, 2U)};
+    const auto headerCount{readLittleEndian(data, is64Bit ? 0x3CU : 0x30U, 2U)};
+    nameTableIndex = readLittleEndian(data, is64Bit ? 0x3EU : 0x32U, 2U);
+    if ((0U == headerOffset) || (data.size() < headerOffset + headerSize * headerCount))
+    {
+        return false;
+    }
+
+    for (std::uint64_t i{}; i < headerCount; ++i)
+    {
+        const std::uint64_t header{headerOffset + i * headerSize};
+        Section section{};
+        section.name   = static_cast<std::uint32_t>(readLittleEndian(data, header, 4U));
+        section.offset = readLittleEndian(data, header + (is64Bit ? 0x18U : 0x10U), addressSize);
+        section.size   = readLittleEndian(data, header + (is64Bit ? 0x20U : 0x14U), addressSize);
+        sections.push_back(section);
+    }
+    return nameTableIndex < sections.size();
+}
+
+// -----------------------------------------------------------------------------
+std::string rawMessage(const protocol::LogMessage& message)
+{
+    char text[16U]{};
+    std::snprintf(text, sizeof(text), "<log %08X", message.token);
+    std::string result{text};
+
+    for (std::uint8_t i{}; i < message.argSize; ++i)
+    {
+        std::snprintf(text, sizeof(text), " %02X", message.args[i]);
+        result += text;
+    }
+    return result + ">";
+}
+} // namespace
+
+// -----------------------------------------------------------------------------
+bool LogTable::load(const std::string& path)
+{
+    std::ifstream file{path, std::ios::binary};
+    const std::vector<std::uint8_t> data{std::istreambuf_iterator<char>{file},
+                                         std::istreambuf_iterator<char>{}};
+    std::vector<Section> sections{};
+    std::size_t nameTableIndex{};
+    if (!readSections(data, sections, nameTableIndex)) { return false; }
+    const Section& names{sections[nameTableIndex]};
+
+    for (const auto& section : sections)
+    {
+        const std::uint64_t nameOffset{names.offset + section.name};
+        if ((data.size() < nameOffset + sizeof(protocol::log::SectionName))
+            || (0 != std::memcmp(&data[nameOffset], protocol::log::SectionName,
+                                 sizeof(protocol::log::SectionName)))) { continue; }
+        if (data.size() < section.offset + section.size) { return false; }
+
+        // The section consists of null-terminated format strings.
+        const char* it{reinterpret_cast<const char*>(&data[section.offset])};
+        const char* end{it + section.size};
+
+        while (it < end)
+        {
+            const std::size_t length{strnlen(it, static_cast<std::size_t>(end - it))};
+            if (0U < length) { add(std::string{it, length}); }
+            it += length + 1U;
+        }
+        return true;
+    }
+    return false;
+}
+
+// -----------------------------------------------------------------------------
+void LogTable::add(const std::string& format)
+{
+    myFormats[protocol::log::token(format.c_str())] = format;
+}
+
+// -----------------------------------------------------------------------------
+std::size_t LogTable::size() const noexcept { return myFormats.size(); }
+
+// -----------------------------------------------------------------------------
+std::string LogTable::format(const protocol::LogMessage& message) const
+{
+    const auto entry{myFormats.find(message.token)};
+    if (myFormats.end() == entry) { return rawMessage(message); }
+    const std::string& format{entry->second};
+    std::string result{};
+    std::size_t offset{};
+
+    for (std::size_t i{}; i < format.size(); ++i)
+    {
+        if ('%' != format[i])
+        {
+            result += format[i];
+            continue;
+        }
+
+        // Parse the specifier (flags, width, precision and length), see utils/format.h.
+        const std::size_t start{i++};
+        while ((i < format.size()) && std::strchr("0123456789.", format[i])) { ++i; }
+        const bool isLong{(i < format.size()) && ('l' == format[i])};
+        if (isLong) { ++i; }
+        if (i >= format.size()) { return rawMessage(message); }
+
+        const char conversion{format[i]};
+        if ('%' == conversion)
+        {
+            result += '%';
+            continue;
+        }
+
+        // Print the argument with the equivalent printf specifier.
+        const std::uint8_t size{protocol::log::argSize(conversion, isLong)};
+        if ((0U == size) || (message.argSize < offset + size)) { return rawMessage(message); }
+        const std::uint32_t value{static_cast<std::uint32_t>(
+            readLittleEndian({message.args + offset, message.args + offset + size}, 0U, size))};
+        offset += size;
+
+        std::string specifier{format.substr(start, i - start)};
+        if (isLong) { specifier.pop_back(); }
+        specifier += conversion;
+        char text[64U]{};
+
+        if ('f' == conversion)
+        {
+            float number{};
+            std::memcpy(&number, &value, sizeof(number));
+            std::snprintf(text, sizeof(text), specifier.c_str(), static_cast<double>(number));
+        }
+        else if (('d' == conversion) || ('i' == conversion))
+        {
+            const long number{4U == size ? static_cast<std::int32_t>(value)
+                                         : static_cast<std::int16_t>(value)};
+            specifier.insert(specifier.size() - 1U, "l");
+            std::snprintf(text, sizeof(text), specifier.c_str(), number);
+        }
+        else if ('c' == conversion) { std::snprintf(text, sizeof(text), "%c", static_cast<int>(value)); }
+        else
+        {
+            specifier.insert(specifier.size() - 1U, "l");
+            std::snprintf(text, sizeof(text), specifier.c_str(), static_cast<unsigned long>(value));
+        }
+        result += text;
+    }
+    return result;
+}
+} // namespace telemetry
@@ -0,0 +1,65 @@
+/**
+ * @brief Host-side table of tokenized log format strings.
+ */
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+#include "protocol/packet.h"
+
+namespace telemetry
+{
+/**
+ * @brief Table mapping log message tokens to format strings.
+ *
+ *        The format strings are extracted from the log section of the firmware ELF file, see
+ *        protocol/tokenized_log.h, and used to reconstruct the text of received log messages.
+ */
+class LogTable final
+{
+public:
+    /**
+     * @brief Create a new empty log table.
+     */
+    LogTable() = default;
+
+    /**
+     * @brief Add the format strings in the log section of the given ELF file.
+     *
+     * @param[in] path Path to the ELF file (32-bit or 64-bit, little-endian).
+     *
+     * @return True if the log section was found, false otherwise.
+     */
+    bool load(const std::string& path);
+
+    /**
+     * @brief Add the given format string.
+     *
+     * @param[in] format The format string to add.
+     */
+    void add(const std::string& format);
+
+    /**
+     * @brief Get the number of format strings in the table.
+     *
+     * @return The number of format strings.
+     */
+    std::size_t size() const noexcept;
+
+    /**
+     * @brief Reconstruct the text of the given log message.
+     *
+     * @param[in] message The log message.
+     *
+     * @return The text of the log message, or a placeholder holding the token and the raw
+     *         arguments if the token is unknown or the arguments don't match the format string.
+     */
+    std::string format(const protocol::LogMessage& message) const;
+
+private:
+    /** Format strings by token. */
+    std::unordered_map<std::uint32_t, std::string> myFormats;
+};
+} // namespace telemetry
@@ -0,0 +1,195 @@
+/**
+ * @brief Host-side telemetry decoder.
+ * 
+ *        Read a binary telemetry stream from a serial port, a pty, a pipe or stdin and print the 
+ *        decoded packets, one per line. Tokenized log messages are printed as text if the 
+ *        firmware ELF file is given, since the format strings are extracted from it. Run with 
+ *        --selftest to verify the encode/decode path without any hardware.
+ * 
+ *        Usage: telemetry_decoder [--selftest | [--elf <firmware.elf>] [<path>]]
+ */
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+#include "decoder.h"
+#include "log_table.h"
+#include "protocol/log_token.h"
+#include "protocol/packet.h"
+
+namespace
+{
+// -----------------------------------------------------------------------------
+void printPacket(const telemetry::LogTable& logTable, const protocol::Packet& packet)
+{
+    switch (packet.type)
+    {
+        case protocol::PacketType::AdcSample:
+            std::printf("[%3u] adc channel=%u code=%u\n", packet.sequence, 
+                        packet.adcSample.channel, packet.adcSample.code);
+            break;
+        case protocol::PacketType::Prediction:
+            std::printf("[%3u] prediction input=%u mV output=%.1f C\n", packet.sequence,
+                        packet.prediction.input_mV, packet.prediction.output_dC / 10.0);
+            break;
+        case protocol::PacketType::Counters:
+            std::printf("[%3u] counters predictions=%u button_presses=%u dropped_tx=%u "
+                        "lost_rx=%u\n", packet.sequence, packet.counters.predictionCount, 
+                        packet.counters.buttonPressCount, packet.counters.droppedTxByteCount, 
+                        packet.counters.lostRxByteCount);
+            break;
+        case protocol::PacketType::LogMessage:
+        {
+            // Log messages usually end with a new line, which is printed once.
+            std::string text{logTable.format(packet.logMessage)};
+            if (!text.empty() && ('\n' == text.back())) { text.pop_back(); }
+            std::printf("[%3u] log %s\n", packet.sequence, text.c_str());
+            break;
+        }
+        default:
+            break;
+    }
+    std::fflush(stdout);
+}
+
+// -----------------------------------------------------------------------------
+void printStatistics(const telemetry::StreamDecoder& decoder)
+{
+    const auto& stats{decoder.statistics()};
+    std::fprintf(stderr, "packets=%zu invalid_frames=%zu lost_packets=%zu\n",
+                 stats.packetCount, stats.invalidFrameCount, stats.lostPacketCount);
+}
+
+// -----------------------------------------------------------------------------
+int decodeStream(const int fd, const telemetry::LogTable& logTable)
+{
+    std::uint8_t buffer[256U]{};
+    telemetry::StreamDecoder decoder{[&logTable](const protocol::Packet& packet) 
+    { 
+        printPacket(logTable, packet); 
+    }};
+
+    while (true)
+    {
+        const auto count{read(fd, buffer, sizeof(buffer))};
+        if (0 >= count) { break; }
+        decoder.feed(buffer, static_cast<std::size_t>(count));
+    }
+    printStatistics(decoder);
+    return 0;
+}
+
+// -----------------------------------------------------------------------------
+void append(std::vector<std::uint8_t>& stream, const protocol::Packet& packet)
+{
+    std::uint8_t frame[protocol::packet::MaxFrameSize]{};
+    const auto size{protocol::packet::encode(packet, frame)};
+    stream.insert(stream.end(), frame, frame + size);
+}
+
+// -----------------------------------------------------------------------------
+int runSelfTest()
+{
+    std::vector<std::uint8_t> stream{};
+    protocol::Packet packet{};
+
+    // Packets containing zero bytes, which must be stuffed by the COBS encoding.
+    packet.type      = protocol::PacketType::AdcSample;
+    packet.sequence  = 0U;
+    packet.adcSample = {2U, 0x0300U};
+    append(stream, packet);
+
+    packet.type       = protocol::PacketType::Prediction;
+    packet.sequence   = 1U;
+    packet.prediction = {1234U, -200};
+    append(stream, packet);
+
+    // Text mixed into the stream, such as shell output, must be skipped.
+    const char text[]{"Input: 1234 mV, predicted output: -20.0!\n"};
+    stream.insert(stream.end(), text, text + std::strlen(text));
+    stream.push_back(protocol::cobs::Delimiter);
+
+    // A corrupted frame must be rejected by the CRC.
+    packet.type     = protocol::PacketType::Counters;
+    packet.sequence = 2U;
+    packet.counters = {100U, 0U, 3U, 70000U};
+    append(stream, packet);
+    stream[stream.size() - 4U] ^= 0x10U;
+
+    // Sequence number 3 is skipped, i.e. one packet is lost.
+    packet.sequence = 4U;
+    append(stream, packet);
+
+    // Tokenized log message with a 16-bit unsigned integer and a float (21.5) argument.
+    const char logFormat[]{"Input: %u mV, predicted output: %.1f!\n"};
+    packet.type       = protocol::PacketType::LogMessage;
+    packet.sequence   = 5U;
+    packet.logMessage = {protocol::log::token(logFormat), 6U, {0xD2U, 0x04U, 0x00U, 0x00U, 0xACU, 0x41U}};
+    append(stream, packet);
+
+    // Feed the stream in small chunks, like reads from a serial port.
+    std::vector<protocol::Packet> packets{};
+    telemetry::StreamDecoder decoder{[&packets](const protocol::Packet& p) { packets.push_back(p); }};
+    for (std::size_t i{}; i < stream.size(); i += 5U)
+    {
+        decoder.feed(stream.data() + i, stream.size() - i < 5U ? stream.size() - i : 5U);
+    }
+
+    telemetry::LogTable logTable{};
+    logTable.add(logFormat);
+
+    const auto& stats{decoder.statistics()};
+    const bool passed{(4U == packets.size()) && (2U == stats.invalidFrameCount) 
+        && (2U == stats.lostPacketCount)
+        && (protocol::PacketType::AdcSample == packets[0U].type)
+        && (0x0300U == packets[0U].adcSample.code)
+        && (-200 == packets[1U].prediction.output_dC)
+        && (70000U == packets[2U].counters.lostRxByteCount)
+        && ("Input: 1234 mV, predicted output: 21.5!\n" == logTable.format(packets[3U].logMessage))};
+
+    for (const auto& p : packets) { printPacket(logTable, p); }
+    printStatistics(decoder);
+    std::printf("Self test %s!\n", passed ? "passed" : "failed");
+    return passed ? 0 : 1;
+}
+} // namespace
+
+// -----------------------------------------------------------------------------
+int main(int argc, char** argv)
+{
+    if ((2 == argc) && (0 == std::strcmp(argv[1], "--selftest"))) { return runSelfTest(); }
+    telemetry::LogTable logTable{};
+    int arg{1};
+
+    // Load the log format strings from the firmware ELF file, if given.
+    if ((3 <= argc) && (0 == std::strcmp(argv[1], "--elf")))
+    {
+        if (!logTable.load(argv[2]))
+        {
+            std::fprintf(stderr, "%s: No log section found!\n", argv[2]);
+            return 1;
+        }
+        std::fprintf(stderr, "Loaded %zu log format strings\n", logTable.size());
+        arg = 3;
+    }
+    if (arg + 1 < argc)
+    {
+        std::fprintf(stderr, "Usage: %s [--selftest | [--elf <firmware.elf>] [<path>]]\n", argv[0]);
+        return 1;
+    }
+
+    // Read from the given path (serial port, pty or pipe), or from stdin if none is given.
+    const char* path{arg < argc ? argv[arg] : nullptr};
+    const int fd{nullptr != path ? open(path, O_RDONLY | O_NOCTTY) : STDIN_FILENO};
+    if (0 > fd)
+    {
+        std::perror(path);
+        return 1;
+    }
+    const int result{decodeStream(fd, logTable)};
+    if (STDIN_FILENO != fd) { close(fd); }
+    return result;
+}
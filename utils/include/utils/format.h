@@ -0,0 +1,344 @@
+/**
+ * @brief Type-safe string formatting without heap allocation or intermediate buffers.
+ *
+ *        The supported format specifiers are a subset of the printf specifiers:
+ *
+ *            - %d, %i:  Signed integer (%ld, %li for long).
+ *            - %u:      Unsigned integer (%lu for long).
+ *            - %x, %X:  Unsigned hexadecimal integer (%lx, %lX for long).
+ *            - %f:      Floating point number or fixed point number (see utils::format::Fixed).
+ *            - %c:      Character.
+ *            - %s:      String.
+ *            - %%:      Percent sign.
+ *
+ *        A minimum field width may be given (e.g. %4d), padded with zeros if it starts with a zero
+ *        (e.g. %04X). Floating point numbers are printed with six decimals unless a precision is
+ *        given (e.g. %.2f). The maximum precision is nine decimals.
+ *
+ *        Format strings created with the _fmt literal are checked against the argument types
+ *        at compile time:
+ *
+ *            using namespace utils::format::literals;
+ *            serial.printf("Input: %d mV, temperature: %.1f C\n"_fmt, mV, temp);
+ *
+ *        Format strings created with the _fmt_P literal are checked the same way, but are kept in
+ *        flash memory rather than being copied to RAM at startup:
+ *
+ *            serial.printf_P("Input: %d mV, temperature: %.1f C\n"_fmt_P, mV, temp);
+ */
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <avr/pgmspace.h>
+
+#include "utils/type_traits.h"
+
+namespace utils
+{
+namespace format
+{
+/**
+ * @brief Output to which formatted characters are written.
+ */
+class Output
+{
+public:
+    /**
+     * @brief Delete the output.
+     */
+    virtual ~Output() noexcept = default;
+
+    /**
+     * @brief Write the given character to the output.
+     *
+     * @param[in] character The character to write.
+     */
+    virtual void put(const char character) const = 0;
+};
+
+/**
+ * @brief Fixed point number, i.e. an integer scaled by 10 ^ decimals.
+ *
+ *        Fixed{12345, 3} is for instance printed as 12.345.
+ */
+struct Fixed
+{
+    /** The scaled value. */
+    int32_t value;
+
+    /** The number of decimals (max 9). */
+    uint8_t decimals;
+};
+
+/** Enumeration of argument types. */
+enum class Type : uint8_t;
+
+/** Format specifier. */
+struct Specifier;
+
+/** Type-erased format argument. */
+class Argument;
+
+/**
+ * @brief Format string checked at compile time, created with the _fmt literal.
+ *
+ * @tparam Chars The characters of the format string.
+ */
+template <char... Chars>
+struct String
+{
+    /** The format string as a null-terminated character array. */
+    static constexpr char value[]{Chars..., '\0'};
+};
+
+/**
+ * @brief Format string stored in flash memory, created with the _fmt_P literal.
+ *
+ *        The string can't be converted to a RAM pointer, hence it can only be printed by the
+ *        print functions reading the format string from flash memory.
+ *
+ * @tparam Chars The characters of the format string.
+ */
+template <char... Chars>
+struct ProgmemString
+{
+    /** The format string as a null-terminated character array in flash memory. */
+    static constexpr char value[] PROGMEM{Chars..., '\0'};
+};
+
+/**
+ * @brief Check whether the given format string matches the given argument types.
+ *
+ * @tparam Args The argument types.
+ *
+ * @param[in] format The format string to check.
+ *
+ * @return True if the format string matches the argument types, false otherwise.
+ */
+template <typename... Args>
+constexpr bool isValid(const char* format) noexcept;
+
+/**
+ * @brief Write formatted string with type-erased arguments to the given output.
+ *
+ * @param[in] output The output to write to.
+ * @param[in] format The format string.
+ * @param[in] args Pointer to the arguments to insert in the format string.
+ * @param[in] argCount The number of arguments.
+ */
+void vprint(const Output& output, const char* format, const Argument* args,
+            const size_t argCount) noexcept;
+
+/**
+ * @brief Write formatted string to the given output.
+ *
+ * @tparam Args The argument types.
+ *
+ * @param[in] output The output to write to.
+ * @param[in] format The format string.
+ * @param[in] args The arguments to insert in the format string.
+ */
+template <typename... Args>
+void print(const Output& output, const char* format, const Args&... args) noexcept;
+
+/**
+ * @brief Write formatted string with type-erased arguments to the given output, reading the
+ *        format string from flash memory.
+ *
+ * @param[in] output The output to write to.
+ * @param[in] format Pointer to the format string in flash memory.
+ * @param[in] args Pointer to the arguments to insert in the format string.
+ * @param[in] argCount The number of arguments.
+ */
+void vprint_P(const Output& output, const char* format, const Argument* args,
+              const size_t argCount) noexcept;
+
+/**
+ * @brief Write formatted string stored in flash memory to the given output.
+ *
+ *        The format string is checked against the argument types at compile time.
+ *
+ * @tparam Chars The characters of the format string.
+ * @tparam Args The argument types.
+ *
+ * @param[in] output The output to write to.
+ * @param[in] format Format string created with the _fmt_P literal.
+ * @param[in] args The arguments to insert in the format string.
+ */
+template <char... Chars, typename... Args>
+void print(const Output& output, const ProgmemString<Chars...>& format,
+           const Args&... args) noexcept;
+
+namespace literals
+{
+/**
+ * @brief Create a format string which is checked at compile time.
+ *
+ * @tparam CharT The character type.
+ * @tparam Chars The characters of the format string.
+ *
+ * @return The format string.
+ */
+template <typename CharT, CharT... Chars>
+constexpr String<Chars...> operator""_fmt() noexcept;
+
+/**
+ * @brief Create a format string which is checked at compile time and stored in flash memory.
+ *
+ * @tparam CharT The character type.
+ * @tparam Chars The characters of the format string.
+ *
+ * @return The format string.
+ */
+template <typename CharT, CharT... Chars>
+constexpr ProgmemString<Chars...> operator""_fmt_P() noexcept;
+} // namespace literals
+
+/**
+ * @brief Enumeration of argument types.
+ */
+enum class Type : uint8_t
+{
+    Signed,     // Signed integer.
+    Unsigned,   // Unsigned integer.
+    Floating,   // Floating point number.
+    FixedPoint, // Fixed point number.
+    Character,  // Character.
+    String,     // String.
+    Invalid,    // Unsupported type.
+};
+
+/**
+ * @brief Format specifier, parsed one character at a time.
+ */
+struct Specifier
+{
+    /** Indicator for no precision given. */
+    static constexpr uint8_t NoPrecision{0xFFU};
+
+    /** Parser state. */
+    enum class State : uint8_t { Flags, Width, Precision, Length, Done };
+
+    /**
+     * @brief Parse the next character of the specifier (following the percent sign).
+     *
+     * @param[in] character The character to parse.
+     *
+     * @return True if the specifier is complete, false if more characters are expected.
+     */
+    constexpr bool parse(const char character) noexcept;
+
+    /**
+     * @brief Check whether the specifier accepts an argument of the given type.
+     *
+     * @param[in] type The argument type.
+     * @param[in] size The argument size in bytes.
+     *
+     * @return True if the argument type is accepted, false otherwise.
+     */
+    constexpr bool accepts(const Type type, const size_t size) const noexcept;
+
+    /** Conversion character, e.g. 'd'. */
+    char conversion{'\0'};
+
+    /** Minimum field width. */
+    uint8_t width{0U};
+
+    /** Precision (number of decimals). */
+    uint8_t precision{NoPrecision};
+
+    /** Indicate whether to pad with zeros rather than spaces. */
+    bool zeroPad{false};
+
+    /** Indicate whether the long length modifier was given. */
+    bool isLong{false};
+
+    /** Parser state. */
+    State state{State::Flags};
+};
+
+/**
+ * @brief Type-erased format argument.
+ */
+class Argument
+{
+public:
+    /**
+     * @brief Create a new argument.
+     *
+     * @tparam T The argument type.
+     *
+     * @param[in] value The argument value.
+     */
+    template <typename T>
+    Argument(const T& value) noexcept;
+
+    /**
+     * @brief Get the type of the argument.
+     *
+     * @return The argument type.
+     */
+    Type type() const noexcept;
+
+    /**
+     * @brief Get the argument as a signed integer.
+     *
+     * @return The argument value.
+     */
+    int32_t asSigned() const noexcept;
+
+    /**
+     * @brief Get the argument as an unsigned integer.
+     *
+     * @return The argument value.
+     */
+    uint32_t asUnsigned() const noexcept;
+
+    /**
+     * @brief Get the argument as a floating point number.
+     *
+     * @return The argument value.
+     */
+    double asFloating() const noexcept;
+
+    /**
+     * @brief Get the argument as a fixed point number.
+     *
+     * @return The argument value.
+     */
+    const Fixed& asFixed() const noexcept;
+
+    /**
+     * @brief Get the argument as a character.
+     *
+     * @return The argument value.
+     */
+    char asCharacter() const noexcept;
+
+    /**
+     * @brief Get the argument as a string.
+     *
+     * @return The argument value.
+     */
+    const char* asString() const noexcept;
+
+private:
+    /** The argument value. */
+    union
+    {
+        int32_t mySigned;
+        uint32_t myUnsigned;
+        double myFloating;
+        Fixed myFixed;
+        char myCharacter;
+        const char* myString;
+    };
+
+    /** The argument type. */
+    Type myType;
+};
+} // namespace format
+} // namespace utils
+
+#include "impl/format_impl.h"
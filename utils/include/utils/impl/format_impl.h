@@ -0,0 +1,252 @@
+/**
+ * @brief Implementation details of type-safe string formatting.
+ *
+ * @note Don't include this header, use <format.h> instead!
+ */
+#pragma once
+
+namespace utils
+{
+namespace format
+{
+namespace detail
+{
+/**
+ * @brief Get the format type of the given argument type.
+ *
+ * @tparam T The argument type.
+ */
+template <typename T>
+struct TypeOf
+{
+    static constexpr Type value{type_traits::is_signed<T>::value          ? Type::Signed   :
+                                type_traits::is_unsigned<T>::value        ? Type::Unsigned :
+                                type_traits::is_floating_point<T>::value  ? Type::Floating :
+                                type_traits::is_string<T>::value          ? Type::String   :
+                                                                            Type::Invalid};
+};
+
+/**
+ * @brief Specialization for characters.
+ */
+template <>
+struct TypeOf<char>
+{
+    static constexpr Type value{Type::Character};
+};
+
+/**
+ * @brief Specialization for fixed point numbers.
+ */
+template <>
+struct TypeOf<Fixed>
+{
+    static constexpr Type value{Type::FixedPoint};
+};
+
+/**
+ * @brief Specialization for string literals and character arrays.
+ */
+template <size_t Size>
+struct TypeOf<char[Size]>
+{
+    static constexpr Type value{Type::String};
+};
+
+// -----------------------------------------------------------------------------
+constexpr bool isDigit(const char character) noexcept
+{
+    return ('0' <= character) && ('9' >= character);
+}
+
+// -----------------------------------------------------------------------------
+constexpr bool validate(const char* format, const Type* types, const size_t* sizes,
+                        const size_t count) noexcept
+{
+    size_t index{};
+    const char* it{format};
+
+    while (*it)
+    {
+        if ('%' != *it++) { continue; }
+
+        // Parse the specifier, the format string must not end in the middle of it.
+        Specifier specifier{};
+        while (*it && !specifier.parse(*it++));
+        if (Specifier::State::Done != specifier.state) { return false; }
+        if ('%' == specifier.conversion) { continue; }
+
+        // Check that there is a matching argument for the specifier.
+        if ((index >= count) || !specifier.accepts(types[index], sizes[index])) { return false; }
+        ++index;
+    }
+    // Check that all arguments were used.
+    return count == index;
+}
+} // namespace detail
+
+// -----------------------------------------------------------------------------
+constexpr bool Specifier::parse(const char character) noexcept
+{
+    if ((State::Flags == state) && ('0' == character))
+    {
+        zeroPad = true;
+        state   = State::Width;
+    }
+    else if ((State::Width >= state) && detail::isDigit(character))
+    {
+        width = static_cast<uint8_t>(width * 10U + (character - '0'));
+        state = State::Width;
+    }
+    else if ((State::Precision > state) && ('.' == character))
+    {
+        precision = 0U;
+        state     = State::Precision;
+    }
+    else if ((State::Precision == state) && detail::isDigit(character))
+    {
+        precision = static_cast<uint8_t>(precision * 10U + (character - '0'));
+    }
+    else if ((State::Length > state) && ('l' == character))
+    {
+        isLong = true;
+        state  = State::Length;
+    }
+    else
+    {
+        conversion = character;
+        state      = State::Done;
+    }
+    return State::Done == state;
+}
+
+// -----------------------------------------------------------------------------
+constexpr bool Specifier::accepts(const Type type, const size_t size) const noexcept
+{
+    const size_t maxSize{isLong ? sizeof(long) : sizeof(int)};
+
+    switch (conversion)
+    {
+        case 'd':
+        case 'i':
+            // Unsigned integers are only accepted if they are promoted to a wider signed type.
+            return ((Type::Signed == type) && (maxSize >= size))
+                || ((Type::Unsigned == type) && (maxSize > size));
+        case 'u':
+        case 'x':
+        case 'X':
+            return ((Type::Signed == type) || (Type::Unsigned == type)) && (maxSize >= size);
+        case 'f':
+            return (Type::Floating == type) || (Type::FixedPoint == type);
+        case 'c':
+            return Type::Character == type;
+        case 's':
+            return Type::String == type;
+        default:
+            return false;
+    }
+}
+
+// -----------------------------------------------------------------------------
+template <typename T>
+Argument::Argument(const T& value) noexcept
+    : myType{detail::TypeOf<T>::value}
+{
+    // Generate a compiler error if the given type can't be formatted.
+    static_assert(Type::Invalid != detail::TypeOf<T>::value, "Unsupported format argument type!");
+
+    if constexpr (Type::Signed == detail::TypeOf<T>::value)
+    {
+        mySigned = static_cast<int32_t>(value);
+    }
+    else if constexpr (Type::Unsigned == detail::TypeOf<T>::value)
+    {
+        myUnsigned = static_cast<uint32_t>(value);
+    }
+    else if constexpr (Type::Floating == detail::TypeOf<T>::value) { myFloating = value; }
+    else if constexpr (Type::FixedPoint == detail::TypeOf<T>::value) { myFixed = value; }
+    else if constexpr (Type::Character == detail::TypeOf<T>::value) { myCharacter = value; }
+    else { myString = value; }
+}
+
+// -----------------------------------------------------------------------------
+inline Type Argument::type() const noexcept { return myType; }
+
+// -----------------------------------------------------------------------------
+inline int32_t Argument::asSigned() const noexcept { return mySigned; }
+
+// -----------------------------------------------------------------------------
+inline uint32_t Argument::asUnsigned() const noexcept { return myUnsigned; }
+
+// -----------------------------------------------------------------------------
+inline double Argument::asFloating() const noexcept { return myFloating; }
+
+// -----------------------------------------------------------------------------
+inline const Fixed& Argument::asFixed() const noexcept { return myFixed; }
+
+// -----------------------------------------------------------------------------
+inline char Argument::asCharacter() const noexcept { return myCharacter; }
+
+// -----------------------------------------------------------------------------
+inline const char* Argument::asString() const noexcept { return myString; }
+
+// -----------------------------------------------------------------------------
+template <typename... Args>
+constexpr bool isValid(const char* format) noexcept
+{
+    // Add a trailing element to avoid zero-sized arrays.
+    constexpr Type types[]{detail::TypeOf<Args>::value..., Type::Invalid};
+    constexpr size_t sizes[]{sizeof(Args)..., 0U};
+    return detail::validate(format, types, sizes, sizeof...(Args));
+}
+
+// -----------------------------------------------------------------------------
+template <typename... Args>
+void print(const Output& output, const char* format, const Args&... args) noexcept
+{
+    if constexpr (0U == sizeof...(Args)) { vprint(output, format, nullptr, 0U); }
+    else
+    {
+        const Argument arguments[]{Argument{args}...};
+        vprint(output, format, arguments, sizeof...(Args));
+    }
+}
+
+// -----------------------------------------------------------------------------
+template <char... Chars, typename... Args>
+void print(const Output& output, const ProgmemString<Chars...>& format,
+           const Args&... args) noexcept
+{
+    // Generate a compiler error if the format string doesn't match the arguments.
+    static_assert(isValid<Args...>(ProgmemString<Chars...>::value),
+        "Format string doesn't match the argument types!");
+    (void) format;
+
+    if constexpr (0U == sizeof...(Args)) { vprint_P(output, ProgmemString<Chars...>::value, nullptr, 0U); }
+    else
+    {
+        const Argument arguments[]{Argument{args}...};
+        vprint_P(output, ProgmemString<Chars...>::value, arguments, sizeof...(Args));
+    }
+}
+
+namespace literals
+{
+// -----------------------------------------------------------------------------
+template <typename CharT, CharT... Chars>
+constexpr String<Chars...> operator""_fmt() noexcept
+{
+    static_assert(sizeof(CharT) == sizeof(char), "Format strings must be narrow strings!");
+    return String<Chars...>{};
+}
+
+// -----------------------------------------------------------------------------
+template <typename CharT, CharT... Chars>
+constexpr ProgmemString<Chars...> operator""_fmt_P() noexcept
+{
+    static_assert(sizeof(CharT) == sizeof(char), "Format strings must be narrow strings!");
+    return ProgmemString<Chars...>{};
+}
+} // namespace literals
+} // namespace format
+} // namespace utils
@@ -31,7 +31,7 @@ constexpr void set(volatile T& reg, const uint8_t bit) noexcept
 
 // -----------------------------------------------------------------------------
 template <typename T, typename... Bits>
-constexpr void set(volatile T& reg, const uint8_t bit, const Bits&&... bits)  
+constexpr void set(volatile T& reg, const uint8_t bit, const Bits&&... bits) noexcept
 {
     static_assert(type_traits::is_unsigned<T>::value, "Invalid data type used for bit operation!");
     set(reg, bit);
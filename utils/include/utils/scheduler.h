@@ -0,0 +1,162 @@
+/**
+ * @brief Cooperative task scheduler with idle sleep.
+ */
+#pragma once
+
+#include <stdint.h>
+
+namespace utils
+{
+/**
+ * @brief Cooperative task scheduler, running statically allocated tasks to completion.
+ *
+ *        A task is activated periodically, by signal, or both. Whenever several tasks are
+ *        ready, the task with the highest priority is run; tasks of equal priority are run in
+ *        the order they were added. Tasks are never preempted, hence a task must return
+ *        within a bounded time, and a task signaled perpetually starves lower priorities.
+ *
+ *        The CPU is put in idle sleep while no task is ready. Any interrupt wakes the CPU,
+ *        hence the timers and the serial port keep running and a signal sent from an
+ *        interrupt service routine is handled right after it returns.
+ *
+ *        Periodic activation and the runtime statistics are based on the clock set via
+ *        setClock, which must count in microseconds. Periodic tasks are never activated while
+ *        no clock is set.
+ */
+class Scheduler final
+{
+public:
+    /** Structure of task runtime statistics. */
+    struct Statistics;
+
+    /** Task function, invoked with the context given when the task was added. */
+    using Task = void (*)(void* context);
+
+    /** Clock in microseconds, used for periodic activation and runtime statistics. */
+    using Clock = uint32_t (*)();
+
+    /** The maximum number of tasks. */
+    static constexpr uint8_t MaxTaskCount{8U};
+
+    /** Identifier returned for tasks that couldn't be added. */
+    static constexpr uint8_t InvalidTask{MaxTaskCount};
+
+    /**
+     * @brief Add a new task.
+     *
+     *        Tasks can only be added, since they're statically allocated.
+     *
+     * @param[in] task The task function.
+     * @param[in] context Context passed to the task function (default = none).
+     * @param[in] priority The task priority, tasks with higher values run first (default = 0).
+     * @param[in] period_ms The activation period in milliseconds, 0 if the task is only
+     *                      activated by signal (default = 0).
+     *
+     * @return The task identifier, Scheduler::InvalidTask if the task is invalid or no more
+     *         tasks can be added.
+     */
+    static uint8_t add(const Task task, void* context = nullptr, const uint8_t priority = 0U,
+                       const uint16_t period_ms = 0U) noexcept;
+
+    /**
+     * @brief Signal a task to run once. This function is interrupt safe.
+     *
+     *        Signals sent before the task runs are only handled once, like an event flag.
+     *
+     * @param[in] task The task identifier.
+     */
+    static void signal(const uint8_t task) noexcept;
+
+    /**
+     * @brief Set the activation period of a task.
+     *
+     *        The task is activated one period from now.
+     *
+     * @param[in] task The task identifier.
+     * @param[in] period_ms The activation period in milliseconds, 0 to disable periodic
+     *                      activation.
+     */
+    static void setPeriod(const uint8_t task, const uint16_t period_ms) noexcept;
+
+    /**
+     * @brief Run the ready task with the highest priority, if any.
+     *
+     * @return True if a task was run, false if no task was ready.
+     */
+    static bool runNext() noexcept;
+
+    /**
+     * @brief Put the CPU in idle sleep unless a task is ready.
+     *
+     *        The CPU is woken by the next interrupt, which doesn't necessarily make a task ready.
+     *        Interrupts must be enabled, otherwise the CPU isn't put to sleep.
+     */
+    static void idle() noexcept;
+
+    /**
+     * @brief Run the tasks perpetually, sleeping whenever no task is ready.
+     */
+    [[noreturn]] static void run() noexcept;
+
+    /**
+     * @brief Get the runtime statistics of a task.
+     *
+     * @param[in] task The task identifier.
+     * @param[out] statistics Reference to the statistics to fill.
+     *
+     * @return True if the statistics were read, false if the task identifier is invalid.
+     */
+    static bool statistics(const uint8_t task, Statistics& statistics) noexcept;
+
+    /**
+     * @brief Get the time spent asleep since the statistics were reset.
+     *
+     * @return The idle time in microseconds, 0 if no clock is set.
+     */
+    static uint32_t idleTime_us() noexcept;
+
+    /**
+     * @brief Get the time elapsed since the statistics were reset.
+     *
+     * @return The elapsed time in microseconds, 0 if no clock is set.
+     */
+    static uint32_t elapsedTime_us() noexcept;
+
+    /**
+     * @brief Reset the runtime statistics of all tasks and the idle time.
+     */
+    static void resetStatistics() noexcept;
+
+    /**
+     * @brief Set the clock used for periodic activation and runtime statistics.
+     *
+     *        Periodic tasks are activated one period from now.
+     *
+     * @param[in] clock The clock in microseconds, or nullptr to disable periodic activation.
+     */
+    static void setClock(const Clock clock) noexcept;
+
+    Scheduler()                            = delete; // No default constructor.
+    Scheduler(const Scheduler&)            = delete; // No copy constructor.
+    Scheduler(Scheduler&&)                 = delete; // No move constructor.
+    Scheduler& operator=(const Scheduler&) = delete; // No copy assignment.
+    Scheduler& operator=(Scheduler&&)      = delete; // No move assignment.
+};
+
+/**
+ * @brief Structure of task runtime statistics.
+ *
+ *        The runtimes wrap around after about 71.6 minutes spent in the task.
+ */
+struct Scheduler::Statistics
+{
+    /** The number of times the task was run. */
+    uint32_t runCount;
+
+    /** The total runtime in microseconds. */
+    uint32_t totalRuntime_us;
+
+    /** The longest runtime in microseconds. */
+    uint32_t maxRuntime_us;
+};
+} // namespace utils
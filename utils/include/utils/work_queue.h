@@ -0,0 +1,130 @@
+/**
+ * @brief Deferred work queue for moving interrupt work to the main loop.
+ */
+#pragma once
+
+#include <stdint.h>
+
+namespace utils
+{
+/** Enumeration of callback modes. */
+enum class CallbackMode : uint8_t;
+
+/**
+ * @brief Deferred work queue, holding work posted from interrupt context until it's
+ *        dispatched in the main loop.
+ *
+ *        Posting only stores a function pointer and a timestamp in a ring buffer, hence
+ *        interrupts stay short, while the work itself runs with interrupts enabled. Work
+ *        posted again before it's dispatched is only queued once, like an event flag.
+ *
+ *        The latency from post to dispatch is measured by the clock set via setClock, the
+ *        worst case is kept until resetStatistics is called.
+ */
+class WorkQueue final
+{
+public:
+    /** Clock used to timestamp posted work. */
+    using Clock = uint32_t (*)();
+
+    /** Callback notifying the main loop of posted work, see setNotifier. */
+    using Notifier = void (*)();
+
+    /** The maximum number of pending work items. */
+    static constexpr uint8_t Capacity{8U};
+
+    /**
+     * @brief Post work to be run in the main loop. This function is interrupt safe.
+     *
+     * @param[in] work The work to run.
+     *
+     * @return True if the work is pending, false if the work is invalid or the queue is full.
+     */
+    static bool post(void (*work)()) noexcept;
+
+    /**
+     * @brief Run the pending work in the order it was posted.
+     *
+     *        This function should be called in the main loop only. Work posted meanwhile is
+     *        left for the next call, hence the main loop can't be starved.
+     *
+     * @return The number of work items run.
+     */
+    static uint8_t dispatch() noexcept;
+
+    /**
+     * @brief Check whether the given work is pending. This function is interrupt safe.
+     *
+     * @param[in] work The work to check.
+     *
+     * @return True if the work is posted but not yet run, false otherwise.
+     */
+    static bool isPending(void (*work)()) noexcept;
+
+    /**
+     * @brief Get the number of pending work items.
+     *
+     * @return The number of pending work items.
+     */
+    static uint8_t pendingCount() noexcept;
+
+    /**
+     * @brief Get the number of work items dropped since the queue was full.
+     *
+     * @return The number of dropped work items.
+     */
+    static uint16_t droppedCount() noexcept;
+
+    /**
+     * @brief Get the worst-case latency from post to dispatch.
+     *
+     * @return The worst-case latency in units of the clock, 0 if no clock is set.
+     */
+    static uint32_t maxLatency() noexcept;
+
+    /**
+     * @brief Get the largest number of pending work items.
+     *
+     * @return The largest number of pending work items.
+     */
+    static uint8_t maxPendingCount() noexcept;
+
+    /**
+     * @brief Reset the latency and queue statistics.
+     */
+    static void resetStatistics() noexcept;
+
+    /**
+     * @brief Set the clock used to timestamp posted work.
+     *
+     * @param[in] clock The clock, or nullptr to disable latency measurements.
+     */
+    static void setClock(const Clock clock) noexcept;
+
+    /**
+     * @brief Set the callback notifying the main loop of posted work.
+     *
+     *        The notifier is invoked by post in the caller's context, typically an interrupt,
+     *        hence it should only signal the main loop, see Scheduler::signal.
+     *
+     * @param[in] notifier The notifier, or nullptr to disable notifications.
+     */
+    static void setNotifier(const Notifier notifier) noexcept;
+
+    WorkQueue()                            = delete; // No default constructor.
+    WorkQueue(const WorkQueue&)            = delete; // No copy constructor.
+    WorkQueue(WorkQueue&&)                 = delete; // No move constructor.
+    WorkQueue& operator=(const WorkQueue&) = delete; // No copy assignment.
+    WorkQueue& operator=(WorkQueue&&)      = delete; // No move assignment.
+};
+
+/**
+ * @brief Enumeration of callback modes, selecting where a driver invokes a callback.
+ */
+enum class CallbackMode : uint8_t
+{
+    Immediate, // Invoke the callback in interrupt context.
+    Deferred,  // Post the callback to the work queue, see WorkQueue::post.
+    Count,     // The number of callback modes available.
+};
+} // namespace utils
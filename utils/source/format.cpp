@@ -0,0 +1,330 @@
+/**
+ * @brief Implementation details of type-safe string formatting.
+ *
+ *        Decimal digits are extracted by repeated subtraction of powers of ten and hexadecimal
+ *        digits by shifting, since division is implemented in software on the target MCU.
+ *
+ *        Format strings are read through a reader function, so the same code is used for format
+ *        strings in RAM and in flash memory.
+ */
+#include <avr/pgmspace.h>
+
+#include "utils/format.h"
+
+namespace utils
+{
+namespace format
+{
+namespace
+{
+/**
+ * @brief Structure holding format parameters.
+ */
+struct FormatParam
+{
+    /** The maximum number of decimal digits of a 32-bit unsigned integer. */
+    static constexpr uint8_t MaxDigitCount{10U};
+
+    /** The maximum number of hexadecimal digits of a 32-bit unsigned integer. */
+    static constexpr uint8_t MaxHexDigitCount{8U};
+
+    /** The maximum number of decimals. */
+    static constexpr uint8_t MaxDecimalCount{9U};
+
+    /** The default number of decimals of floating point numbers. */
+    static constexpr uint8_t DefaultDecimalCount{6U};
+
+    /** Largest floating point number that can be printed. */
+    static constexpr double MaxFloating{4294967295.0};
+
+    /** Character printed for arguments that don't match the specifier. */
+    static constexpr char Mismatch{'?'};
+
+    /** String printed for floating point numbers that aren't numbers. */
+    static constexpr char NotANumber[] PROGMEM{"nan"};
+
+    /** String printed for floating point numbers too large to be printed. */
+    static constexpr char Overflow[] PROGMEM{"ovf"};
+};
+
+/** Pointer to function reading a character of a string at the given address. */
+using Reader = char (*)(const char* address);
+
+/** Powers of ten used for extracting decimal digits, most significant first (in flash memory). */
+constexpr uint32_t powersOfTen[FormatParam::MaxDigitCount] PROGMEM
+{
+    1000000000UL, 100000000UL, 10000000UL, 1000000UL, 100000UL,
+    10000UL, 1000UL, 100UL, 10UL, 1UL,
+};
+
+// -----------------------------------------------------------------------------
+constexpr uint8_t min(const uint8_t x, const uint8_t y) noexcept { return x <= y ? x : y; }
+
+// -----------------------------------------------------------------------------
+inline char readRam(const char* address) noexcept { return *address; }
+
+// -----------------------------------------------------------------------------
+inline char readFlash(const char* address) noexcept 
+{ 
+    return static_cast<char>(pgm_read_byte(address)); 
+}
+
+// -----------------------------------------------------------------------------
+inline uint32_t powerOfTenAt(const uint8_t index) noexcept
+{
+    return pgm_read_dword(&powersOfTen[index]);
+}
+
+// -----------------------------------------------------------------------------
+inline uint32_t powerOfTen(const uint8_t exponent) noexcept
+{
+    return powerOfTenAt(FormatParam::MaxDigitCount - 1U - exponent);
+}
+
+// -----------------------------------------------------------------------------
+uint8_t digitCount(const uint32_t value) noexcept
+{
+    uint8_t count{FormatParam::MaxDigitCount};
+    while ((1U < count) && (value < powerOfTen(count - 1U))) { --count; }
+    return count;
+}
+
+// -----------------------------------------------------------------------------
+uint8_t hexDigitCount(const uint32_t value) noexcept
+{
+    uint8_t count{FormatParam::MaxHexDigitCount};
+    while ((1U < count) && (0U == (value >> (4U * (count - 1U))))) { --count; }
+    return count;
+}
+
+// -----------------------------------------------------------------------------
+void writePadding(const Output& output, const char character, const uint8_t count) noexcept
+{
+    for (uint8_t i{}; i < count; ++i) { output.put(character); }
+}
+
+// -----------------------------------------------------------------------------
+template <Reader read>
+void writeString(const Output& output, const char* str, const uint8_t width) noexcept
+{
+    uint8_t length{};
+    for (const char* it{str}; read(it) && (width > length); ++it) { ++length; }
+    writePadding(output, ' ', width - length);
+    for (const char* it{str}; read(it); ++it) { output.put(read(it)); }
+}
+
+// -----------------------------------------------------------------------------
+void writeDigits(const Output& output, uint32_t value, const uint8_t count,
+                 const uint8_t decimals = 0U) noexcept
+{
+    // Write the given number of least significant digits, insert a decimal point if requested.
+    for (uint8_t i{static_cast<uint8_t>(FormatParam::MaxDigitCount - count)}; i < FormatParam::MaxDigitCount; ++i)
+    {
+        if ((0U < decimals) && ((FormatParam::MaxDigitCount - i) == decimals))
+        {
+            output.put('.');
+        }
+        const uint32_t power{powerOfTenAt(i)};
+        char digit{'0'};
+        while (value >= power)
+        {
+            value -= power;
+            ++digit;
+        }
+        output.put(digit);
+    }
+}
+
+// -----------------------------------------------------------------------------
+void writeSign(const Output& output, const bool negative, const uint8_t length,
+               const Specifier& specifier) noexcept
+{
+    // Write the sign and the padding in the right order, i.e. "-0042" but "  -42".
+    const uint8_t padding{static_cast<uint8_t>(specifier.width > length ? specifier.width - length : 0U)};
+    if (!specifier.zeroPad) { writePadding(output, ' ', padding); }
+    if (negative) { output.put('-'); }
+    if (specifier.zeroPad) { writePadding(output, '0', padding); }
+}
+
+// -----------------------------------------------------------------------------
+void writeInteger(const Output& output, const uint32_t magnitude, const bool negative,
+                  const Specifier& specifier, const uint8_t suffixLength = 0U) noexcept
+{
+    const uint8_t count{digitCount(magnitude)};
+    writeSign(output, negative, count + negative + suffixLength, specifier);
+    writeDigits(output, magnitude, count);
+}
+
+// -----------------------------------------------------------------------------
+void writeSigned(const Output& output, const int32_t value, const Specifier& specifier) noexcept
+{
+    const bool negative{0 > value};
+    const uint32_t magnitude{negative ? 0U - static_cast<uint32_t>(value)
+                                      : static_cast<uint32_t>(value)};
+    writeInteger(output, magnitude, negative, specifier);
+}
+
+// -----------------------------------------------------------------------------
+void writeHex(const Output& output, const uint32_t value, const Specifier& specifier) noexcept
+{
+    const char letterOffset{static_cast<char>('X' == specifier.conversion ? 'A' - 10 : 'a' - 10)};
+    const uint8_t count{hexDigitCount(value)};
+    writeSign(output, false, count, specifier);
+
+    for (uint8_t i{count}; 0U < i; --i)
+    {
+        const uint8_t nibble{static_cast<uint8_t>((value >> (4U * (i - 1U))) & 0x0FU)};
+        output.put(static_cast<char>(10U > nibble ? '0' + nibble : letterOffset + nibble));
+    }
+}
+
+// -----------------------------------------------------------------------------
+void writeFixed(const Output& output, const Fixed& fixed, const Specifier& specifier) noexcept
+{
+    const bool negative{0 > fixed.value};
+    const uint32_t magnitude{negative ? 0U - static_cast<uint32_t>(fixed.value)
+                                      : static_cast<uint32_t>(fixed.value)};
+    const uint8_t decimals{min(fixed.decimals, FormatParam::MaxDecimalCount)};
+
+    // Write at least one integer digit, i.e. 0.05 rather than .05.
+    const uint8_t count{decimals < digitCount(magnitude) ? digitCount(magnitude)
+                                                          : static_cast<uint8_t>(decimals + 1U)};
+    writeSign(output, negative, count + negative + (0U < decimals), specifier);
+    writeDigits(output, magnitude, count, decimals);
+}
+
+// -----------------------------------------------------------------------------
+void writeFloating(const Output& output, double value, const Specifier& specifier) noexcept
+{
+    // Handle values that can't be represented.
+    if (value != value) 
+    { 
+        return writeString<readFlash>(output, FormatParam::NotANumber, specifier.width); 
+    }
+    const bool negative{0.0 > value};
+    if (negative) { value = -value; }
+    if (FormatParam::MaxFloating < value) 
+    { 
+        return writeString<readFlash>(output, FormatParam::Overflow, specifier.width); 
+    }
+
+    const uint8_t decimals{Specifier::NoPrecision == specifier.precision ?
+        FormatParam::DefaultDecimalCount : min(specifier.precision, FormatParam::MaxDecimalCount)};
+
+    // Split the number into an integer and a fractional part, scale the latter by multiplication.
+    uint32_t integer{static_cast<uint32_t>(value)};
+    double fraction{value - integer};
+    for (uint8_t i{}; i < decimals; ++i) { fraction *= 10.0; }
+    uint32_t scaledFraction{static_cast<uint32_t>(fraction + 0.5)};
+
+    // Carry into the integer part if the fraction was rounded up, e.g. 1.96 => 2.0.
+    if (scaledFraction >= powerOfTen(decimals))
+    {
+        scaledFraction = 0U;
+        ++integer;
+    }
+
+    writeInteger(output, integer, negative, specifier, 0U < decimals ? decimals + 1U : 0U);
+    if (0U < decimals)
+    {
+        output.put('.');
+        writeDigits(output, scaledFraction, decimals);
+    }
+}
+
+// -----------------------------------------------------------------------------
+inline uint32_t asUnsigned(const Argument& argument, const Specifier& specifier) noexcept
+{
+    // Truncate to the width given by the specifier, i.e. print -1 as ffff rather than ffffffff.
+    return specifier.isLong ? static_cast<unsigned long>(argument.asUnsigned())
+                            : static_cast<unsigned int>(argument.asUnsigned());
+}
+
+// -----------------------------------------------------------------------------
+void writeArgument(const Output& output, const Specifier& specifier,
+                   const Argument& argument) noexcept
+{
+    const auto type{argument.type()};
+
+    switch (specifier.conversion)
+    {
+        case 'd':
+        case 'i':
+            if (Type::Signed == type) { return writeSigned(output, argument.asSigned(), specifier); }
+            if (Type::Unsigned == type) { return writeInteger(output, argument.asUnsigned(), false, specifier); }
+            break;
+        case 'u':
+            if ((Type::Signed == type) || (Type::Unsigned == type))
+            {
+                return writeInteger(output, asUnsigned(argument, specifier), false, specifier);
+            }
+            break;
+        case 'x':
+        case 'X':
+            if ((Type::Signed == type) || (Type::Unsigned == type))
+            {
+                return writeHex(output, asUnsigned(argument, specifier), specifier);
+            }
+            break;
+        case 'f':
+            if (Type::Floating == type) { return writeFloating(output, argument.asFloating(), specifier); }
+            if (Type::FixedPoint == type) { return writeFixed(output, argument.asFixed(), specifier); }
+            break;
+        case 'c':
+            if (Type::Character == type) { return output.put(argument.asCharacter()); }
+            break;
+        case 's':
+            if (Type::String == type) { return writeString<readRam>(output, argument.asString(), specifier.width); }
+            break;
+        default:
+            break;
+    }
+    output.put(FormatParam::Mismatch);
+}
+
+// -----------------------------------------------------------------------------
+template <Reader read>
+void writeFormatted(const Output& output, const char* format, const Argument* args,
+                    const size_t argCount) noexcept
+{
+    size_t index{};
+    const char* it{format};
+
+    while (read(it))
+    {
+        // Write ordinary characters as they are.
+        const char character{read(it++)};
+        if ('%' != character)
+        {
+            output.put(character);
+            continue;
+        }
+
+        // Parse the specifier, stop if the format string ends in the middle of it.
+        Specifier specifier{};
+        while (read(it) && !specifier.parse(read(it++)));
+        if (Specifier::State::Done != specifier.state) { return; }
+
+        // Write the next argument (or the percent sign).
+        if ('%' == specifier.conversion) { output.put('%'); }
+        else if (index < argCount) { writeArgument(output, specifier, args[index++]); }
+        else { output.put(FormatParam::Mismatch); }
+    }
+}
+} // namespace
+
+// -----------------------------------------------------------------------------
+void vprint(const Output& output, const char* format, const Argument* args,
+            const size_t argCount) noexcept
+{
+    writeFormatted<readRam>(output, format, args, argCount);
+}
+
+// -----------------------------------------------------------------------------
+void vprint_P(const Output& output, const char* format, const Argument* args,
+              const size_t argCount) noexcept
+{
+    writeFormatted<readFlash>(output, format, args, argCount);
+}
+} // namespace format
+} // namespace utils
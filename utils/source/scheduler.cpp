@@ -0,0 +1,241 @@
+/**
+ * @brief Implementation details of the cooperative task scheduler.
+ */
+#include <avr/interrupt.h>
+#include <avr/io.h>
+#include <avr/sleep.h>
+#include <util/atomic.h>
+
+#include "utils/scheduler.h"
+#include "utils/utils.h"
+
+namespace utils
+{
+namespace
+{
+/**
+ * @brief Structure of scheduler parameters.
+ */
+struct SchedulerParam
+{
+    /** The number of microseconds per millisecond. */
+    static constexpr uint32_t MicrosPerMilli{1000U};
+};
+
+/**
+ * @brief Structure of a task entry.
+ */
+struct Entry
+{
+    /** The task function. */
+    Scheduler::Task task;
+
+    /** Context passed to the task function. */
+    void* context;
+
+    /** The activation period in microseconds, 0 if only activated by signal. */
+    uint32_t period_us;
+
+    /** Time of the next periodic activation, according to the clock. */
+    uint32_t nextActivation;
+
+    /** Runtime statistics of the task. */
+    Scheduler::Statistics statistics;
+
+    /** The task priority, higher values run first. */
+    uint8_t priority;
+
+    /** Indicate whether the task is signaled to run. */
+    volatile bool signaled;
+};
+
+/** Statically allocated task entries. */
+Entry entries[Scheduler::MaxTaskCount]{};
+
+/** The number of tasks added. */
+uint8_t taskCount{};
+
+/** Time spent asleep since the statistics were reset. */
+uint32_t idleTime{};
+
+/** Time when the statistics were reset, according to the clock. */
+uint32_t statisticsStart{};
+
+/** Clock used for periodic activation and runtime statistics. */
+Scheduler::Clock schedulerClock{nullptr};
+
+// -----------------------------------------------------------------------------
+inline bool interruptsEnabled() noexcept { return read(SREG, SREG_I); }
+
+// -----------------------------------------------------------------------------
+inline uint32_t now() noexcept { return schedulerClock ? schedulerClock() : 0U; }
+
+// -----------------------------------------------------------------------------
+constexpr bool hasExpired(const uint32_t deadline, const uint32_t now) noexcept
+{
+    // The deadline has expired if now is at or less than half the wrap around period past it.
+    return 0 <= static_cast<int32_t>(now - deadline);
+}
+
+// -----------------------------------------------------------------------------
+inline bool isActivated(const Entry& entry, const uint32_t time) noexcept
+{
+    return (0U != entry.period_us) && schedulerClock && hasExpired(entry.nextActivation, time);
+}
+
+// -----------------------------------------------------------------------------
+inline bool isReady(const Entry& entry, const uint32_t time) noexcept
+{
+    return entry.signaled || isActivated(entry, time);
+}
+
+// -----------------------------------------------------------------------------
+uint8_t nextTask(const uint32_t time) noexcept
+{
+    uint8_t next{Scheduler::InvalidTask};
+
+    for (uint8_t i{}; i < taskCount; ++i)
+    {
+        if (isReady(entries[i], time)
+            && ((Scheduler::InvalidTask == next) || (entries[next].priority < entries[i].priority)))
+        {
+            next = i;
+        }
+    }
+    return next;
+}
+
+// -----------------------------------------------------------------------------
+void schedule(Entry& entry, const uint32_t time) noexcept
+{
+    // Activations are counted from the previous one to avoid drift, but missed activations
+    // are skipped rather than run back to back.
+    entry.nextActivation += entry.period_us;
+    if (hasExpired(entry.nextActivation, time)) { entry.nextActivation = time + entry.period_us; }
+}
+
+// -----------------------------------------------------------------------------
+void updateStatistics(Scheduler::Statistics& statistics, const uint32_t runtime_us) noexcept
+{
+    statistics.runCount        = statistics.runCount + 1U;
+    statistics.totalRuntime_us = statistics.totalRuntime_us + runtime_us;
+    if (statistics.maxRuntime_us < runtime_us) { statistics.maxRuntime_us = runtime_us; }
+}
+} // namespace
+
+// -----------------------------------------------------------------------------
+uint8_t Scheduler::add(const Task task, void* context, const uint8_t priority,
+                       const uint16_t period_ms) noexcept
+{
+    if (!task || (MaxTaskCount <= taskCount)) { return InvalidTask; }
+    const uint32_t period_us{period_ms * SchedulerParam::MicrosPerMilli};
+    entries[taskCount] = Entry{task, context, period_us, now() + period_us,
+                               Statistics{0U, 0U, 0U}, priority, false};
+    return taskCount++;
+}
+
+// -----------------------------------------------------------------------------
+void Scheduler::signal(const uint8_t task) noexcept
+{
+    if (taskCount > task) { entries[task].signaled = true; }
+}
+
+// -----------------------------------------------------------------------------
+void Scheduler::setPeriod(const uint8_t task, const uint16_t period_ms) noexcept
+{
+    if (taskCount <= task) { return; }
+    entries[task].period_us      = period_ms * SchedulerParam::MicrosPerMilli;
+    entries[task].nextActivation = now() + entries[task].period_us;
+}
+
+// -----------------------------------------------------------------------------
+bool Scheduler::runNext() noexcept
+{
+    const uint32_t activationTime{now()};
+    const uint8_t task{nextTask(activationTime)};
+    if (InvalidTask == task) { return false; }
+    Entry& entry{entries[task]};
+
+    // Clear the signal before running, hence signals sent meanwhile run the task again.
+    entry.signaled = false;
+    if (isActivated(entry, activationTime)) { schedule(entry, activationTime); }
+
+    const uint32_t startTime{now()};
+    entry.task(entry.context);
+    updateStatistics(entry.statistics, now() - startTime);
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+void Scheduler::idle() noexcept
+{
+    if (!interruptsEnabled()) { return; }
+    const uint32_t startTime{now()};
+    bool slept{false};
+
+    // Interrupts are disabled while checking, and sei is used directly since the instruction
+    // following it (sleep) is executed before any pending interrupt. Hence a task made ready
+    // by an interrupt after the check still wakes the CPU.
+    set_sleep_mode(SLEEP_MODE_IDLE);
+    cli();
+
+    if (InvalidTask == nextTask(now()))
+    {
+        sleep_enable();
+        sei();
+        sleep_cpu();
+        sleep_disable();
+        slept = true;
+    }
+    sei();
+
+    // The interrupt waking the CPU is counted as idle time.
+    if (slept) { idleTime = idleTime + (now() - startTime); }
+}
+
+// -----------------------------------------------------------------------------
+void Scheduler::run() noexcept
+{
+    while (1)
+    {
+        if (!runNext()) { idle(); }
+    }
+}
+
+// -----------------------------------------------------------------------------
+bool Scheduler::statistics(const uint8_t task, Statistics& statistics) noexcept
+{
+    if (taskCount <= task) { return false; }
+    statistics = entries[task].statistics;
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+uint32_t Scheduler::idleTime_us() noexcept { return idleTime; }
+
+// -----------------------------------------------------------------------------
+uint32_t Scheduler::elapsedTime_us() noexcept
+{
+    return schedulerClock ? schedulerClock() - statisticsStart : 0U;
+}
+
+// -----------------------------------------------------------------------------
+void Scheduler::resetStatistics() noexcept
+{
+    for (uint8_t i{}; i < taskCount; ++i) { entries[i].statistics = Statistics{0U, 0U, 0U}; }
+    idleTime        = 0U;
+    statisticsStart = now();
+}
+
+// -----------------------------------------------------------------------------
+void Scheduler::setClock(const Clock clock) noexcept
+{
+    schedulerClock  = clock;
+    statisticsStart = now();
+
+    for (uint8_t i{}; i < taskCount; ++i)
+    {
+        entries[i].nextActivation = statisticsStart + entries[i].period_us;
+    }
+}
+} // namespace utils
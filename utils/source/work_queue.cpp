@@ -0,0 +1,173 @@
+/**
+ * @brief Implementation details of the deferred work queue.
+ */
+#include <util/atomic.h>
+
+#include "utils/work_queue.h"
+
+namespace utils
+{
+namespace
+{
+/**
+ * @brief Structure of work queue parameters.
+ */
+struct QueueParam
+{
+    /** Mask for wrapping indexes around the ring buffer. */
+    static constexpr uint8_t IndexMask{WorkQueue::Capacity - 1U};
+};
+
+static_assert(0U == (WorkQueue::Capacity & QueueParam::IndexMask),
+              "The work queue capacity must be a power of two!");
+
+/**
+ * @brief Structure of a pending work item.
+ */
+struct Entry
+{
+    /** The work to run. */
+    void (*work)();
+
+    /** Time when the work was posted, according to the clock. */
+    uint32_t postedAt;
+};
+
+/** Ring buffer of pending work. */
+Entry entries[WorkQueue::Capacity]{};
+
+/** Index of the oldest pending work. */
+volatile uint8_t head{};
+
+/** The number of pending work items. */
+volatile uint8_t count{};
+
+/** The largest number of pending work items. */
+volatile uint8_t maxCount{};
+
+/** The number of dropped work items. */
+volatile uint16_t dropped{};
+
+/** The worst-case latency from post to dispatch. */
+uint32_t worstLatency{};
+
+/** Clock used to timestamp posted work. */
+WorkQueue::Clock queueClock{nullptr};
+
+/** Callback notifying the main loop of posted work. */
+WorkQueue::Notifier queueNotifier{nullptr};
+
+// -----------------------------------------------------------------------------
+inline bool contains(void (*work)()) noexcept
+{
+    for (uint8_t i{}; i < count; ++i)
+    {
+        if (work == entries[(head + i) & QueueParam::IndexMask].work) { return true; }
+    }
+    return false;
+}
+} // namespace
+
+// -----------------------------------------------------------------------------
+bool WorkQueue::post(void (*work)()) noexcept
+{
+    if (!work) { return false; }
+    bool posted{true};
+
+    // Work already pending is coalesced, since it hasn't run yet.
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        if (contains(work)) { return true; }
+
+        if (Capacity <= count)
+        {
+            dropped = dropped + 1U;
+            posted  = false;
+        }
+        else
+        {
+            entries[(head + count) & QueueParam::IndexMask] =
+                Entry{work, queueClock ? queueClock() : 0U};
+            count = count + 1U;
+            if (maxCount < count) { maxCount = count; }
+        }
+    }
+    if (posted && queueNotifier) { queueNotifier(); }
+    return posted;
+}
+
+// -----------------------------------------------------------------------------
+uint8_t WorkQueue::dispatch() noexcept
+{
+    uint8_t remaining{};
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) { remaining = count; }
+
+    for (uint8_t i{}; i < remaining; ++i)
+    {
+        Entry entry{};
+        ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+        {
+            entry = entries[head];
+            head  = (head + 1U) & QueueParam::IndexMask;
+            count = count - 1U;
+        }
+
+        // The latency covers the time until the work starts, not the work itself.
+        if (queueClock)
+        {
+            const uint32_t latency{queueClock() - entry.postedAt};
+            if (worstLatency < latency) { worstLatency = latency; }
+        }
+        entry.work();
+    }
+    return remaining;
+}
+
+// -----------------------------------------------------------------------------
+bool WorkQueue::isPending(void (*work)()) noexcept
+{
+    bool pending{};
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) { pending = work && contains(work); }
+    return pending;
+}
+
+// -----------------------------------------------------------------------------
+uint8_t WorkQueue::pendingCount() noexcept { return count; }
+
+// -----------------------------------------------------------------------------
+uint16_t WorkQueue::droppedCount() noexcept
+{
+    uint16_t result{};
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) { result = dropped; }
+    return result;
+}
+
+// -----------------------------------------------------------------------------
+uint32_t WorkQueue::maxLatency() noexcept { return worstLatency; }
+
+// -----------------------------------------------------------------------------
+uint8_t WorkQueue::maxPendingCount() noexcept { return maxCount; }
+
+// -----------------------------------------------------------------------------
+void WorkQueue::resetStatistics() noexcept
+{
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        maxCount     = count;
+        dropped      = 0U;
+        worstLatency = 0U;
+    }
+}
+
+// -----------------------------------------------------------------------------
+void WorkQueue::setClock(const Clock clock) noexcept
+{
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) { queueClock = clock; }
+}
+
+// -----------------------------------------------------------------------------
+void WorkQueue::setNotifier(const Notifier notifier) noexcept
+{
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) { queueNotifier = notifier; }
+}
+} // namespace utils